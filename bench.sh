@@ -0,0 +1,2 @@
+case "$CXXFLAGS" in *-DINVENTORY_STATS*) counter=src/alloc_counter.cpp ;; esac # allocation counts for stats()
+g++ -O2 -DNDEBUG $CXXFLAGS -I include -I src -std=c++17 -pthread src/bench.cpp $counter -o bench && ./bench "$@"
\ No newline at end of file
@@ -0,0 +1,402 @@
+#ifndef INVENTORY_CACHE_H
+#define INVENTORY_CACHE_H
+
+#include "app/inventory.h"
+#include "util/Random.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+// -------------------- QueryCache --------------------
+/*
+ * QueryCache: the results of InventoryManager::query, kept between calls (least recently used
+ * entries are evicted beyond a memory budget), for callers that repeat the same few queries.
+ *
+ * The cache observes its inventory (see InventoryObserver) and invalidates precisely:
+ *  >> every cached attribute has a version, bumped when a product having the attribute is added
+ *     or removed; an entry computed under an older version is recomputed by its next query;
+ *  >> a quantity change only moves one product across the minQuantity threshold of some queries:
+ *     with patchQuantities (default), those results are patched in place (one name inserted or
+ *     removed, O(log k + k)), otherwise it bumps the versions like an add / remove.
+ *
+ * A hit costs one hash of the parameters and a few comparisons, with no allocation: query returns
+ * a reference to the cached names, valid until the next call on the cache or change of the inventory.
+ * The inventory must outlive the cache. Not thread-safe (see InventoryManager::addObserver).
+ *
+ * Example:
+ *  QueryCache cache(inventory, 1 << 20);
+ *  const List1D<string> &light = cache.query("weight", 0, 5, 1, true);
+ *  inventory.updateQuantity(3, 0); // patched
+ */
+class QueryCache : public InventoryObserver
+{
+private:
+    struct Entry
+    {
+        string attribute;
+        double minValue, maxValue;
+        int minQuantity;
+        bool ascending;
+        uint64_t hash;
+        int slot;     // of attribute, in versions
+        long version; // of the attribute when names were computed
+        List1D<string> names;
+        long bytes;
+        Entry *newer, *older; // LRU list
+        Entry *chain;         // next entry of the same bucket
+    };
+    struct AttributeVersion
+    {
+        string attribute;
+        long version;
+    };
+
+    InventoryManager &inventory;
+    long budget;
+    bool patchQuantities;
+
+    Entry **buckets;
+    int numBuckets; // power of 2
+    int count;
+    Entry *newest, *oldest;
+    long bytes;
+
+    AttributeVersion *versions;
+    int numVersions;
+
+    long hitCount, missCount, evictionCount, patchCount;
+
+public:
+    QueryCache(InventoryManager &inventory, long memoryBudget = 16L << 20, bool patchQuantities = true);
+    ~QueryCache();
+
+    /* query(...): same result as inventory.query(...), cached
+     */
+    const List1D<string> &query(const string &attributeName, double minValue, double maxValue,
+                                int minQuantity, bool ascending);
+    void clear();
+
+    int size() const { return count; }
+    long memoryUsage() const { return bytes; } // estimated bytes of the cached entries
+    long memoryBudget() const { return budget; }
+    long hits() const { return hitCount; }
+    long misses() const { return missCount; } // including recomputations of invalidated entries
+    long evictions() const { return evictionCount; }
+    long patches() const { return patchCount; }
+
+    // InventoryObserver
+    void productAdded(const InventoryManager &inventory, int index);
+    void productRemoving(const InventoryManager &inventory, int index);
+    void quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity);
+    void inventoryReplaced(const InventoryManager &inventory);
+
+private:
+    QueryCache(const QueryCache &);            // not copyable
+    QueryCache &operator=(const QueryCache &); // not copyable
+
+    static uint64_t hashOf(const string &attributeName, double minValue, double maxValue, int minQuantity,
+                           bool ascending);
+    static long bytesOf(const Entry &entry);
+    static long bytesOf(const string &text) { return text.capacity() > 15 ? (long)text.capacity() + 1 : 0; }
+    int slotOf(const string &attribute); // -1 if not cached
+    int addSlot(const string &attribute);
+    void bumpVersions(int index);
+    bool inRange(const Entry &entry, int index) const;
+    void patch(Entry &entry, const string &name, bool insert);
+
+    void compute(Entry &entry);
+    void touch(Entry *entry);  // make it the newest
+    void unlink(Entry *entry); // from the LRU list and its bucket
+    void evict();
+    void grow();
+};
+
+// -------------------- QueryCache Method Definitions --------------------
+QueryCache::QueryCache(InventoryManager &inventory, long memoryBudget, bool patchQuantities)
+    : inventory(inventory), budget(memoryBudget), patchQuantities(patchQuantities), numBuckets(64), count(0),
+      newest(nullptr), oldest(nullptr), bytes(0), versions(nullptr), numVersions(0), hitCount(0), missCount(0),
+      evictionCount(0), patchCount(0)
+{
+    buckets = new Entry *[numBuckets]();
+    inventory.addObserver(this);
+}
+
+QueryCache::~QueryCache()
+{
+    inventory.removeObserver(this);
+    clear();
+    delete[] buckets;
+    delete[] versions;
+}
+
+const List1D<string> &QueryCache::query(const string &attributeName, double minValue, double maxValue,
+                                        int minQuantity, bool ascending)
+{
+    uint64_t hash = hashOf(attributeName, minValue, maxValue, minQuantity, ascending);
+    for (Entry *entry = buckets[hash & (numBuckets - 1)]; entry != nullptr; entry = entry->chain)
+    {
+        if (entry->hash == hash && entry->minValue == minValue && entry->maxValue == maxValue &&
+            entry->minQuantity == minQuantity && entry->ascending == ascending && entry->attribute == attributeName)
+        {
+            if (entry->version == versions[entry->slot].version)
+                hitCount++;
+            else
+            {
+                missCount++;
+                compute(*entry);
+            }
+            touch(entry);
+            return entry->names;
+        }
+    }
+
+    missCount++;
+    Entry *entry = new Entry();
+    entry->attribute = attributeName;
+    entry->minValue = minValue;
+    entry->maxValue = maxValue;
+    entry->minQuantity = minQuantity;
+    entry->ascending = ascending;
+    entry->hash = hash;
+    entry->slot = slotOf(attributeName);
+    if (entry->slot < 0)
+        entry->slot = addSlot(attributeName);
+    entry->bytes = 0;
+    entry->newer = entry->older = nullptr;
+    compute(*entry);
+    if (count >= numBuckets)
+        grow();
+    Entry *&bucket = buckets[hash & (numBuckets - 1)];
+    entry->chain = bucket;
+    bucket = entry;
+    count++;
+    touch(entry);
+    evict();
+    return entry->names;
+}
+
+void QueryCache::clear()
+{
+    while (oldest != nullptr)
+    {
+        Entry *entry = oldest;
+        unlink(entry);
+        delete entry;
+    }
+}
+
+void QueryCache::productAdded(const InventoryManager &inventory, int index)
+{
+    bumpVersions(index);
+}
+
+void QueryCache::productRemoving(const InventoryManager &inventory, int index)
+{
+    bumpVersions(index);
+}
+
+void QueryCache::quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity)
+{
+    if (!patchQuantities)
+    {
+        bumpVersions(index);
+        return;
+    }
+    string name;
+    for (Entry *entry = newest; entry != nullptr; entry = entry->older)
+    {
+        bool before = oldQuantity >= entry->minQuantity, after = newQuantity >= entry->minQuantity;
+        if (before == after || entry->version != versions[entry->slot].version || !inRange(*entry, index))
+            continue;
+        if (name.empty())
+            name = inventory.getProductName(index);
+        patch(*entry, name, after);
+    }
+}
+
+void QueryCache::inventoryReplaced(const InventoryManager &inventory)
+{
+    clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+uint64_t QueryCache::hashOf(const string &attributeName, double minValue, double maxValue, int minQuantity,
+                            bool ascending)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a of the name, then mixed with the other parameters
+    for (size_t i = 0; i < attributeName.size(); i++)
+        hash = (hash ^ (unsigned char)attributeName[i]) * 0x100000001b3ULL;
+    uint64_t bits;
+    memcpy(&bits, &minValue, sizeof(bits));
+    hash = SplitMix64::mix(hash ^ bits);
+    memcpy(&bits, &maxValue, sizeof(bits));
+    hash = SplitMix64::mix(hash ^ bits);
+    return SplitMix64::mix(hash ^ ((uint64_t)(uint32_t)minQuantity << 1) ^ (uint64_t)ascending);
+}
+
+long QueryCache::bytesOf(const Entry &entry)
+{
+    // the entry, its strings' buffers beyond the small-string optimization, the names' array
+    long size = sizeof(Entry) + (long)entry.names.size() * sizeof(string) + bytesOf(entry.attribute);
+    for (List1D<string>::ConstIterator it = entry.names.begin(); it != entry.names.end(); ++it)
+        size += bytesOf(*it);
+    return size;
+}
+
+int QueryCache::slotOf(const string &attribute)
+{
+    for (int i = 0; i < numVersions; i++)
+        if (versions[i].attribute == attribute)
+            return i;
+    return -1;
+}
+
+int QueryCache::addSlot(const string &attribute)
+{
+    AttributeVersion *grown = new AttributeVersion[numVersions + 1];
+    for (int i = 0; i < numVersions; i++)
+        grown[i] = versions[i];
+    grown[numVersions].attribute = attribute;
+    grown[numVersions].version = 0;
+    delete[] versions;
+    versions = grown;
+    return numVersions++;
+}
+
+void QueryCache::bumpVersions(int index)
+{
+    // the attributes of product "index" (attributes never queried have no version)
+    int columns = inventory.attributeCount(index);
+    for (int j = 0; j < columns; j++)
+    {
+        int slot = slotOf(inventory.attributeAt(index, j).name);
+        if (slot >= 0)
+            versions[slot].version++;
+    }
+}
+
+bool QueryCache::inRange(const Entry &entry, int index) const
+{
+    int columns = inventory.attributeCount(index);
+    for (int j = 0; j < columns; j++)
+    {
+        const InventoryAttribute &attribute = inventory.attributeAt(index, j);
+        if (attribute.name == entry.attribute && attribute.value >= entry.minValue && attribute.value <= entry.maxValue)
+            return true;
+    }
+    return false;
+}
+
+void QueryCache::patch(Entry &entry, const string &name, bool insert)
+{
+    // names are sorted (descending when !ascending): binary search for name's place
+    List1D<string>::Iterator begin = entry.names.begin(), end = entry.names.end();
+    List1D<string>::Iterator position = entry.ascending
+                                            ? lower_bound(begin, end, name)
+                                            : lower_bound(begin, end, name, [](const string &lhs, const string &rhs)
+                                                          { return lhs > rhs; });
+    int offset = (int)(position - begin);
+    long delta = (long)sizeof(string) + bytesOf(name);
+    if (insert)
+    {
+        entry.names.add(name);
+        rotate(entry.names.begin() + offset, entry.names.end() - 1, entry.names.end());
+    }
+    else if (position != end && *position == name)
+    {
+        entry.names.remove(offset);
+        delta = -delta;
+    }
+    else
+        return;
+    entry.bytes += delta;
+    bytes += delta;
+    patchCount++;
+}
+
+void QueryCache::compute(Entry &entry)
+{
+    bytes -= entry.bytes;
+    entry.names = inventory.query(entry.attribute, entry.minValue, entry.maxValue, entry.minQuantity, entry.ascending);
+    entry.version = versions[entry.slot].version;
+    entry.bytes = bytesOf(entry);
+    bytes += entry.bytes;
+}
+
+void QueryCache::touch(Entry *entry)
+{
+    if (entry == newest)
+        return;
+    // out of the LRU list (if in it) ...
+    if (entry->newer != nullptr)
+        entry->newer->older = entry->older;
+    if (entry->older != nullptr)
+        entry->older->newer = entry->newer;
+    if (entry == oldest)
+        oldest = entry->newer;
+    // ... and back in, at the front
+    entry->newer = nullptr;
+    entry->older = newest;
+    if (newest != nullptr)
+        newest->newer = entry;
+    newest = entry;
+    if (oldest == nullptr)
+        oldest = entry;
+}
+
+void QueryCache::unlink(Entry *entry)
+{
+    if (entry->newer != nullptr)
+        entry->newer->older = entry->older;
+    else
+        newest = entry->older;
+    if (entry->older != nullptr)
+        entry->older->newer = entry->newer;
+    else
+        oldest = entry->newer;
+    Entry **link = &buckets[entry->hash & (numBuckets - 1)];
+    while (*link != entry)
+        link = &(*link)->chain;
+    *link = entry->chain;
+    bytes -= entry->bytes;
+    count--;
+}
+
+void QueryCache::evict()
+{
+    // the newest entry stays, even alone over the budget: its names are being returned
+    while (bytes > budget && oldest != newest)
+    {
+        Entry *entry = oldest;
+        unlink(entry);
+        delete entry;
+        evictionCount++;
+    }
+}
+
+void QueryCache::grow()
+{
+    int grown = numBuckets * 2;
+    Entry **rehashed = new Entry *[grown]();
+    for (int b = 0; b < numBuckets; b++)
+    {
+        Entry *entry = buckets[b];
+        while (entry != nullptr)
+        {
+            Entry *next = entry->chain;
+            Entry *&bucket = rehashed[entry->hash & (grown - 1)];
+            entry->chain = bucket;
+            bucket = entry;
+            entry = next;
+        }
+    }
+    delete[] buckets;
+    buckets = rehashed;
+    numBuckets = grown;
+}
+
+#endif /* INVENTORY_CACHE_H */
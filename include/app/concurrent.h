@@ -0,0 +1,318 @@
+#ifndef CONCURRENT_INVENTORY_H
+#define CONCURRENT_INVENTORY_H
+
+#include "app/inventory.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace std;
+
+// -------------------- ConcurrentInventory --------------------
+/*
+ * ConcurrentInventory: an InventoryManager shared by many reader threads and some writer threads.
+ *
+ * Readers work on a version of the inventory (a snapshot): they never wait for writers, and every
+ * call on one snapshot sees the same products. Writers are serialized; each write copies the current
+ * version, changes the copy and publishes it as the new version (copy-on-write). Versions are
+ * reference counted, so an old version is freed when its last reader drops it.
+ *
+ * A write costs a copy of the whole inventory: group mutations with update() when there are many.
+ * Stock changes made with adjustQuantity / tryReserve are the exception: they are lock-free atomic
+ * updates applied in place to the current version (readers of that version see them), and run in
+ * parallel with each other; they only wait while a copy-on-write writer is copying.
+ *
+ * Example:
+ *  ConcurrentInventory shared(inventory);
+ *  // reader threads
+ *  int quantity = shared.getProductQuantity(3);
+ *  shared_ptr<const InventoryManager> snap = shared.snapshot(); // several consistent reads
+ *  // writer threads
+ *  shared.update([](InventoryManager &inv) { inv.updateQuantity(0, 5); inv.removeProduct(2); });
+ */
+class ConcurrentInventory
+{
+private:
+    shared_ptr<InventoryManager> current; // read/written with atomic_load/atomic_store only
+    shared_mutex writeLock;               // exclusive: copy-on-write writers; shared: in-place stock changes
+    atomic<long> currentVersion;
+    InventoryJournal *journal;
+
+    /*
+     * JournalBuffer: holds the journal calls of one update() until its mutation has returned,
+     * so a mutation that throws leaves no record in the journal.
+     */
+    class JournalBuffer : public InventoryJournal
+    {
+    private:
+        enum RecordType
+        {
+            ADD,
+            REMOVE,
+            UPDATE
+        };
+        XArrayList<int> records; // per record: type, then index and/or quantity (ADD: quantity, attribute count)
+        XArrayList<InventoryAttribute> addedAttributes; // of all ADD records, back to back
+        XArrayList<string> addedNames;
+        bool wasReplaced; // operator= was called: the final state replaces every record
+
+    public:
+        JournalBuffer() : wasReplaced(false) {}
+        void logAdd(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+        void logRemove(int index);
+        void logUpdate(int index, int newQuantity);
+        void replaced(const InventoryManager &inventory) { wasReplaced = true; }
+        // forward(journal, inventory): replay the calls, in order, into "journal", as one batch
+        void forward(InventoryJournal *journal, const InventoryManager &inventory);
+    };
+
+public:
+    ConcurrentInventory();
+    ConcurrentInventory(const InventoryManager &inventory);
+
+    /* snapshot(): the current version; its products never change (later writes publish new versions),
+     *   only its quantities may, through adjustQuantity / tryReserve
+     */
+    shared_ptr<const InventoryManager> snapshot() const;
+    long version() const;
+
+    // reads: each one runs on the current snapshot
+    int size() const;
+    string getProductName(int index) const;
+    int getProductQuantity(int index) const;
+    List1D<InventoryAttribute> getProductAttributes(int index) const;
+    List1D<string> query(string attributeName, const double &minValue,
+                         const double &maxValue, int minQuantity, bool ascending) const;
+
+    // writes: each one publishes a new version
+    void updateQuantity(int index, int newQuantity);
+    void addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    void removeProduct(int index);
+    void removeDuplicates();
+
+    // in-place atomic stock changes (see InventoryManager::adjustQuantity / tryReserve)
+    int adjustQuantity(int index, int delta);
+    bool tryReserve(int index, int n);
+
+    /* update(mutation): apply mutation(InventoryManager&) to a private copy of the current version,
+     *   then publish it; readers see all of the changes or none of them.
+     *   If mutation throws, nothing is published.
+     */
+    template <class Mutation>
+    void update(Mutation mutation);
+
+    /* setJournal(journal): every published change is first reported to "journal" (see InventoryJournal)
+     *   >> the changes of one update() are reported after its mutation returns, before they are
+     *      published, as one batch (see InventoryJournal::beginBatch); a mutation that throws
+     *      reports nothing, and a journal that throws aborts the batch and nothing is published
+     */
+    void setJournal(InventoryJournal *journal);
+};
+
+// -------------------- ConcurrentInventory Method Definitions --------------------
+ConcurrentInventory::ConcurrentInventory()
+    : current(make_shared<InventoryManager>()), currentVersion(0), journal(nullptr) {}
+
+ConcurrentInventory::ConcurrentInventory(const InventoryManager &inventory)
+    : current(make_shared<InventoryManager>(inventory)), currentVersion(0), journal(nullptr) {}
+
+shared_ptr<const InventoryManager> ConcurrentInventory::snapshot() const
+{
+    return atomic_load(&current);
+}
+
+long ConcurrentInventory::version() const
+{
+    return currentVersion.load(memory_order_acquire);
+}
+
+int ConcurrentInventory::size() const
+{
+    return snapshot()->size();
+}
+
+string ConcurrentInventory::getProductName(int index) const
+{
+    return snapshot()->getProductName(index);
+}
+
+int ConcurrentInventory::getProductQuantity(int index) const
+{
+    return snapshot()->getProductQuantity(index);
+}
+
+List1D<InventoryAttribute> ConcurrentInventory::getProductAttributes(int index) const
+{
+    return snapshot()->getProductAttributes(index);
+}
+
+List1D<string> ConcurrentInventory::query(string attributeName, const double &minValue,
+                                          const double &maxValue, int minQuantity, bool ascending) const
+{
+    return snapshot()->query(attributeName, minValue, maxValue, minQuantity, ascending);
+}
+
+void ConcurrentInventory::updateQuantity(int index, int newQuantity)
+{
+    update([&](InventoryManager &inventory)
+           { inventory.updateQuantity(index, newQuantity); });
+}
+
+void ConcurrentInventory::addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    update([&](InventoryManager &inventory)
+           { inventory.addProduct(attributes, name, quantity); });
+}
+
+void ConcurrentInventory::removeProduct(int index)
+{
+    update([&](InventoryManager &inventory)
+           { inventory.removeProduct(index); });
+}
+
+void ConcurrentInventory::removeDuplicates()
+{
+    update([](InventoryManager &inventory)
+           { inventory.removeDuplicates(); });
+}
+
+int ConcurrentInventory::adjustQuantity(int index, int delta)
+{
+    shared_lock<shared_mutex> guard(writeLock);
+    if (journal != nullptr)
+    {
+        // journals are not thread-safe: fall back to one writer at a time
+        guard.unlock();
+        int newQuantity = 0;
+        update([&](InventoryManager &inventory)
+               { newQuantity = inventory.adjustQuantity(index, delta); });
+        return newQuantity;
+    }
+    return atomic_load(&current)->adjustQuantity(index, delta);
+}
+
+bool ConcurrentInventory::tryReserve(int index, int n)
+{
+    shared_lock<shared_mutex> guard(writeLock);
+    if (journal != nullptr)
+    {
+        guard.unlock();
+        bool reserved = false;
+        update([&](InventoryManager &inventory)
+               { reserved = inventory.tryReserve(index, n); });
+        return reserved;
+    }
+    return atomic_load(&current)->tryReserve(index, n);
+}
+
+template <class Mutation>
+void ConcurrentInventory::update(Mutation mutation)
+{
+    unique_lock<shared_mutex> guard(writeLock);
+    shared_ptr<InventoryManager> next = make_shared<InventoryManager>(*atomic_load(&current));
+    if (journal == nullptr)
+    {
+        mutation(*next);
+    }
+    else
+    {
+        JournalBuffer buffer;
+        next->setJournal(&buffer);
+        try
+        {
+            mutation(*next);
+        }
+        catch (...)
+        {
+            next->setJournal(nullptr);
+            throw;
+        }
+        next->setJournal(nullptr);
+        buffer.forward(journal, *next); // if the journal fails, the batch is aborted and nothing is published
+    }
+    atomic_store(&current, next);
+    currentVersion.fetch_add(1, memory_order_release);
+}
+
+void ConcurrentInventory::setJournal(InventoryJournal *journal)
+{
+    unique_lock<shared_mutex> guard(writeLock);
+    this->journal = journal;
+}
+
+////// (private) METHOD DEFNITION //////
+void ConcurrentInventory::JournalBuffer::logAdd(const List1D<InventoryAttribute> &attributes,
+                                                const string &name, int quantity)
+{
+    records.add(ADD);
+    records.add(quantity);
+    records.add(attributes.size());
+    for (int i = 0; i < attributes.size(); i++)
+        addedAttributes.add(attributes.get(i));
+    addedNames.add(name);
+}
+
+void ConcurrentInventory::JournalBuffer::logRemove(int index)
+{
+    records.add(REMOVE);
+    records.add(index);
+}
+
+void ConcurrentInventory::JournalBuffer::logUpdate(int index, int newQuantity)
+{
+    records.add(UPDATE);
+    records.add(index);
+    records.add(newQuantity);
+}
+
+void ConcurrentInventory::JournalBuffer::forward(InventoryJournal *journal, const InventoryManager &inventory)
+{
+    if (wasReplaced)
+    {
+        // a checkpoint of the published state covers the records before and after the assignment
+        journal->replaced(inventory);
+        return;
+    }
+    if (records.size() == 0)
+        return;
+    journal->beginBatch();
+    try
+    {
+        int added = 0, attributeStart = 0;
+        for (int i = 0; i < records.size();)
+        {
+            switch (records.get(i))
+            {
+            case ADD:
+            {
+                List1D<InventoryAttribute> attributes;
+                for (int k = 0; k < records.get(i + 2); k++)
+                    attributes.add(addedAttributes.get(attributeStart + k));
+                journal->logAdd(attributes, addedNames.get(added), records.get(i + 1));
+                attributeStart += attributes.size();
+                added++;
+                i += 3;
+                break;
+            }
+            case REMOVE:
+                journal->logRemove(records.get(i + 1));
+                i += 2;
+                break;
+            default:
+                journal->logUpdate(records.get(i + 1), records.get(i + 2));
+                i += 3;
+                break;
+            }
+        }
+        journal->commitBatch();
+    }
+    catch (...)
+    {
+        journal->abortBatch();
+        throw;
+    }
+    journal->applied(inventory);
+}
+
+#endif /* CONCURRENT_INVENTORY_H */
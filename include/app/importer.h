@@ -0,0 +1,427 @@
+#ifndef INVENTORY_IMPORTER_H
+#define INVENTORY_IMPORTER_H
+
+#include "app/inventory.h"
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+
+// -------------------- InventoryImporter --------------------
+/*
+ * InventoryImporter: streams a CSV/TSV catalog into an InventoryManager.
+ *
+ *  >> the first record is the header; it names the columns.
+ *  >> one column holds the product name, one the quantity (see setNameColumn / setQuantityColumn),
+ *     every other column becomes an InventoryAttribute (its name is the header, or the name given
+ *     to mapColumn). Empty cells are skipped, so products may have different attribute sets.
+ *  >> fields may be quoted ("a, b" or "say ""hi"""), records may end with \n or \r\n.
+ *
+ * The file is read in chunks of bufferSize bytes into one fixed buffer, and parsed rows are
+ * appended to the inventory in batches of batchSize rows, so the importer's own memory does not
+ * depend on the size of the file. A single record must fit in the buffer.
+ *
+ * Example:
+ *  InventoryImporter importer(',');
+ *  importer.mapColumn("w_kg", "weight");
+ *  importer.importFile("catalog.csv", inventory);
+ */
+class InventoryImporter
+{
+private:
+    struct Field
+    {
+        char *begin;
+        int length;
+    };
+
+    char delimiter;
+    int batchSize;
+    int bufferSize;
+    string nameColumn;
+    string quantityColumn;
+    XArrayList<string> mappedFrom; // mapColumn: header name ...
+    XArrayList<string> mappedTo;   // ... and the attribute name it is imported as
+    XArrayList<string> ignored;
+
+    // per-file state
+    XArrayList<string> attributeNames; // attribute name per column ("" if the column is not an attribute)
+    int nameIndex;
+    int quantityIndex;
+    Field *fields;
+    int fieldCapacity;
+    long line;
+    long rows;
+    long bytes;
+
+    // batch
+    List1D<InventoryAttribute> *batchAttributes;
+    string *batchNames;
+    int *batchQuantities;
+    int batchCount;
+
+public:
+    InventoryImporter(char delimiter = ',', int batchSize = 1024, int bufferSize = 1 << 20);
+    ~InventoryImporter();
+
+    void setNameColumn(const string &column) { nameColumn = column; }
+    void setQuantityColumn(const string &column) { quantityColumn = column; }
+    void mapColumn(const string &column, const string &attributeName);
+    void ignoreColumn(const string &column);
+
+    /* importFile(path, inventory): append every record of the file to "inventory"
+     *
+     * return:
+     *  >> the number of products imported
+     *  >> throw std::runtime_error if the file cannot be read or a record does not fit the buffer,
+     *     std::invalid_argument if the header or a numeric cell is malformed (with the line number)
+     */
+    long importFile(const string &path, InventoryManager &inventory);
+
+    long rowsImported() const { return rows; }
+    long bytesRead() const { return bytes; }
+
+    /* parseDouble, parseInt: locale-independent number parsing (std::from_chars),
+     * surrounding blanks are ignored; return false if the text is not a number.
+     */
+    static bool parseDouble(const char *begin, const char *end, double &value);
+    static bool parseInt(const char *begin, const char *end, int &value);
+
+private:
+    char *findRecordEnd(char *p, char *end) const;
+    int splitRecord(char *p, char *end);
+    void readHeader(int numFields);
+    void addRecord(int numFields);
+    void flushBatch(InventoryManager &inventory);
+    string error(const string &message) const;
+};
+
+// -------------------- InventoryImporter Method Definitions --------------------
+InventoryImporter::InventoryImporter(char delimiter, int batchSize, int bufferSize)
+    : delimiter(delimiter), batchSize(batchSize), bufferSize(bufferSize),
+      nameColumn("name"), quantityColumn("quantity"),
+      nameIndex(-1), quantityIndex(-1), line(0), rows(0), bytes(0), batchCount(0)
+{
+    if (batchSize <= 0 || bufferSize <= 0)
+        throw invalid_argument("batchSize and bufferSize must be positive");
+    fieldCapacity = 16;
+    fields = new Field[fieldCapacity];
+    batchAttributes = new List1D<InventoryAttribute>[batchSize];
+    batchNames = new string[batchSize];
+    batchQuantities = new int[batchSize];
+}
+
+InventoryImporter::~InventoryImporter()
+{
+    delete[] fields;
+    delete[] batchAttributes;
+    delete[] batchNames;
+    delete[] batchQuantities;
+}
+
+void InventoryImporter::mapColumn(const string &column, const string &attributeName)
+{
+    int idx = mappedFrom.indexOf(column);
+    if (idx != -1)
+    {
+        mappedTo.get(idx) = attributeName;
+        return;
+    }
+    mappedFrom.add(column);
+    mappedTo.add(attributeName);
+}
+
+void InventoryImporter::ignoreColumn(const string &column)
+{
+    if (!ignored.contains(column))
+        ignored.add(column);
+}
+
+long InventoryImporter::importFile(const string &path, InventoryManager &inventory)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        throw runtime_error("Cannot open " + path);
+
+    char *buffer = new char[bufferSize];
+    int filled = 0;
+    bool eof = false;
+    bool header = true;
+    line = 0;
+    rows = 0;
+    bytes = 0;
+    batchCount = 0;
+
+    try
+    {
+        while (!eof || filled > 0)
+        {
+            if (!eof)
+            {
+                size_t n = fread(buffer + filled, 1, bufferSize - filled, file);
+                if (n == 0)
+                {
+                    if (ferror(file))
+                        throw runtime_error("Cannot read " + path);
+                    eof = true;
+                }
+                filled += (int)n;
+                bytes += (long)n;
+            }
+
+            // parse every complete record in the buffer
+            char *p = buffer;
+            char *end = buffer + filled;
+            while (p < end)
+            {
+                char *recordEnd = findRecordEnd(p, end);
+                if (recordEnd == nullptr)
+                {
+                    if (!eof)
+                        break; // the record continues in the next chunk
+                    recordEnd = end;
+                }
+                line++;
+                char *next = recordEnd < end ? recordEnd + 1 : end;
+                char *stop = recordEnd;
+                if (stop > p && stop[-1] == '\r')
+                    stop--;
+                if (stop > p) // blank lines are skipped
+                {
+                    int numFields = splitRecord(p, stop);
+                    if (header)
+                    {
+                        readHeader(numFields);
+                        header = false;
+                    }
+                    else
+                    {
+                        addRecord(numFields);
+                        if (batchCount == batchSize)
+                            flushBatch(inventory);
+                    }
+                }
+                p = next;
+            }
+
+            // keep the unfinished record for the next chunk
+            int remaining = (int)(end - p);
+            if (remaining == bufferSize)
+                throw runtime_error(error("record does not fit in the read buffer"));
+            memmove(buffer, p, remaining);
+            filled = remaining;
+        }
+        flushBatch(inventory);
+    }
+    catch (...)
+    {
+        delete[] buffer;
+        fclose(file);
+        throw;
+    }
+    delete[] buffer;
+    fclose(file);
+    return rows;
+}
+
+bool InventoryImporter::parseDouble(const char *begin, const char *end, double &value)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+        end--;
+    if (begin < end && *begin == '+')
+        begin++;
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return begin < end && result.ec == std::errc() && result.ptr == end;
+}
+
+bool InventoryImporter::parseInt(const char *begin, const char *end, int &value)
+{
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+        end--;
+    if (begin < end && *begin == '+')
+        begin++;
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return begin < end && result.ec == std::errc() && result.ptr == end;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+char *InventoryImporter::findRecordEnd(char *p, char *end) const
+{
+    /*
+     * Returns the position of the '\n' that terminates the record starting at p,
+     * or nullptr if the buffer ends first. Newlines inside quoted fields do not count.
+     */
+    bool quoted = false;
+    while (p < end)
+    {
+        if (quoted)
+        {
+            char *quote = (char *)memchr(p, '"', end - p);
+            if (quote == nullptr)
+                return nullptr;
+            quoted = false; // "" inside a quoted field closes and reopens it
+            p = quote + 1;
+            continue;
+        }
+        char *nl = (char *)memchr(p, '\n', end - p);
+        char *quote = (char *)memchr(p, '"', (nl == nullptr ? end : nl) - p);
+        if (quote == nullptr)
+            return nl;
+        quoted = true;
+        p = quote + 1;
+    }
+    return nullptr;
+}
+
+int InventoryImporter::splitRecord(char *p, char *end)
+{
+    /*
+     * Splits the record [p, end) into fields. Quoted fields are unescaped in place
+     * (the result is never longer than the raw text), so no field is copied.
+     */
+    int n = 0;
+    while (true)
+    {
+        if (n == fieldCapacity)
+        {
+            Field *larger = new Field[fieldCapacity * 2];
+            memcpy(larger, fields, fieldCapacity * sizeof(Field));
+            delete[] fields;
+            fields = larger;
+            fieldCapacity *= 2;
+        }
+
+        char *start = p;
+        if (p < end && *p == '"')
+        {
+            char *out = p;
+            p++;
+            while (true)
+            {
+                if (p >= end)
+                    throw invalid_argument(error("unterminated quoted field"));
+                if (*p == '"')
+                {
+                    if (p + 1 < end && p[1] == '"')
+                    {
+                        *out++ = '"';
+                        p += 2;
+                        continue;
+                    }
+                    p++;
+                    break;
+                }
+                *out++ = *p++;
+            }
+            if (p < end && *p != delimiter)
+                throw invalid_argument(error("unexpected character after quoted field"));
+            fields[n].begin = start;
+            fields[n].length = (int)(out - start);
+        }
+        else
+        {
+            char *stop = (char *)memchr(p, delimiter, end - p);
+            p = (stop == nullptr) ? end : stop;
+            fields[n].begin = start;
+            fields[n].length = (int)(p - start);
+        }
+        n++;
+
+        if (p >= end)
+            return n;
+        p++; // skip delimiter
+    }
+}
+
+void InventoryImporter::readHeader(int numFields)
+{
+    attributeNames.clear();
+    nameIndex = -1;
+    quantityIndex = -1;
+    for (int i = 0; i < numFields; i++)
+    {
+        string column(fields[i].begin, fields[i].length);
+        if (column == nameColumn)
+        {
+            nameIndex = i;
+            attributeNames.add("");
+        }
+        else if (column == quantityColumn)
+        {
+            quantityIndex = i;
+            attributeNames.add("");
+        }
+        else if (ignored.contains(column))
+        {
+            attributeNames.add("");
+        }
+        else
+        {
+            int idx = mappedFrom.indexOf(column);
+            attributeNames.add(idx == -1 ? column : mappedTo.get(idx));
+        }
+    }
+    if (nameIndex == -1)
+        throw invalid_argument(error("missing name column \"" + nameColumn + "\""));
+    if (quantityIndex == -1)
+        throw invalid_argument(error("missing quantity column \"" + quantityColumn + "\""));
+}
+
+void InventoryImporter::addRecord(int numFields)
+{
+    if (numFields != attributeNames.size())
+        throw invalid_argument(error("expected " + to_string(attributeNames.size()) +
+                                     " fields, found " + to_string(numFields)));
+
+    List1D<InventoryAttribute> &attributes = batchAttributes[batchCount];
+    attributes.clear();
+    for (int i = 0; i < numFields; i++)
+    {
+        Field &field = fields[i];
+        const char *end = field.begin + field.length;
+        if (i == nameIndex)
+        {
+            batchNames[batchCount].assign(field.begin, field.length);
+        }
+        else if (i == quantityIndex)
+        {
+            if (!parseInt(field.begin, end, batchQuantities[batchCount]))
+                throw invalid_argument(error("invalid quantity \"" + string(field.begin, field.length) + "\""));
+        }
+        else if (field.length > 0 && !attributeNames.get(i).empty())
+        {
+            double value;
+            if (!parseDouble(field.begin, end, value))
+                throw invalid_argument(error("invalid value \"" + string(field.begin, field.length) +
+                                             "\" for " + attributeNames.get(i)));
+            attributes.add(InventoryAttribute(attributeNames.get(i), value));
+        }
+    }
+    batchCount++;
+}
+
+void InventoryImporter::flushBatch(InventoryManager &inventory)
+{
+    for (int i = 0; i < batchCount; i++)
+    {
+        inventory.addProduct(batchAttributes[i], batchNames[i], batchQuantities[i]);
+    }
+    rows += batchCount;
+    batchCount = 0;
+}
+
+string InventoryImporter::error(const string &message) const
+{
+    return "line " + to_string(line) + ": " + message;
+}
+
+#endif /* INVENTORY_IMPORTER_H */
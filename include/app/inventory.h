@@ -3,11 +3,20 @@
 
 #include "list/XArrayList.h"
 #include "list/DLinkedList.h"
+#include "list/SmallArrayList.h"
+#include "util/Writer.h"
+#include "util/RoaringBitmap.h"
+#include "util/Parallel.h"
+#include "app/quantities.h"
+#include "app/stats.h"
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
+#include <limits>
+#include <thread>
 
 using namespace std;
 
@@ -16,13 +25,17 @@ template <typename T>
 class List1D
 {
 private:
-    IList<T> *pList;
+    mutable XArrayList<T> list; // mutable: XArrayList's accessors are not const
 
 public:
+    typedef typename XArrayList<T>::Iterator Iterator;
+    typedef typename XArrayList<T>::ConstIterator ConstIterator;
+
     List1D();
     List1D(int num_elements);
     List1D(const T *array, int num_elements);
     List1D(const List1D<T> &other);
+    List1D<T> &operator=(const List1D<T> &other);
     virtual ~List1D();
 
     int size() const;
@@ -30,8 +43,23 @@ public:
     void set(int index, T value);
     void add(const T &value);
     void remove(int index);
+    // removeMarked(marked): remove every index i with marked[i] (size() flags), in one pass
+    void removeMarked(const bool *marked);
+    void clear();
+    // first index of "value" (or -1), and its number of occurrences (see XArrayList::indexOf)
+    int indexOf(const T &value) const;
+    int countOf(const T &value) const;
     string
     toString() const;
+    void writeTo(Writer &writer) const;
+
+    // random-access iterators over the elements (see XArrayList::Iterator)
+    Iterator begin() { return list.begin(); }
+    Iterator end() { return list.end(); }
+    ConstIterator begin() const { return list.cbegin(); }
+    ConstIterator end() const { return list.cend(); }
+    ConstIterator cbegin() const { return list.cbegin(); }
+    ConstIterator cend() const { return list.cend(); }
 
     friend ostream &operator<<(ostream &os, const List1D<T> &list)
     {
@@ -50,24 +78,40 @@ public:
 };
 
 // -------------------- List2D --------------------
+/*
+ * List2D: rows of different lengths. Each row is a SmallArrayList holding up to ROW_INLINE items
+ * inside the row object (most products have 1 to 4 attributes): a row costs one allocation, and a
+ * second one only when it is longer.
+ */
 template <typename T>
 class List2D
 {
+public:
+    static const int ROW_INLINE = 4;
+    typedef SmallArrayList<T, ROW_INLINE> Row;
+
 private:
-    IList<IList<T> *> *pMatrix;
+    XArrayList<Row *> *pMatrix;
+    static Row *newRow(const List1D<T> &row);
 
 public:
     List2D();
     List2D(List1D<T> *array, int num_rows);
     List2D(const List2D<T> &other);
+    List2D<T> &operator=(const List2D<T> &other);
     virtual ~List2D();
 
     int rows() const;
     void setRow(int rowIndex, const List1D<T> &row);
     T get(int rowIndex, int colIndex) const;
+    // cols, at: size of a row, and an element by reference (no row or element copy)
+    int cols(int rowIndex) const;
+    const T &at(int rowIndex, int colIndex) const;
     List1D<T> getRow(int rowIndex) const;
     string toString() const;
+    void writeTo(Writer &writer) const;
     void removeRow(int index);
+    void removeMarkedRows(const bool *marked); // every row i with marked[i] (rows() flags), in one pass
     void addRow(const List1D<T> &row);
 
     friend ostream &
@@ -93,18 +137,130 @@ struct InventoryAttribute
 
 string InventoryAttribute::toString() const
 {
-    stringstream ss;
-    ss << name << ": " << value;
-    return ss.str();
+    StringWriter writer(name.size() + 16);
+    writer.write(name);
+    writer.write(": ", 2);
+    writer.writeDouble(value);
+    return writer.str();
 }
 
+// same text as operator<< (fixed, 6 decimals); used by List1D/List2D::writeTo
+inline void writeItem(Writer &writer, const InventoryAttribute &attr)
+{
+    writer.write(attr.name);
+    writer.write(": ", 2);
+    writer.writeFixed(attr.value, 6);
+}
+
+class InventoryManager;
+
+// -------------------- Aggregation --------------------
+/*
+ * Operations of InventoryManager::aggregate; combine them with |, e.g. SUM | MAX.
+ */
+enum AggregateOperation
+{
+    AGGREGATE_COUNT = 1,
+    AGGREGATE_SUM = 2,
+    AGGREGATE_MIN = 4,
+    AGGREGATE_MAX = 8,
+    AGGREGATE_AVG = 16,
+    AGGREGATE_HISTOGRAM = 32,
+    AGGREGATE_ALL = 63
+};
+
+struct AggregateOptions
+{
+    int operations;      // AggregateOperation flags
+    bool weighted;       // weight every value by the product's quantity
+    int threads;         // threads sharing the pass; 0: one per core
+    int buckets;         // HISTOGRAM: number of equal-width buckets
+    double histogramMin; // HISTOGRAM: range [histogramMin, histogramMax];
+    double histogramMax; //   if histogramMin >= histogramMax, the range is [min, max] of the values
+
+    AggregateOptions(int operations = AGGREGATE_ALL, bool weighted = false)
+        : operations(operations), weighted(weighted), threads(1), buckets(10), histogramMin(0), histogramMax(0) {}
+};
+
+/*
+ * AggregateResult: statistics of one attribute over the products that have it.
+ *  >> count: number of such products (weighted: their total quantity);
+ *  >> sum, avg: of the values (weighted: of value * quantity, and sum / total quantity);
+ *  >> min, max: of the values, whatever the weights; 0 when count is 0;
+ *  >> histogram[b]: values (weighted: units) in [histogramMin + b * bucketWidth, + bucketWidth),
+ *     the last bucket includes histogramMax; values outside the range are not counted.
+ * Only the requested operations are filled in (histogram is empty otherwise).
+ */
+struct AggregateResult
+{
+    double count;
+    double sum;
+    double min;
+    double max;
+    double avg;
+    double histogramMin;
+    double bucketWidth;
+    List1D<double> histogram;
+
+    AggregateResult() : count(0), sum(0), min(0), max(0), avg(0), histogramMin(0), bucketWidth(0) {}
+};
+
+// -------------------- InventoryJournal --------------------
+/*
+ * InventoryJournal: receives every mutation of an InventoryManager (see setJournal).
+ *  >> logAdd / logRemove / logUpdate are called with valid arguments BEFORE the mutation is applied,
+ *  >> applied is called AFTER it, with the inventory in its new state;
+ *  >> replaced is called AFTER the whole inventory was assigned (operator=), instead of one record
+ *     per product: the journal must record the new state as a whole (InventoryLog checkpoints).
+ *  >> beginBatch / commitBatch / abortBatch enclose records that must be kept all or not at all:
+ *     after abortBatch, none of the records since beginBatch may reach the journal's storage
+ *     (InventoryLog writes a batch as one record); the defaults do nothing.
+ * See InventoryLog (app/wal.h) for the write-ahead log built on it.
+ */
+class InventoryJournal
+{
+public:
+    virtual ~InventoryJournal() {}
+    virtual void logAdd(const List1D<InventoryAttribute> &attributes, const string &name, int quantity) = 0;
+    virtual void logRemove(int index) = 0;
+    virtual void logUpdate(int index, int newQuantity) = 0;
+    virtual void applied(const InventoryManager &inventory) {}
+    virtual void replaced(const InventoryManager &inventory) = 0;
+    virtual void beginBatch() {}
+    virtual void commitBatch() {}
+    virtual void abortBatch() {}
+};
+
+// -------------------- InventoryObserver --------------------
+/*
+ * InventoryObserver: is told about every change of an InventoryManager it watches (see addObserver),
+ * with what it needs to maintain data derived from the inventory incrementally:
+ *  >> productAdded(inventory, index): AFTER the product was appended, at "index";
+ *  >> productRemoving(inventory, index): BEFORE product "index" is removed (it can still be read);
+ *  >> quantityChanged(inventory, index, oldQuantity, newQuantity): AFTER a quantity changed;
+ *  >> inventoryReplaced(inventory): AFTER the whole inventory was assigned (operator=).
+ * See QueryCache (app/cache.h).
+ */
+class InventoryObserver
+{
+public:
+    virtual ~InventoryObserver() {}
+    virtual void productAdded(const InventoryManager &inventory, int index) = 0;
+    virtual void productRemoving(const InventoryManager &inventory, int index) = 0;
+    virtual void quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity) = 0;
+    virtual void inventoryReplaced(const InventoryManager &inventory) = 0;
+};
+
 // -------------------- InventoryManager --------------------
 class InventoryManager
 {
 private:
     List2D<InventoryAttribute> attributesMatrix;
     List1D<string> productNames;
-    List1D<int> quantities;
+    QuantityColumn quantities;
+    InventoryJournal *journal; // not owned; may be NULL
+    long structure;            // see structureVersion()
+    List1D<InventoryObserver *> observers; // not owned
 
 public:
     InventoryManager();
@@ -112,18 +268,76 @@ public:
                      const List1D<string> &names,
                      const List1D<int> &quantities);
     InventoryManager(const InventoryManager &other);
+    InventoryManager &operator=(const InventoryManager &other);
 
     int size() const;
     List1D<InventoryAttribute> getProductAttributes(int index) const;
     string getProductName(int index) const;
     int getProductQuantity(int index) const;
+
+    /* attributeCount(index), attributeAt(index, j): a product's attributes, read in place
+     *   (getProductAttributes copies them)
+     */
+    int attributeCount(int index) const;
+    const InventoryAttribute &attributeAt(int index, int j) const;
+
+    /* structureVersion(): changes whenever products are added or removed (quantity changes keep it).
+     *   Versions are unique across all inventories of the process: two inventories with the same
+     *   version have the same products, so indexes built on one are valid for the other.
+     */
+    long structureVersion() const { return structure; }
+
     void updateQuantity(int index, int newQuantity);
+
+    /* adjustQuantity(index, delta), tryReserve(index, n): lock-free stock changes (see QuantityColumn)
+     *   >> safe to call from many threads at once, and concurrently with reads,
+     *      but not concurrently with addProduct / removeProduct / removeDuplicates
+     *   >> adjustQuantity returns the new quantity; tryReserve takes n items only if n are in stock,
+     *      and throws std::invalid_argument if n <= 0
+     *   >> a journal receives them as logUpdate(index, resulting quantity), after they are applied
+     *      (journals are not thread-safe: serialize these calls when one is attached)
+     */
+    int adjustQuantity(int index, int delta);
+    bool tryReserve(int index, int n);
+
+    /* setPaddedQuantities(padded): give each quantity counter its own cache line
+     *   (avoids false sharing between hot products; must not run concurrently with anything else)
+     */
+    void setPaddedQuantities(bool padded);
+
     void addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
     void removeProduct(int index);
 
     List1D<string> query(string attributeName, const double &minValue,
                          const double &maxValue, int minQuantity, bool ascending) const;
 
+    /* queryRows(attributeName, minValue, maxValue, minQuantity): the products query would return, as
+     *   a compressed bitmap of product indices. Attributes are read in place and no name is touched:
+     *   count() it, combine it with other results (&=, |=, andNot), and fetch the names of one page
+     *   with getProductNames(rows, offset, limit).
+     *   The indices are valid until the next addProduct / removeProduct.
+     *
+     * Example:
+     *  RoaringBitmap rows = inventory.queryRows("weight", 1, 5, 10);
+     *  rows.andNot(inventory.queryRows("color", 3, 3, 0));
+     *  List1D<string> firstPage = inventory.getProductNames(rows, 0, 20);
+     */
+    RoaringBitmap queryRows(const string &attributeName, double minValue, double maxValue, int minQuantity) const;
+    List1D<string> getProductNames(const RoaringBitmap &rows, long offset, long limit) const;
+
+    /* aggregate(attributeName, options): count / sum / min / max / avg / histogram of the values of
+     *   one attribute (see AggregateResult), in one read-only pass over the attributes: no row is
+     *   copied. Values are gathered into contiguous blocks and reduced with vectorizable loops;
+     *   with options.threads != 1 the products are split between threads.
+     *   A product listing the attribute twice counts once, with its first value (as in query).
+     *
+     * Example:
+     *  AggregateResult stockValue = inventory.aggregate("price", AggregateOptions(AGGREGATE_SUM, true));
+     *  AggregateResult weights = inventory.aggregate("weight", AGGREGATE_MIN | AGGREGATE_MAX);
+     */
+    AggregateResult aggregate(const string &attributeName, const AggregateOptions &options = AggregateOptions()) const;
+    AggregateResult aggregate(const string &attributeName, int operations, bool weighted = false) const;
+
     void removeDuplicates();
 
     static InventoryManager merge(const InventoryManager &inv1,
@@ -136,89 +350,159 @@ public:
     List2D<InventoryAttribute> getAttributesMatrix() const;
     List1D<string> getProductNames() const;
     List1D<int> getQuantities() const;
+    /* indexOfQuantity(quantity), countOfQuantity(quantity): scan the live quantity column in place
+     *   (SIMD compares, see QuantityColumn::indexOf), e.g. countOfQuantity(0): products out of stock
+     */
+    int indexOfQuantity(int quantity) const { return quantities.indexOf(quantity); }
+    int countOfQuantity(int quantity) const { return quantities.countOf(quantity); }
     string toString() const;
+    void writeTo(Writer &writer) const;
+    void dump(int fd) const;
+
+    /* setJournal(journal): report every following updateQuantity / addProduct / removeProduct
+     *   (also the ones made by removeDuplicates) to "journal"; NULL turns journaling off.
+     *   Copies of the inventory are not journaled; an assigned inventory keeps its own journal,
+     *   and the assignment is reported to it (see InventoryJournal::replaced).
+     */
+    void setJournal(InventoryJournal *journal) { this->journal = journal; }
+    InventoryJournal *getJournal() const { return journal; }
+
+    /* addObserver(observer): tell "observer" about every following change (see InventoryObserver),
+     *   including the ones made by removeDuplicates, adjustQuantity and tryReserve.
+     *   Observers are called on the mutating thread: like journals, they need serialized mutations.
+     *   Copies of the inventory are not observed; an assigned inventory keeps its own observers.
+     * removeObserver(observer): stop; returns false if "observer" was not registered
+     */
+    void addObserver(InventoryObserver *observer) { observers.add(observer); }
+    bool removeObserver(InventoryObserver *observer);
+
+    /* stats(): latency histograms, allocation counts and event counters of query, queryRows,
+     *   addProduct, removeProduct, updateQuantity, removeDuplicates, merge, split and aggregate, for all
+     *   inventories of the process (see app/stats.h). Only recorded when compiled with -DINVENTORY_STATS.
+     * resetStats(): start counting again from zero
+     */
+    static string stats();
+    static void resetStats();
+
+private:
+    void checkProductIndex(int index) const;
+    static long newStructureVersion()
+    {
+        static atomic<long> next(0);
+        return ++next;
+    }
+
+    struct AggregatePartial // one thread's share of aggregate
+    {
+        double *values;  // gathered values of the range ...
+        double *weights; // ... and their quantities (weighted only)
+        int count;
+        double weightSum; // count, or total quantity
+        double sum;
+        double min;
+        double max;
+        double *buckets; // HISTOGRAM
+    };
+    void aggregateRange(const string &attributeName, const AggregateOptions &options,
+                        int begin, int end, AggregatePartial &partial) const;
 };
 
 // -------------------- List1D Method Definitions --------------------
 template <typename T>
 List1D<T>::List1D()
 {
-    pList = new XArrayList<T>();
 }
 
 template <typename T>
 List1D<T>::List1D(int num_elements)
 {
-    pList = new XArrayList<T>();
     for (int i = 0; i < num_elements; i++)
     {
-        pList->add(T());
+        list.add(T());
     }
 }
 
 template <typename T>
 List1D<T>::List1D(const T *array, int num_elements)
 {
-    pList = new XArrayList<T>();
     for (int i = 0; i < num_elements; i++)
     {
-        pList->add(array[i]);
+        list.add(array[i]);
     }
 }
 
 template <typename T>
 List1D<T>::List1D(const List1D<T> &other)
 {
-    pList = new XArrayList<T>();
     for (int i = 0; i < other.size(); i++)
     {
-        pList->add(other.get(i));
+        list.add(other.get(i));
+    }
+}
+
+template <typename T>
+List1D<T> &List1D<T>::operator=(const List1D<T> &other)
+{
+    if (this != &other)
+    {
+        list.clear();
+        for (int i = 0; i < other.size(); i++)
+        {
+            list.add(other.get(i));
+        }
     }
+    return *this;
 }
 
 template <typename T>
 List1D<T>::~List1D()
 {
-    delete pList;
 }
 
 template <typename T>
 int List1D<T>::size() const
 {
-    return pList->size();
+    return list.size();
 }
 
 template <typename T>
 T List1D<T>::get(int index) const
 {
-    return pList->get(index);
+    return list.get(index);
 }
 
 template <typename T>
 void List1D<T>::set(int index, T value)
 {
-    pList->get(index) = value;
+    list.get(index) = value;
 }
 
 template <typename T>
 void List1D<T>::add(const T &value)
 {
-    pList->add(value);
+    list.add(value);
 }
 
 template <typename T>
 string List1D<T>::toString() const
 {
-    stringstream ss;
-    ss << "[";
-    for (int i = 0; i < size(); i++)
+    StringWriter writer;
+    writeTo(writer);
+    return writer.str();
+}
+
+template <typename T>
+void List1D<T>::writeTo(Writer &writer) const
+{
+    writer.put('[');
+    int n = size();
+    for (int i = 0; i < n; i++)
     {
-        ss << get(i);
-        if (i < size() - 1)
-            ss << ", ";
+        writeItem(writer, list.get(i));
+        if (i < n - 1)
+            writer.write(", ", 2);
     }
-    ss << "]";
-    return ss.str();
+    writer.put(']');
 }
 
 template <typename T>
@@ -240,42 +524,78 @@ ostream &operator<<(ostream &os, const List1D<T> &list)
 template <typename T>
 void List1D<T>::remove(int index)
 {
-    pList->removeAt(index);
+    list.removeAt(index);
+}
+
+template <typename T>
+void List1D<T>::removeMarked(const bool *marked)
+{
+    int index = 0; // removeIf visits the items once, in order
+    list.removeIf([marked, &index](T &)
+                    { return marked[index++]; });
+}
+
+template <typename T>
+void List1D<T>::clear()
+{
+    list.clear();
+}
+
+template <typename T>
+int List1D<T>::indexOf(const T &value) const
+{
+    return list.indexOf(value);
+}
+
+template <typename T>
+int List1D<T>::countOf(const T &value) const
+{
+    return list.countOf(value);
 }
 // -------------------- List2D Method Definitions --------------------
 template <typename T>
 List2D<T>::List2D()
 {
-    pMatrix = new XArrayList<IList<T> *>();
+    pMatrix = new XArrayList<Row *>();
 }
 
 template <typename T>
 List2D<T>::List2D(List1D<T> *array, int num_rows)
 {
-    pMatrix = new XArrayList<IList<T> *>();
+    pMatrix = new XArrayList<Row *>(0, 0, num_rows > 0 ? num_rows : 1);
     for (int i = 0; i < num_rows; i++)
     {
-        pMatrix->add(new XArrayList<T>());
-        for (int j = 0; j < array[i].size(); j++)
-        {
-            pMatrix->get(i)->add(array[i].get(j));
-        }
+        pMatrix->add(newRow(array[i]));
     }
 }
 
 template <typename T>
 List2D<T>::List2D(const List2D<T> &other)
 {
-    pMatrix = new XArrayList<IList<T> *>();
-    for (int i = 0; i < other.rows(); i++)
+    int numRows = other.rows();
+    pMatrix = new XArrayList<Row *>(0, 0, numRows > 0 ? numRows : 1);
+    for (int i = 0; i < numRows; i++)
+    {
+        pMatrix->add(new Row(*other.pMatrix->get(i)));
+    }
+}
+
+template <typename T>
+List2D<T> &List2D<T>::operator=(const List2D<T> &other)
+{
+    if (this != &other)
     {
-        IList<T> *row = new XArrayList<T>();
-        for (int j = 0; j < other.getRow(i).size(); j++)
+        for (int i = 0; i < pMatrix->size(); i++)
+        {
+            delete pMatrix->get(i);
+        }
+        pMatrix->clear();
+        for (int i = 0; i < other.rows(); i++)
         {
-            row->add(other.get(i, j));
+            pMatrix->add(new Row(*other.pMatrix->get(i)));
         }
-        pMatrix->add(row);
     }
+    return *this;
 }
 
 template <typename T>
@@ -297,13 +617,10 @@ int List2D<T>::rows() const
 template <typename T>
 void List2D<T>::setRow(int rowIndex, const List1D<T> &row)
 {
-    delete pMatrix->get(rowIndex);
-    IList<T> *newRow = new XArrayList<T>();
-    for (int i = 0; i < row.size(); i++)
-    {
-        newRow->add(row.get(i));
-    }
-    pMatrix->get(rowIndex) = newRow;
+    Row *&slot = pMatrix->get(rowIndex);
+    Row *newData = newRow(row);
+    delete slot;
+    slot = newData;
 }
 
 template <typename T>
@@ -312,6 +629,18 @@ T List2D<T>::get(int rowIndex, int colIndex) const
     return pMatrix->get(rowIndex)->get(colIndex);
 }
 
+template <typename T>
+int List2D<T>::cols(int rowIndex) const
+{
+    return pMatrix->get(rowIndex)->size();
+}
+
+template <typename T>
+const T &List2D<T>::at(int rowIndex, int colIndex) const
+{
+    return pMatrix->get(rowIndex)->get(colIndex);
+}
+
 template <typename T>
 List1D<T> List2D<T>::getRow(int rowIndex) const
 {
@@ -326,16 +655,32 @@ List1D<T> List2D<T>::getRow(int rowIndex) const
 template <typename T>
 string List2D<T>::toString() const
 {
-    stringstream ss;
-    ss << "[";
-    for (int i = 0; i < rows(); i++)
+    StringWriter writer;
+    writeTo(writer);
+    return writer.str();
+}
+
+template <typename T>
+void List2D<T>::writeTo(Writer &writer) const
+{
+    writer.put('[');
+    int numRows = rows();
+    for (int i = 0; i < numRows; i++)
     {
-        ss << getRow(i).toString();
-        if (i < rows() - 1)
-            ss << ", ";
+        Row *row = pMatrix->get(i); // no getRow(i) copy
+        writer.put('[');
+        int numCols = row->size();
+        for (int j = 0; j < numCols; j++)
+        {
+            writeItem(writer, row->get(j));
+            if (j < numCols - 1)
+                writer.write(", ", 2);
+        }
+        writer.put(']');
+        if (i < numRows - 1)
+            writer.write(", ", 2);
     }
-    ss << "]";
-    return ss.str();
+    writer.put(']');
 }
 
 template <typename T>
@@ -356,40 +701,93 @@ void List2D<T>::removeRow(int index)
     pMatrix->removeAt(index);   // Xoá hàng khỏi danh sách
 }
 
+template <typename T>
+void List2D<T>::removeMarkedRows(const bool *marked)
+{
+    int index = 0;
+    pMatrix->removeIf([marked, &index](Row *&row)
+                      {
+        if (!marked[index++])
+            return false;
+        delete row;
+        return true; });
+}
+
 template <typename T>
 void List2D<T>::addRow(const List1D<T> &row)
 {
-    IList<T> *newRow = new XArrayList<T>();
-    for (int i = 0; i < row.size(); i++)
+    pMatrix->add(newRow(row));
+}
+
+template <typename T>
+typename List2D<T>::Row *List2D<T>::newRow(const List1D<T> &row)
+{
+    Row *newData = new Row();
+    newData->reserve(row.size());
+    for (typename List1D<T>::ConstIterator it = row.cbegin(); it != row.cend(); ++it)
     {
-        newRow->add(row.get(i));
+        newData->add(*it);
     }
-    pMatrix->add(newRow);
+    return newData;
 }
 
 // -------------------- InventoryManager Method Definitions --------------------
-InventoryManager::InventoryManager()
+InventoryManager::InventoryManager() : journal(nullptr), structure(newStructureVersion())
 {
-    attributesMatrix = List2D<InventoryAttribute>();
-    productNames = List1D<string>();
-    quantities = List1D<int>();
+    // attributesMatrix, productNames and quantities start out empty
 }
 
 InventoryManager::InventoryManager(const List2D<InventoryAttribute> &matrix,
                                    const List1D<string> &names,
-                                   const List1D<int> &quantities) : attributesMatrix(matrix), productNames(names), quantities(quantities) {}
+                                   const List1D<int> &quantities) : attributesMatrix(matrix), productNames(names),
+                                                                    journal(nullptr), structure(newStructureVersion())
+{
+    for (int i = 0; i < quantities.size(); i++)
+    {
+        this->quantities.add(quantities.get(i));
+    }
+}
 
 InventoryManager::InventoryManager(const InventoryManager &other) : attributesMatrix(other.attributesMatrix),
                                                                     productNames(other.productNames),
-                                                                    quantities(other.quantities) {}
+                                                                    quantities(other.quantities),
+                                                                    journal(nullptr), structure(other.structure) {}
+
+InventoryManager &InventoryManager::operator=(const InventoryManager &other)
+{
+    if (this == &other)
+        return *this;
+    attributesMatrix = other.attributesMatrix;
+    productNames = other.productNames;
+    quantities = other.quantities;
+    structure = other.structure;
+    if (journal != nullptr)
+        journal->replaced(*this);
+    for (int i = 0; i < observers.size(); i++)
+        observers.get(i)->inventoryReplaced(*this);
+    return *this;
+}
 
 int InventoryManager::size() const
 {
     return productNames.size();
 }
 
+int InventoryManager::attributeCount(int index) const
+{
+    checkProductIndex(index);
+    return attributesMatrix.cols(index);
+}
+
+const InventoryAttribute &InventoryManager::attributeAt(int index, int j) const
+{
+    checkProductIndex(index);
+    return attributesMatrix.at(index, j);
+}
+
 List1D<InventoryAttribute> InventoryManager::getProductAttributes(int index) const
 {
+    INVENTORY_COUNT(ATTRIBUTE_COPIES, attributesMatrix.cols(index));
     return attributesMatrix.getRow(index);
 }
 
@@ -405,112 +803,476 @@ int InventoryManager::getProductQuantity(int index) const
 
 void InventoryManager::updateQuantity(int index, int newQuantity)
 {
+    INVENTORY_PROBE(UPDATE_QUANTITY);
+    if (journal != nullptr)
+    {
+        checkProductIndex(index);
+        journal->logUpdate(index, newQuantity);
+    }
+    int oldQuantity = observers.size() > 0 ? quantities.get(index) : 0;
     quantities.set(index, newQuantity);
+    if (journal != nullptr)
+        journal->applied(*this);
+    for (int i = 0; i < observers.size(); i++)
+        observers.get(i)->quantityChanged(*this, index, oldQuantity, newQuantity);
+}
+
+int InventoryManager::adjustQuantity(int index, int delta)
+{
+    int newQuantity = quantities.adjust(index, delta);
+    if (journal != nullptr)
+    {
+        journal->logUpdate(index, newQuantity);
+        journal->applied(*this);
+    }
+    for (int i = 0; i < observers.size(); i++)
+        observers.get(i)->quantityChanged(*this, index, newQuantity - delta, newQuantity);
+    return newQuantity;
+}
+
+bool InventoryManager::tryReserve(int index, int n)
+{
+    // the quantity this reservation stored: another thread may change it again before we report it
+    int newQuantity = quantities.tryReserve(index, n);
+    if (newQuantity < 0)
+        return false;
+    if (journal != nullptr)
+    {
+        journal->logUpdate(index, newQuantity);
+        journal->applied(*this);
+    }
+    for (int i = 0; i < observers.size(); i++)
+        observers.get(i)->quantityChanged(*this, index, newQuantity + n, newQuantity);
+    return true;
+}
+
+void InventoryManager::setPaddedQuantities(bool padded)
+{
+    quantities.setPadded(padded);
 }
 
 void InventoryManager::addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
 {
+    INVENTORY_PROBE(ADD_PRODUCT);
+    if (journal != nullptr)
+        journal->logAdd(attributes, name, quantity);
     attributesMatrix.addRow(attributes); // ✅ Thêm dòng mới một cách an toàn
+    structure = newStructureVersion();
     productNames.add(name);
     quantities.add(quantity);
+    if (journal != nullptr)
+        journal->applied(*this);
+    for (int i = 0; i < observers.size(); i++)
+        observers.get(i)->productAdded(*this, size() - 1);
 }
 
 void InventoryManager::removeProduct(int index)
 {
+    INVENTORY_PROBE(REMOVE_PRODUCT);
+    if (journal != nullptr)
+    {
+        checkProductIndex(index);
+        journal->logRemove(index);
+    }
+    if (observers.size() > 0)
+    {
+        checkProductIndex(index);
+        for (int i = 0; i < observers.size(); i++)
+            observers.get(i)->productRemoving(*this, index);
+    }
     productNames.remove(index);
     quantities.remove(index);
     attributesMatrix.removeRow(index);
+    structure = newStructureVersion();
+    if (journal != nullptr)
+        journal->applied(*this);
 }
 
-List1D<string> InventoryManager::query(string attributeName, const double &minValue,
-                                       const double &maxValue, int minQuantity, bool ascending) const
+bool InventoryManager::removeObserver(InventoryObserver *observer)
 {
-    List1D<string> result;
-
-    for (int i = 0; i < size(); i++)
+    for (int i = 0; i < observers.size(); i++)
     {
-        List1D<InventoryAttribute> attributes = getProductAttributes(i);
-        bool matched = false;
+        if (observers.get(i) == observer)
+        {
+            observers.remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void InventoryManager::checkProductIndex(int index) const
+{
+    if (index < 0 || index >= size())
+        throw out_of_range("Product index is out of range!");
+}
 
-        for (int j = 0; j < attributes.size(); j++)
+void InventoryManager::aggregateRange(const string &attributeName, const AggregateOptions &options,
+                                      int begin, int end, AggregatePartial &partial) const
+{
+    /*
+     * Gathers the attribute's values of products [begin, end) into partial.values (and their
+     * quantities into partial.weights), reading the rows in place, then reduces the contiguous
+     * array with four independent accumulators per statistic, which the compiler can keep in
+     * vector registers.
+     */
+    int count = 0;
+    for (int i = begin; i < end; i++)
+    {
+        int columns = attributesMatrix.cols(i);
+        for (int j = 0; j < columns; j++)
         {
-            if (attributes.get(j).name == attributeName &&
-                attributes.get(j).value >= minValue &&
-                attributes.get(j).value <= maxValue &&
-                getProductQuantity(i) >= minQuantity)
+            const InventoryAttribute &attribute = attributesMatrix.at(i, j);
+            if (attribute.name == attributeName)
             {
-                matched = true;
+                partial.values[count] = attribute.value;
+                if (partial.weights != nullptr)
+                    partial.weights[count] = quantities.get(i);
+                count++;
                 break;
             }
         }
+    }
+    partial.count = count;
 
-        if (matched)
+    const double *values = partial.values;
+    const double *weights = partial.weights;
+    double sum[4] = {0, 0, 0, 0}, weightSum[4] = {0, 0, 0, 0};
+    double low[4], high[4];
+    for (int l = 0; l < 4; l++)
+    {
+        low[l] = numeric_limits<double>::infinity();
+        high[l] = -numeric_limits<double>::infinity();
+    }
+    int k = 0;
+    if (weights != nullptr)
+    {
+        for (; k + 4 <= count; k += 4)
+            for (int l = 0; l < 4; l++)
+            {
+                sum[l] += values[k + l] * weights[k + l];
+                weightSum[l] += weights[k + l];
+                low[l] = values[k + l] < low[l] ? values[k + l] : low[l];
+                high[l] = values[k + l] > high[l] ? values[k + l] : high[l];
+            }
+        for (; k < count; k++)
+        {
+            sum[0] += values[k] * weights[k];
+            weightSum[0] += weights[k];
+            low[0] = values[k] < low[0] ? values[k] : low[0];
+            high[0] = values[k] > high[0] ? values[k] : high[0];
+        }
+    }
+    else
+    {
+        for (; k + 4 <= count; k += 4)
+            for (int l = 0; l < 4; l++)
+            {
+                sum[l] += values[k + l];
+                low[l] = values[k + l] < low[l] ? values[k + l] : low[l];
+                high[l] = values[k + l] > high[l] ? values[k + l] : high[l];
+            }
+        for (; k < count; k++)
         {
-            result.add(getProductName(i));
+            sum[0] += values[k];
+            low[0] = values[k] < low[0] ? values[k] : low[0];
+            high[0] = values[k] > high[0] ? values[k] : high[0];
         }
+        weightSum[0] = count;
+    }
+    partial.sum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    partial.weightSum = (weightSum[0] + weightSum[1]) + (weightSum[2] + weightSum[3]);
+    partial.min = low[0];
+    partial.max = high[0];
+    for (int l = 1; l < 4; l++)
+    {
+        partial.min = low[l] < partial.min ? low[l] : partial.min;
+        partial.max = high[l] > partial.max ? high[l] : partial.max;
     }
+}
+
+List1D<string> InventoryManager::query(string attributeName, const double &minValue,
+                                       const double &maxValue, int minQuantity, bool ascending) const
+{
+    INVENTORY_PROBE(QUERY);
+    List1D<string> result;
 
-    // Sắp xếp kết quả
-    if (ascending)
     {
-        for (int i = 0; i < result.size() - 1; i++)
+        INVENTORY_PROBE(QUERY_SCAN);
+        for (int i = 0; i < size(); i++)
         {
-            for (int j = i + 1; j < result.size(); j++)
+            if (quantities.get(i) < minQuantity)
+                continue;
+            // the row is read in place: no copy of the product's attributes
+            int columns = attributesMatrix.cols(i);
+            bool matched = false;
+
+            for (int j = 0; j < columns; j++)
             {
-                if (result.get(i) > result.get(j))
+                INVENTORY_COUNT(NAME_COMPARES, 1);
+                const InventoryAttribute &attribute = attributesMatrix.at(i, j);
+                if (attribute.name == attributeName &&
+                    attribute.value >= minValue &&
+                    attribute.value <= maxValue)
                 {
-                    string temp = result.get(i);
-                    result.set(i, result.get(j));
-                    result.set(j, temp);
+                    matched = true;
+                    break;
                 }
             }
+
+            if (matched)
+            {
+                result.add(getProductName(i));
+            }
         }
     }
+
+    // Sắp xếp kết quả
+    INVENTORY_PROBE(QUERY_SORT);
+    if (ascending)
+    {
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             {
+            INVENTORY_COUNT(SORT_COMPARES, 1);
+            return lhs < rhs; });
+    }
     else
     {
-        for (int i = 0; i < result.size() - 1; i++)
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             {
+            INVENTORY_COUNT(SORT_COMPARES, 1);
+            return lhs > rhs; });
+    }
+
+    return result;
+}
+
+RoaringBitmap InventoryManager::queryRows(const string &attributeName, double minValue, double maxValue,
+                                          int minQuantity) const
+{
+    INVENTORY_PROBE(QUERY_ROWS);
+    RoaringBitmap rows;
+    for (int i = 0; i < size(); i++)
+    {
+        if (quantities.get(i) < minQuantity)
+            continue;
+        int columns = attributesMatrix.cols(i);
+        for (int j = 0; j < columns; j++)
         {
-            for (int j = i + 1; j < result.size(); j++)
+            const InventoryAttribute &attribute = attributesMatrix.at(i, j);
+            if (attribute.name == attributeName && attribute.value >= minValue && attribute.value <= maxValue)
             {
-                if (result.get(i) < result.get(j))
-                {
-                    string temp = result.get(i);
-                    result.set(i, result.get(j));
-                    result.set(j, temp);
-                }
+                rows.add((uint32_t)i); // rows come in increasing order: O(1) appends
+                break;
             }
         }
     }
+    return rows;
+}
 
-    return result;
+AggregateResult InventoryManager::aggregate(const string &attributeName, int operations, bool weighted) const
+{
+    return aggregate(attributeName, AggregateOptions(operations, weighted));
 }
 
-void InventoryManager::removeDuplicates()
+AggregateResult InventoryManager::aggregate(const string &attributeName, const AggregateOptions &options) const
 {
-    for (int i = 0; i < size(); i++)
+    INVENTORY_PROBE(AGGREGATE);
+    bool histogram = (options.operations & AGGREGATE_HISTOGRAM) != 0;
+    if (histogram && options.buckets <= 0)
+        throw invalid_argument("aggregate: the histogram needs at least one bucket");
+
+    // threads: below a few thousand products per thread, starting them costs more than they save
+    const int minProductsPerThread = 4096;
+    int n = size();
+    int threads = options.threads > 0 ? options.threads : (int)thread::hardware_concurrency();
+    if (threads > n / minProductsPerThread)
+        threads = n / minProductsPerThread;
+    if (threads < 1)
+        threads = 1;
+
+    double *values = new double[n > 0 ? n : 1];
+    double *weights = options.weighted ? new double[n > 0 ? n : 1] : nullptr;
+    AggregatePartial *partials = new AggregatePartial[threads];
+    // one range of partials per thread, i.e. one partial each: runParallel(work) calls work(t) for every t
+    auto runParallel = [threads](auto work)
+    {
+        parallelRanges(threads, threads, 1, [&work](long first, long last)
+                       {
+            for (long t = first; t < last; t++)
+                work((int)t); });
+    };
+
+    // pass 1: gather the values of each range, then count / sum / min / max them
+    runParallel([&](int t)
+                {
+        int begin = (int)((long)n * t / threads);
+        int end = (int)((long)n * (t + 1) / threads);
+        partials[t].values = values + begin;
+        partials[t].weights = weights != nullptr ? weights + begin : nullptr;
+        partials[t].buckets = nullptr;
+        aggregateRange(attributeName, options, begin, end, partials[t]); });
+
+    AggregateResult result;
+    long gathered = 0;
+    double weightSum = 0, sum = 0;
+    double minValue = numeric_limits<double>::infinity(), maxValue = -numeric_limits<double>::infinity();
+    for (int t = 0; t < threads; t++)
+    {
+        gathered += partials[t].count;
+        weightSum += partials[t].weightSum;
+        sum += partials[t].sum;
+        minValue = partials[t].min < minValue ? partials[t].min : minValue;
+        maxValue = partials[t].max > maxValue ? partials[t].max : maxValue;
+    }
+    bool empty = gathered == 0;
+    if (options.operations & AGGREGATE_COUNT)
+        result.count = weightSum;
+    if (options.operations & AGGREGATE_SUM)
+        result.sum = sum;
+    if (options.operations & AGGREGATE_MIN)
+        result.min = empty ? 0 : minValue;
+    if (options.operations & AGGREGATE_MAX)
+        result.max = empty ? 0 : maxValue;
+    if (options.operations & AGGREGATE_AVG)
+        result.avg = weightSum == 0 ? 0 : sum / weightSum;
+
+    // pass 2: bucket the gathered values (no second walk over the attributes)
+    if (histogram)
     {
-        string nameI = productNames.get(i);
-        for (int j = i + 1; j < size(); j++)
+        double low = options.histogramMin, high = options.histogramMax;
+        if (low >= high)
         {
-            if (productNames.get(j) == nameI)
+            low = empty ? 0 : minValue;
+            high = empty ? 0 : maxValue;
+        }
+        int buckets = options.buckets;
+        double width = (high - low) / buckets;
+        double scale = width > 0 ? 1.0 / width : 0.0;
+        runParallel([&](int t)
+                    {
+            AggregatePartial &partial = partials[t];
+            partial.buckets = new double[buckets]();
+            for (int k = 0; k < partial.count; k++)
             {
-                // Cộng dồn quantity
-                int updatedQty = quantities.get(i) + quantities.get(j);
-                quantities.set(i, updatedQty);
+                double v = partial.values[k];
+                if (!(v >= low && v <= high))
+                    continue;
+                int b = (int)((v - low) * scale);
+                if (b >= buckets)
+                    b = buckets - 1;
+                partial.buckets[b] += partial.weights != nullptr ? partial.weights[k] : 1.0;
+            } });
+        result.histogramMin = low;
+        result.bucketWidth = width;
+        for (int b = 0; b < buckets; b++)
+        {
+            double total = 0;
+            for (int t = 0; t < threads; t++)
+                total += partials[t].buckets[b];
+            result.histogram.add(total);
+        }
+        for (int t = 0; t < threads; t++)
+            delete[] partials[t].buckets;
+    }
 
-                // Xoá sản phẩm trùng tại vị trí j
-                removeProduct(j);
+    delete[] partials;
+    delete[] values;
+    delete[] weights;
+    return result;
+}
 
-                // Sau khi xoá, cần giảm j vì danh sách bị dồn lại
-                j--;
-            }
+void InventoryManager::removeDuplicates()
+{
+    INVENTORY_PROBE(REMOVE_DUPLICATES);
+    /*
+     * The first product of each name gets the sum of the quantities of that name; the others are removed.
+     * Products are sorted by (name, index) to find the groups, then every column is compacted in one pass.
+     * The journal and the observers see what the equivalent calls would report: one updateQuantity per
+     * merged product, then one removeProduct per duplicate, from the last index down (so each index is
+     * still the product's own when it is reported).
+     * Every record is logged, as one batch, before anything changes: if the journal throws, the batch is
+     * aborted and the inventory is left as it was.
+     */
+    int n = size();
+    if (n < 2)
+        return;
+    XArrayList<int> order(0, 0, n);
+    XArrayList<bool> duplicate(0, 0, n);
+    for (int i = 0; i < n; i++)
+    {
+        order.add(i);
+        duplicate.add(false);
+    }
+    List1D<string>::ConstIterator names = productNames.cbegin();
+    sort(order.begin(), order.end(), [&names](int a, int b)
+         {
+        int compared = names[a].compare(names[b]);
+        return compared < 0 || (compared == 0 && a < b); });
+
+    XArrayList<int> merges; // per merged product: its index, then its new quantity
+    for (int start = 0, end; start < n; start = end)
+    {
+        int first = order.get(start), total = quantities.get(first);
+        for (end = start + 1; end < n && names[order.get(end)] == names[first]; end++)
+        {
+            total += quantities.get(order.get(end));
+            duplicate.get(order.get(end)) = true;
+        }
+        if (end - start > 1)
+        {
+            merges.add(first);
+            merges.add(total);
         }
     }
+    if (merges.size() == 0)
+        return;
+
+    if (journal != nullptr)
+    {
+        journal->beginBatch();
+        try
+        {
+            for (int k = 0; k < merges.size(); k += 2)
+                journal->logUpdate(merges.get(k), merges.get(k + 1));
+            for (int j = n - 1; j >= 0; j--)
+                if (duplicate.get(j))
+                    journal->logRemove(j);
+            journal->commitBatch();
+        }
+        catch (...)
+        {
+            journal->abortBatch();
+            throw;
+        }
+    }
+
+    for (int k = 0; k < merges.size(); k += 2)
+    {
+        int first = merges.get(k), oldQuantity = quantities.get(first);
+        quantities.set(first, merges.get(k + 1));
+        for (int i = 0; i < observers.size(); i++)
+            observers.get(i)->quantityChanged(*this, first, oldQuantity, merges.get(k + 1));
+    }
+    for (int j = n - 1; j >= 0; j--)
+    {
+        if (duplicate.get(j))
+            for (int i = 0; i < observers.size(); i++)
+                observers.get(i)->productRemoving(*this, j);
+    }
+    const bool *marked = &duplicate.get(0);
+    productNames.removeMarked(marked);
+    quantities.removeMarked(marked);
+    attributesMatrix.removeMarkedRows(marked);
+    structure = newStructureVersion();
+    if (journal != nullptr)
+        journal->applied(*this);
 }
 
 InventoryManager InventoryManager::merge(const InventoryManager &inv1,
                                          const InventoryManager &inv2)
 {
+    INVENTORY_PROBE(MERGE);
     InventoryManager result = inv1;
     for (int i = 0; i < inv2.size(); i++)
     {
@@ -523,6 +1285,7 @@ void InventoryManager::split(InventoryManager &section1,
                              InventoryManager &section2,
                              double ratio) const
 {
+    INVENTORY_PROBE(SPLIT);
     int splitIndex = size() * ratio;
 
     for (int i = 0; i < splitIndex; i++)
@@ -540,6 +1303,15 @@ List2D<InventoryAttribute> InventoryManager::getAttributesMatrix() const
     return attributesMatrix;
 }
 
+List1D<string> InventoryManager::getProductNames(const RoaringBitmap &rows, long offset, long limit) const
+{
+    // names of the rows of rank [offset, offset + limit), in increasing row order
+    List1D<string> names;
+    rows.forEachRange(offset, limit, [&](uint32_t row)
+                      { names.add(getProductName((int)row)); });
+    return names;
+}
+
 List1D<string> InventoryManager::getProductNames() const
 {
     return productNames;
@@ -547,18 +1319,61 @@ List1D<string> InventoryManager::getProductNames() const
 
 List1D<int> InventoryManager::getQuantities() const
 {
-    return quantities;
+    List1D<int> result;
+    for (int i = 0; i < quantities.size(); i++)
+    {
+        result.add(quantities.get(i));
+    }
+    return result;
 }
 
 string InventoryManager::toString() const
 {
-    stringstream ss;
-    ss << "InventoryManager[\n";
-    ss << "  AttributesMatrix: " << getAttributesMatrix().toString() << ",\n";
-    ss << "  ProductNames: " << productNames.toString() << ",\n";
-    ss << "  Quantities: " << quantities.toString() << "\n";
-    ss << "]";
-    return ss.str();
+    StringWriter writer(1024);
+    writeTo(writer);
+    return writer.str();
+}
+
+void InventoryManager::writeTo(Writer &writer) const
+{
+    writer.write("InventoryManager[\n");
+    writer.write("  AttributesMatrix: ");
+    attributesMatrix.writeTo(writer); // no getAttributesMatrix() copy
+    writer.write(",\n");
+    writer.write("  ProductNames: ");
+    productNames.writeTo(writer);
+    writer.write(",\n");
+    writer.write("  Quantities: ");
+    quantities.writeTo(writer);
+    writer.write("\n");
+    writer.put(']');
+}
+
+void InventoryManager::dump(int fd) const
+{
+    /*
+     * Streams toString() to a file descriptor (e.g. STDOUT_FILENO or an open file)
+     * through a fixed-size buffer, without building the whole text in memory.
+     */
+    FdWriter writer(fd);
+    writeTo(writer);
+    writer.flush();
+}
+
+string InventoryManager::stats()
+{
+#ifdef INVENTORY_STATS
+    return InventoryStats::global().toString();
+#else
+    return "InventoryManager statistics are disabled (compile with -DINVENTORY_STATS)\n";
+#endif
+}
+
+void InventoryManager::resetStats()
+{
+#ifdef INVENTORY_STATS
+    InventoryStats::global().reset();
+#endif
 }
 
 inline ostream &operator<<(ostream &os, const InventoryAttribute &attr)
@@ -0,0 +1,288 @@
+#ifndef QUANTITY_COLUMN_H
+#define QUANTITY_COLUMN_H
+
+#include "util/Writer.h"
+#include "util/Simd.h"
+#include <atomic>
+#include <stdexcept>
+
+using namespace std;
+
+// -------------------- QuantityColumn --------------------
+/*
+ * QuantityColumn: the stock quantities of an InventoryManager, one atomic<int> per product.
+ *
+ *  >> get / set / adjust / tryReserve are atomic, and may run concurrently with each other
+ *     (no lock: adjust is a fetch_add, tryReserve a compare-and-swap loop);
+ *  >> add / remove / clear / operator= change the column's shape, and need exclusive access;
+ *  >> indexOf / countOf scan the column: relaxed atomic loads into a small local buffer, which the
+ *     SIMD compares of util/Simd.h scan; run during concurrent stock changes, they see each counter
+ *     at some moment of the scan, not a snapshot.
+ *
+ * By default the counters are packed (16 per cache line). A padded column gives every counter
+ * its own 64-byte cache line, so threads hammering neighbouring hot SKUs do not invalidate each
+ * other's lines (false sharing), at 16x the memory.
+ */
+class QuantityColumn
+{
+private:
+    static const int LINE_INTS = 64 / sizeof(int);
+    static const int SCAN_BLOCK = 256; // counters copied per step by indexOf / countOf
+    struct alignas(64) Line
+    {
+        atomic<int> value[LINE_INTS];
+    };
+
+    Line *lines;
+    int count;
+    int capacity; // number of counters that fit in lines
+    int stride;   // distance between two counters: 1 (packed) or LINE_INTS (padded)
+
+public:
+    QuantityColumn(bool padded = false);
+    QuantityColumn(const QuantityColumn &other);
+    QuantityColumn &operator=(const QuantityColumn &other);
+    ~QuantityColumn();
+
+    int size() const { return count; }
+    bool padded() const { return stride != 1; }
+    void setPadded(bool padded);
+
+    int get(int index) const;
+    void set(int index, int value);
+    void add(int value);
+    void remove(int index);
+    void removeMarked(const bool *marked); // every index i with marked[i] (size() flags), in one pass
+    void clear() { count = 0; }
+
+    /* adjust(index, delta): add "delta" (may be negative) to the quantity; return the new quantity
+     */
+    int adjust(int index, int delta);
+
+    /* tryReserve(index, n): take "n" items if at least "n" are in stock
+     *
+     * return:
+     *  >> the new quantity (the value the reservation stored, never negative) if it was decreased by n
+     *  >> -1 (quantity unchanged) if fewer than n items are in stock
+     *  >> throw std::invalid_argument if n <= 0 (a negative reservation would restock)
+     */
+    int tryReserve(int index, int n);
+
+    // first index holding "value" (or -1), and the number of such indices
+    int indexOf(int value) const;
+    int countOf(int value) const;
+
+    void writeTo(Writer &writer) const;
+
+private:
+    atomic<int> &slot(int index) const
+    {
+        long position = (long)index * stride;
+        return lines[position / LINE_INTS].value[position % LINE_INTS];
+    }
+    // load(start, n, buffer): counters start .. start + n - 1 (start: a multiple of LINE_INTS),
+    // with relaxed loads, a line at a time
+    void load(int start, int n, int *buffer) const
+    {
+        if (padded())
+        {
+            for (int k = 0; k < n; k++)
+                buffer[k] = lines[start + k].value[0].load(memory_order_relaxed);
+            return;
+        }
+        const Line *line = lines + start / LINE_INTS;
+        for (int base = 0; base < n; base += LINE_INTS, line++)
+        {
+            int end = n - base < LINE_INTS ? n - base : LINE_INTS;
+            for (int k = 0; k < end; k++)
+                buffer[base + k] = line->value[k].load(memory_order_relaxed);
+        }
+    }
+    void checkIndex(int index) const;
+    void reallocate(int newCapacity, int newStride);
+};
+
+// -------------------- QuantityColumn Method Definitions --------------------
+QuantityColumn::QuantityColumn(bool padded)
+{
+    lines = nullptr;
+    count = 0;
+    capacity = 0;
+    stride = padded ? LINE_INTS : 1;
+    reallocate(padded ? 4 : LINE_INTS, stride);
+}
+
+QuantityColumn::QuantityColumn(const QuantityColumn &other)
+{
+    lines = nullptr;
+    count = 0;
+    capacity = 0;
+    stride = other.stride;
+    reallocate(other.count > 0 ? other.count : (other.padded() ? 4 : LINE_INTS), stride);
+    for (int i = 0; i < other.count; i++)
+        slot(i).store(other.get(i), memory_order_relaxed);
+    count = other.count;
+}
+
+QuantityColumn &QuantityColumn::operator=(const QuantityColumn &other)
+{
+    if (this != &other)
+    {
+        count = 0;
+        if (capacity < other.count)
+            reallocate(other.count, stride);
+        for (int i = 0; i < other.count; i++)
+            slot(i).store(other.get(i), memory_order_relaxed);
+        count = other.count;
+    }
+    return *this;
+}
+
+QuantityColumn::~QuantityColumn()
+{
+    delete[] lines;
+}
+
+void QuantityColumn::setPadded(bool padded)
+{
+    int newStride = padded ? LINE_INTS : 1;
+    if (newStride != stride)
+        reallocate(capacity, newStride);
+}
+
+int QuantityColumn::get(int index) const
+{
+    checkIndex(index);
+    return slot(index).load();
+}
+
+void QuantityColumn::set(int index, int value)
+{
+    checkIndex(index);
+    slot(index).store(value);
+}
+
+void QuantityColumn::add(int value)
+{
+    if (count == capacity)
+        reallocate(capacity * 2, stride);
+    slot(count).store(value, memory_order_relaxed);
+    count++;
+}
+
+void QuantityColumn::remove(int index)
+{
+    checkIndex(index);
+    for (int i = index; i < count - 1; i++)
+        slot(i).store(slot(i + 1).load(memory_order_relaxed), memory_order_relaxed);
+    count--;
+}
+
+void QuantityColumn::removeMarked(const bool *marked)
+{
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+        if (!marked[i])
+            slot(kept++).store(slot(i).load(memory_order_relaxed), memory_order_relaxed);
+    count = kept;
+}
+
+int QuantityColumn::adjust(int index, int delta)
+{
+    checkIndex(index);
+    return slot(index).fetch_add(delta) + delta;
+}
+
+int QuantityColumn::tryReserve(int index, int n)
+{
+    checkIndex(index);
+    if (n <= 0)
+        throw invalid_argument("tryReserve: n must be positive");
+    atomic<int> &quantity = slot(index);
+    int current = quantity.load(memory_order_relaxed);
+    while (current >= n)
+    {
+        // on failure, current is reloaded with the value another thread stored
+        if (quantity.compare_exchange_weak(current, current - n))
+            return current - n;
+    }
+    return -1;
+}
+
+int QuantityColumn::indexOf(int value) const
+{
+    // the counters are atomics: copy a block with relaxed loads, then compare the copy
+    int buffer[SCAN_BLOCK];
+    for (int start = 0; start < count; start += SCAN_BLOCK)
+    {
+        int n = count - start < SCAN_BLOCK ? count - start : SCAN_BLOCK;
+        load(start, n, buffer);
+        int found = simdIndexOf(buffer, n, value);
+        if (found >= 0)
+            return start + found;
+    }
+    return -1;
+}
+
+int QuantityColumn::countOf(int value) const
+{
+    int buffer[SCAN_BLOCK];
+    int matches = 0;
+    for (int start = 0; start < count; start += SCAN_BLOCK)
+    {
+        int n = count - start < SCAN_BLOCK ? count - start : SCAN_BLOCK;
+        load(start, n, buffer);
+        matches += simdCount(buffer, n, value);
+    }
+    return matches;
+}
+
+void QuantityColumn::writeTo(Writer &writer) const
+{
+    writer.put('[');
+    for (int i = 0; i < count; i++)
+    {
+        writer.writeInt(slot(i).load(memory_order_relaxed));
+        if (i < count - 1)
+            writer.write(", ", 2);
+    }
+    writer.put(']');
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+void QuantityColumn::checkIndex(int index) const
+{
+    if (index < 0 || index >= count)
+        throw out_of_range("Index is out of range!");
+}
+
+void QuantityColumn::reallocate(int newCapacity, int newStride)
+{
+    /*
+     * Moves the counters to a new, zeroed line array holding at least newCapacity counters
+     * spaced newStride apart.
+     */
+    if (newCapacity < count)
+        newCapacity = count;
+    int numLines = (int)(((long)newCapacity * newStride + LINE_INTS - 1) / LINE_INTS);
+    if (numLines < 1)
+        numLines = 1;
+    Line *newLines = new Line[numLines];
+    for (int i = 0; i < numLines; i++)
+        for (int j = 0; j < LINE_INTS; j++)
+            newLines[i].value[j].store(0, memory_order_relaxed);
+    for (int i = 0; i < count; i++)
+    {
+        long position = (long)i * newStride;
+        newLines[position / LINE_INTS].value[position % LINE_INTS].store(slot(i).load(memory_order_relaxed),
+                                                                         memory_order_relaxed);
+    }
+    delete[] lines;
+    lines = newLines;
+    stride = newStride;
+    capacity = numLines * LINE_INTS / newStride;
+}
+
+#endif /* QUANTITY_COLUMN_H */
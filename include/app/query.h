@@ -0,0 +1,780 @@
+#ifndef INVENTORY_QUERY_H
+#define INVENTORY_QUERY_H
+
+#include "app/inventory.h"
+#include "util/Bitmap.h"
+#include "util/RoaringBitmap.h"
+#include "util/Writer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+// -------------------- Predicate --------------------
+/*
+ * Predicate: a condition on the products of an InventoryManager, built from
+ *  >> range(attribute, min, max):          some value of "attribute" is in [min, max] (as in query)
+ *  >> above / atLeast (attribute, value):  some value of "attribute" is > value / >= value
+ *  >> below / atMost (attribute, value):   some value of "attribute" is < value / <= value
+ *  >> quantityAtLeast(q) / quantityAtMost(q): the product's quantity is >= q / <= q
+ * combined with && and || (nested ANDs / ORs are flattened: a && b && c has three children).
+ *
+ * Example:
+ *  Predicate p = Predicate::range("weight", 1, 5) && Predicate::above("height", 10) &&
+ *                Predicate::quantityAtLeast(3);
+ */
+class Predicate
+{
+public:
+    enum Kind
+    {
+        RANGE,
+        QUANTITY,
+        AND,
+        OR
+    };
+
+private:
+    Kind type;
+    string name; // RANGE
+    double low, high;
+    bool lowInclusive, highInclusive;
+    int quantity, highQuantity; // QUANTITY: in [quantity, highQuantity]
+    Predicate *children; // AND, OR
+    int numChildren;
+
+public:
+    Predicate(const Predicate &other);
+    Predicate &operator=(const Predicate &other);
+    ~Predicate();
+
+    static Predicate range(const string &attribute, double min, double max);
+    static Predicate above(const string &attribute, double value);
+    static Predicate atLeast(const string &attribute, double value);
+    static Predicate below(const string &attribute, double value);
+    static Predicate atMost(const string &attribute, double value);
+    static Predicate quantityAtLeast(int quantity);
+    static Predicate quantityAtMost(int quantity);
+
+    friend Predicate operator&&(const Predicate &lhs, const Predicate &rhs);
+    friend Predicate operator||(const Predicate &lhs, const Predicate &rhs);
+
+    Kind kind() const { return type; }
+    const string &attribute() const { return name; }
+    int minQuantity() const { return quantity; }
+    int maxQuantity() const { return highQuantity; }
+    int size() const { return numChildren; }
+    const Predicate &child(int index) const;
+
+    // accepts(value): value is in the RANGE
+    bool accepts(double value) const
+    {
+        return (lowInclusive ? value >= low : value > low) && (highInclusive ? value <= high : value < high);
+    }
+
+    /* matches(inventory, index): product "index" satisfies the predicate (reads the row in place)
+     */
+    bool matches(const InventoryManager &inventory, int index) const;
+
+    // e.g. "(weight in [1, 5] AND height > 10 AND quantity >= 3)"
+    string toString() const;
+    void writeTo(Writer &writer) const;
+
+    friend class QueryEngine;
+
+private:
+    Predicate(Kind type = QUANTITY); // also the placeholder of new Predicate[n]
+    static Predicate combine(Kind type, const Predicate &lhs, const Predicate &rhs);
+    static Predicate bound(const string &attribute, double low, bool lowInclusive, double high, bool highInclusive);
+};
+
+// -------------------- QueryEngine --------------------
+/*
+ * QueryEngine: evaluates Predicates on one InventoryManager (which must outlive the engine).
+ *
+ * Each RANGE is answered either by a probe of a per-attribute index (a sorted array of the
+ * attribute's (value, product) pairs, see createIndex) or by a scan of the products; intermediate
+ * results are Bitmaps of product indices, combined word by word.
+ *
+ * Plan, per node:
+ *  >> OR: the union of the children's bitmaps;
+ *  >> AND: children in order of increasing estimated selectivity. The first one produces the
+ *     candidates; each following child either probes its index and intersects (cost ~ log n +
+ *     matching rows + n/64) or checks the remaining candidates one by one (cost ~ candidates x
+ *     attributes per product), whichever is cheaper, and the AND stops once no candidate is left.
+ * Selectivity is exact for indexed ranges (two binary searches) and sampled (256 products) otherwise.
+ *
+ * Indexes follow the inventory: one built before addProduct / removeProduct is rebuilt by the next
+ * query that uses it (quantities are never indexed, so updateQuantity costs nothing).
+ * A QueryEngine is not thread-safe: use one per thread.
+ *
+ * Example:
+ *  QueryEngine engine(inventory);
+ *  engine.createIndex("weight");
+ *  Predicate light = Predicate::range("weight", 1, 5) && Predicate::quantityAtLeast(3);
+ *  List1D<string> names = engine.names(light);
+ *  cout << engine.explain(light);
+ */
+class QueryEngine
+{
+private:
+    struct Entry
+    {
+        double value;
+        int row;
+    };
+    struct AttributeIndex
+    {
+        string attribute;
+        long version; // InventoryManager::structureVersion() of entries
+        Entry *entries;
+        int size;
+    };
+
+    const InventoryManager &inventory;
+    AttributeIndex **indexes;
+    int numIndexes;
+
+public:
+    QueryEngine(const InventoryManager &inventory);
+    ~QueryEngine();
+
+    /* createIndex(attribute): index "attribute" (built now, kept up to date by the queries)
+     * dropIndex(attribute): forget it again; returns false if it was not indexed
+     */
+    void createIndex(const string &attribute);
+    bool dropIndex(const string &attribute);
+    bool hasIndex(const string &attribute) const;
+
+    /* bitmap(p): the products matching p, as a bitmap of size inventory.size()
+     * indices(p): the same, in increasing order
+     * names(p, ascending): the names of the matching products, sorted like query's
+     * rows(p): the same, compressed (see InventoryManager::queryRows)
+     * count(p): how many products match
+     */
+    Bitmap bitmap(const Predicate &predicate);
+    RoaringBitmap rows(const Predicate &predicate);
+    List1D<int> indices(const Predicate &predicate);
+    List1D<string> names(const Predicate &predicate, bool ascending = true);
+    long count(const Predicate &predicate);
+
+    /* estimate(p): estimated fraction of the products matching p, in [0, 1]
+     */
+    double estimate(const Predicate &predicate);
+
+    /* explain(p): run p and describe the plan, one line per node: how it was evaluated (probe, scan,
+     *   filter, union or intersect), the estimated and the actual number of matching products
+     */
+    string explain(const Predicate &predicate);
+
+private:
+    QueryEngine(const QueryEngine &);            // not copyable
+    QueryEngine &operator=(const QueryEngine &); // not copyable
+
+    AttributeIndex *findIndex(const string &attribute);
+    AttributeIndex *freshIndex(const string &attribute); // rebuilt if the inventory changed
+    void build(AttributeIndex &index);
+    int probeRange(AttributeIndex &index, const Predicate &range, int &first) const;
+
+    double sampleSelectivity(const Predicate &predicate) const;
+    double averageWidth() const;
+    double cost(const Predicate &predicate, double width);
+
+    Bitmap evaluate(const Predicate &predicate, int depth, StringWriter *plan);
+    void filter(Bitmap &candidates, const Predicate &predicate) const;
+    static void writePlan(StringWriter *plan, int depth, const char *access, const Predicate &predicate,
+                          double expected, long actual);
+};
+
+// -------------------- Predicate Method Definitions --------------------
+Predicate::Predicate(Kind type) : type(type), low(0), high(0), lowInclusive(true), highInclusive(true),
+                                  quantity(numeric_limits<int>::min()), highQuantity(numeric_limits<int>::max()),
+                                  children(nullptr), numChildren(0) {}
+
+Predicate::Predicate(const Predicate &other) : children(nullptr), numChildren(0)
+{
+    *this = other;
+}
+
+Predicate &Predicate::operator=(const Predicate &other)
+{
+    if (this == &other)
+        return *this;
+    Predicate *copies = nullptr;
+    if (other.numChildren > 0)
+    {
+        copies = new Predicate[other.numChildren];
+        for (int i = 0; i < other.numChildren; i++)
+            copies[i] = other.children[i];
+    }
+    delete[] children;
+    type = other.type;
+    name = other.name;
+    low = other.low;
+    high = other.high;
+    lowInclusive = other.lowInclusive;
+    highInclusive = other.highInclusive;
+    quantity = other.quantity;
+    highQuantity = other.highQuantity;
+    children = copies;
+    numChildren = other.numChildren;
+    return *this;
+}
+
+Predicate::~Predicate()
+{
+    delete[] children;
+}
+
+Predicate Predicate::range(const string &attribute, double min, double max)
+{
+    return bound(attribute, min, true, max, true);
+}
+
+Predicate Predicate::above(const string &attribute, double value)
+{
+    return bound(attribute, value, false, numeric_limits<double>::infinity(), true);
+}
+
+Predicate Predicate::atLeast(const string &attribute, double value)
+{
+    return bound(attribute, value, true, numeric_limits<double>::infinity(), true);
+}
+
+Predicate Predicate::below(const string &attribute, double value)
+{
+    return bound(attribute, -numeric_limits<double>::infinity(), true, value, false);
+}
+
+Predicate Predicate::atMost(const string &attribute, double value)
+{
+    return bound(attribute, -numeric_limits<double>::infinity(), true, value, true);
+}
+
+Predicate Predicate::quantityAtLeast(int quantity)
+{
+    Predicate predicate(QUANTITY);
+    predicate.quantity = quantity;
+    return predicate;
+}
+
+Predicate Predicate::quantityAtMost(int quantity)
+{
+    Predicate predicate(QUANTITY);
+    predicate.highQuantity = quantity;
+    return predicate;
+}
+
+Predicate operator&&(const Predicate &lhs, const Predicate &rhs)
+{
+    return Predicate::combine(Predicate::AND, lhs, rhs);
+}
+
+Predicate operator||(const Predicate &lhs, const Predicate &rhs)
+{
+    return Predicate::combine(Predicate::OR, lhs, rhs);
+}
+
+const Predicate &Predicate::child(int index) const
+{
+    if (index < 0 || index >= numChildren)
+        throw out_of_range("Index is out of range!");
+    return children[index];
+}
+
+bool Predicate::matches(const InventoryManager &inventory, int index) const
+{
+    switch (type)
+    {
+    case RANGE:
+    {
+        int columns = inventory.attributeCount(index);
+        for (int j = 0; j < columns; j++)
+        {
+            const InventoryAttribute &attribute = inventory.attributeAt(index, j);
+            if (attribute.name == name && accepts(attribute.value))
+                return true;
+        }
+        return false;
+    }
+    case QUANTITY:
+    {
+        int current = inventory.getProductQuantity(index);
+        return current >= quantity && current <= highQuantity;
+    }
+    case AND:
+        for (int i = 0; i < numChildren; i++)
+            if (!children[i].matches(inventory, index))
+                return false;
+        return true;
+    default: // OR
+        for (int i = 0; i < numChildren; i++)
+            if (children[i].matches(inventory, index))
+                return true;
+        return false;
+    }
+}
+
+string Predicate::toString() const
+{
+    StringWriter writer;
+    writeTo(writer);
+    return writer.str();
+}
+
+void Predicate::writeTo(Writer &writer) const
+{
+    switch (type)
+    {
+    case RANGE:
+        writer.write(name);
+        if (low == -numeric_limits<double>::infinity())
+        {
+            writer.write(highInclusive ? " <= " : " < ");
+            writer.writeDouble(high);
+        }
+        else if (high == numeric_limits<double>::infinity())
+        {
+            writer.write(lowInclusive ? " >= " : " > ");
+            writer.writeDouble(low);
+        }
+        else
+        {
+            writer.write(" in ");
+            writer.put(lowInclusive ? '[' : '(');
+            writer.writeDouble(low);
+            writer.write(", ");
+            writer.writeDouble(high);
+            writer.put(highInclusive ? ']' : ')');
+        }
+        break;
+    case QUANTITY:
+        if (quantity != numeric_limits<int>::min())
+        {
+            writer.write("quantity >= ");
+            writer.writeInt(quantity);
+        }
+        if (quantity != numeric_limits<int>::min() && highQuantity != numeric_limits<int>::max())
+            writer.write(" AND ");
+        if (highQuantity != numeric_limits<int>::max())
+        {
+            writer.write("quantity <= ");
+            writer.writeInt(highQuantity);
+        }
+        break;
+    default:
+        writer.put('(');
+        for (int i = 0; i < numChildren; i++)
+        {
+            if (i > 0)
+                writer.write(type == AND ? " AND " : " OR ");
+            children[i].writeTo(writer);
+        }
+        writer.put(')');
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+Predicate Predicate::combine(Kind type, const Predicate &lhs, const Predicate &rhs)
+{
+    // flatten: (a AND b) AND c has the children a, b, c
+    int left = lhs.type == type ? lhs.numChildren : 1;
+    int right = rhs.type == type ? rhs.numChildren : 1;
+    Predicate result(type);
+    result.children = new Predicate[left + right];
+    result.numChildren = left + right;
+    for (int i = 0; i < left; i++)
+        result.children[i] = lhs.type == type ? lhs.children[i] : lhs;
+    for (int i = 0; i < right; i++)
+        result.children[left + i] = rhs.type == type ? rhs.children[i] : rhs;
+    return result;
+}
+
+Predicate Predicate::bound(const string &attribute, double low, bool lowInclusive, double high, bool highInclusive)
+{
+    Predicate predicate(RANGE);
+    predicate.name = attribute;
+    predicate.low = low;
+    predicate.high = high;
+    predicate.lowInclusive = lowInclusive;
+    predicate.highInclusive = highInclusive;
+    return predicate;
+}
+
+// -------------------- QueryEngine Method Definitions --------------------
+QueryEngine::QueryEngine(const InventoryManager &inventory) : inventory(inventory), indexes(nullptr), numIndexes(0) {}
+
+QueryEngine::~QueryEngine()
+{
+    for (int i = 0; i < numIndexes; i++)
+    {
+        delete[] indexes[i]->entries;
+        delete indexes[i];
+    }
+    delete[] indexes;
+}
+
+void QueryEngine::createIndex(const string &attribute)
+{
+    if (findIndex(attribute) != nullptr)
+        return;
+    AttributeIndex **grown = new AttributeIndex *[numIndexes + 1];
+    for (int i = 0; i < numIndexes; i++)
+        grown[i] = indexes[i];
+    AttributeIndex *index = new AttributeIndex();
+    index->attribute = attribute;
+    index->version = -1;
+    index->entries = nullptr;
+    index->size = 0;
+    grown[numIndexes] = index;
+    delete[] indexes;
+    indexes = grown;
+    numIndexes++;
+    build(*index);
+}
+
+bool QueryEngine::dropIndex(const string &attribute)
+{
+    for (int i = 0; i < numIndexes; i++)
+    {
+        if (indexes[i]->attribute == attribute)
+        {
+            delete[] indexes[i]->entries;
+            delete indexes[i];
+            indexes[i] = indexes[numIndexes - 1];
+            numIndexes--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QueryEngine::hasIndex(const string &attribute) const
+{
+    for (int i = 0; i < numIndexes; i++)
+        if (indexes[i]->attribute == attribute)
+            return true;
+    return false;
+}
+
+Bitmap QueryEngine::bitmap(const Predicate &predicate)
+{
+    return evaluate(predicate, 0, nullptr);
+}
+
+RoaringBitmap QueryEngine::rows(const Predicate &predicate)
+{
+    Bitmap matching = evaluate(predicate, 0, nullptr);
+    RoaringBitmap result;
+    matching.forEach([&](int row)
+                     { result.add((uint32_t)row); });
+    return result;
+}
+
+List1D<int> QueryEngine::indices(const Predicate &predicate)
+{
+    Bitmap matching = evaluate(predicate, 0, nullptr);
+    List1D<int> result;
+    matching.forEach([&](int row)
+                     { result.add(row); });
+    return result;
+}
+
+List1D<string> QueryEngine::names(const Predicate &predicate, bool ascending)
+{
+    Bitmap matching = evaluate(predicate, 0, nullptr);
+    List1D<string> result;
+    matching.forEach([&](int row)
+                     { result.add(inventory.getProductName(row)); });
+    if (ascending)
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             { return lhs < rhs; });
+    else
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             { return lhs > rhs; });
+    return result;
+}
+
+long QueryEngine::count(const Predicate &predicate)
+{
+    return evaluate(predicate, 0, nullptr).count();
+}
+
+double QueryEngine::estimate(const Predicate &predicate)
+{
+    int n = inventory.size();
+    if (n == 0)
+        return 0;
+    switch (predicate.type)
+    {
+    case Predicate::RANGE:
+    {
+        AttributeIndex *index = freshIndex(predicate.name);
+        if (index == nullptr)
+            return sampleSelectivity(predicate);
+        int first;
+        double matching = probeRange(*index, predicate, first);
+        return matching >= n ? 1.0 : matching / n;
+    }
+    case Predicate::QUANTITY:
+        return sampleSelectivity(predicate);
+    case Predicate::AND:
+    {
+        // children assumed independent
+        double selectivity = 1;
+        for (int i = 0; i < predicate.numChildren; i++)
+            selectivity *= estimate(predicate.children[i]);
+        return selectivity;
+    }
+    default: // OR
+    {
+        double none = 1;
+        for (int i = 0; i < predicate.numChildren; i++)
+            none *= 1 - estimate(predicate.children[i]);
+        return 1 - none;
+    }
+    }
+}
+
+string QueryEngine::explain(const Predicate &predicate)
+{
+    StringWriter plan(512);
+    evaluate(predicate, 0, &plan);
+    return plan.str();
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+QueryEngine::AttributeIndex *QueryEngine::findIndex(const string &attribute)
+{
+    for (int i = 0; i < numIndexes; i++)
+        if (indexes[i]->attribute == attribute)
+            return indexes[i];
+    return nullptr;
+}
+
+QueryEngine::AttributeIndex *QueryEngine::freshIndex(const string &attribute)
+{
+    AttributeIndex *index = findIndex(attribute);
+    if (index != nullptr && index->version != inventory.structureVersion())
+        build(*index);
+    return index;
+}
+
+void QueryEngine::build(AttributeIndex &index)
+{
+    int n = inventory.size();
+    int size = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int columns = inventory.attributeCount(i);
+        for (int j = 0; j < columns; j++)
+            if (inventory.attributeAt(i, j).name == index.attribute)
+                size++;
+    }
+    delete[] index.entries;
+    index.entries = new Entry[size > 0 ? size : 1];
+    index.size = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int columns = inventory.attributeCount(i);
+        for (int j = 0; j < columns; j++)
+        {
+            const InventoryAttribute &attribute = inventory.attributeAt(i, j);
+            if (attribute.name == index.attribute && attribute.value == attribute.value) // NaN never matches
+            {
+                index.entries[index.size].value = attribute.value;
+                index.entries[index.size].row = i;
+                index.size++;
+            }
+        }
+    }
+    sort(index.entries, index.entries + index.size, [](const Entry &lhs, const Entry &rhs)
+         { return lhs.value < rhs.value; });
+    index.version = inventory.structureVersion();
+}
+
+int QueryEngine::probeRange(AttributeIndex &index, const Predicate &range, int &first) const
+{
+    // entries [first, first + result) are the ones in the range
+    Entry *begin = index.entries, *end = index.entries + index.size;
+    Entry *from = range.lowInclusive
+                      ? lower_bound(begin, end, range.low, [](const Entry &e, double v)
+                                    { return e.value < v; })
+                      : upper_bound(begin, end, range.low, [](double v, const Entry &e)
+                                    { return v < e.value; });
+    Entry *to = range.highInclusive
+                    ? upper_bound(from, end, range.high, [](double v, const Entry &e)
+                                  { return v < e.value; })
+                    : lower_bound(from, end, range.high, [](const Entry &e, double v)
+                                  { return e.value < v; });
+    first = (int)(from - begin);
+    return to > from ? (int)(to - from) : 0;
+}
+
+double QueryEngine::sampleSelectivity(const Predicate &predicate) const
+{
+    // up to 256 products, evenly spaced; a predicate matching none of them still gets half a match
+    int n = inventory.size();
+    int samples = n < 256 ? n : 256;
+    int matching = 0;
+    for (int s = 0; s < samples; s++)
+        if (predicate.matches(inventory, (int)((long)s * n / samples)))
+            matching++;
+    return (matching > 0 ? matching : 0.5) / samples;
+}
+
+double QueryEngine::averageWidth() const
+{
+    int n = inventory.size();
+    int samples = n < 256 ? n : 256;
+    long columns = 0;
+    for (int s = 0; s < samples; s++)
+        columns += inventory.attributeCount((int)((long)s * n / samples));
+    return samples == 0 || columns == 0 ? 1.0 : (double)columns / samples;
+}
+
+double QueryEngine::cost(const Predicate &predicate, double width)
+{
+    // cost of producing the predicate's bitmap, in attribute reads
+    int n = inventory.size();
+    switch (predicate.type)
+    {
+    case Predicate::RANGE:
+        if (findIndex(predicate.name) != nullptr)
+            return log2(n + 1.0) + estimate(predicate) * n + n / 64.0;
+        return n * width;
+    case Predicate::QUANTITY:
+        return n;
+    default:
+    {
+        double total = 0;
+        for (int i = 0; i < predicate.numChildren; i++)
+            total += cost(predicate.children[i], width);
+        return total;
+    }
+    }
+}
+
+Bitmap QueryEngine::evaluate(const Predicate &predicate, int depth, StringWriter *plan)
+{
+    int n = inventory.size();
+    Bitmap result(n);
+    switch (predicate.type)
+    {
+    case Predicate::RANGE:
+    {
+        AttributeIndex *index = freshIndex(predicate.name);
+        if (index != nullptr)
+        {
+            int first;
+            int matching = probeRange(*index, predicate, first);
+            for (int k = first; k < first + matching; k++)
+                result.set(index->entries[k].row);
+            writePlan(plan, depth, "probe", predicate, matching, result.count());
+            return result;
+        }
+        // no index: scan
+    }
+    // fall through
+    case Predicate::QUANTITY:
+        for (int i = 0; i < n; i++)
+            if (predicate.matches(inventory, i))
+                result.set(i);
+        writePlan(plan, depth, "scan", predicate, plan != nullptr ? estimate(predicate) * n : 0, result.count());
+        return result;
+    case Predicate::OR:
+    {
+        StringWriter children;
+        for (int i = 0; i < predicate.numChildren; i++)
+            result |= evaluate(predicate.children[i], depth + 1, plan != nullptr ? &children : nullptr);
+        writePlan(plan, depth, "union", predicate, plan != nullptr ? estimate(predicate) * n : 0, result.count());
+        if (plan != nullptr)
+            plan->write(children.str());
+        return result;
+    }
+    default: // AND
+        break;
+    }
+
+    // AND: most selective child first
+    int m = predicate.numChildren;
+    double *estimates = new double[m];
+    int *order = new int[m];
+    for (int i = 0; i < m; i++)
+    {
+        estimates[i] = estimate(predicate.children[i]);
+        order[i] = i;
+    }
+    stable_sort(order, order + m, [&](int lhs, int rhs)
+                { return estimates[lhs] < estimates[rhs]; });
+
+    StringWriter children;
+    StringWriter *childPlan = plan != nullptr ? &children : nullptr;
+    double width = averageWidth();
+    double expected = n;
+    for (int k = 0; k < m; k++)
+    {
+        const Predicate &child = predicate.children[order[k]];
+        if (k == 0)
+        {
+            result = evaluate(child, depth + 1, childPlan);
+            expected *= estimates[order[k]];
+            continue;
+        }
+        long candidates = result.count();
+        if (candidates == 0)
+            break;
+        double checks = child.type == Predicate::QUANTITY ? 1 : width * (child.type == Predicate::RANGE ? 1 : child.numChildren);
+        if (cost(child, width) < candidates * checks)
+        {
+            result &= evaluate(child, depth + 1, childPlan);
+        }
+        else
+        {
+            filter(result, child);
+            writePlan(childPlan, depth + 1, "filter", child, candidates * estimates[order[k]], result.count());
+        }
+        expected *= estimates[order[k]];
+    }
+    delete[] estimates;
+    delete[] order;
+    writePlan(plan, depth, "intersect", predicate, expected, result.count());
+    if (plan != nullptr)
+        plan->write(children.str());
+    return result;
+}
+
+void QueryEngine::filter(Bitmap &candidates, const Predicate &predicate) const
+{
+    // forEach works on a copy of each word: resetting the visited bits is safe
+    candidates.forEach([&](int row)
+                       {
+        if (!predicate.matches(inventory, row))
+            candidates.reset(row); });
+}
+
+void QueryEngine::writePlan(StringWriter *plan, int depth, const char *access, const Predicate &predicate,
+                            double expected, long actual)
+{
+    // e.g. "  probe weight in [1, 5]: ~120 expected, 118 matching"
+    if (plan == nullptr)
+        return;
+    for (int i = 0; i < depth; i++)
+        plan->write("  ");
+    plan->write(access);
+    plan->put(' ');
+    predicate.writeTo(*plan);
+    plan->write(": ~");
+    plan->writeInt((long long)(expected + 0.5));
+    plan->write(" expected, ");
+    plan->writeInt(actual);
+    plan->write(" matching\n");
+}
+
+#endif /* INVENTORY_QUERY_H */
@@ -0,0 +1,205 @@
+#ifndef INVENTORY_STATS_H
+#define INVENTORY_STATS_H
+
+/*
+ * Instrumentation of InventoryManager, compiled in with -DINVENTORY_STATS.
+ *
+ *  >> INVENTORY_PROBE(OPERATION): at the top of a block, records the block's latency (in a
+ *     LatencyHistogram) and the allocations made by the calling thread while it runs;
+ *  >> INVENTORY_COUNT(COUNTER, n): adds n to an event counter.
+ *
+ * Without INVENTORY_STATS both macros expand to nothing: no code, no data, no allocation hook.
+ * With it, InventoryManager::stats() reports everything recorded by the process so far; the
+ * allocation counts come from AllocCounter, so they stay 0 unless the program links
+ * src/alloc_counter.cpp (see util/AllocCounter.h; bench.sh does).
+ */
+#ifdef INVENTORY_STATS
+
+#include "util/AllocCounter.h"
+#include "util/Histogram.h"
+#include "util/Writer.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+// -------------------- InventoryStats --------------------
+class InventoryStats
+{
+public:
+    enum Operation
+    {
+        QUERY,
+        QUERY_SCAN, // part of QUERY: matching products
+        QUERY_SORT, // part of QUERY: sorting the names
+        QUERY_ROWS,
+        ADD_PRODUCT,
+        REMOVE_PRODUCT,
+        UPDATE_QUANTITY,
+        REMOVE_DUPLICATES,
+        MERGE,
+        SPLIT,
+        AGGREGATE,
+        NUM_OPERATIONS
+    };
+    enum Counter
+    {
+        ATTRIBUTE_COPIES, // attributes copied out of the matrix (getProductAttributes)
+        NAME_COMPARES,    // attribute name comparisons in query
+        SORT_COMPARES,    // product name comparisons in query's sort
+        NUM_COUNTERS
+    };
+
+    class Probe
+    {
+    private:
+        Operation operation;
+        chrono::steady_clock::time_point start;
+        AllocCounter::Scope allocations;
+
+    public:
+        Probe(Operation operation) : operation(operation), start(chrono::steady_clock::now()) {}
+        ~Probe()
+        {
+            long ns = (long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            InventoryStats::global().record(operation, ns, allocations.allocations(), allocations.bytes());
+        }
+    };
+
+private:
+    struct OperationStats
+    {
+        LatencyHistogram latency;
+        atomic<long> allocations;
+        atomic<long> bytes;
+    };
+    OperationStats operations[NUM_OPERATIONS];
+    atomic<long> counters[NUM_COUNTERS];
+
+    InventoryStats() { reset(); }
+
+public:
+    static InventoryStats &global()
+    {
+        static InventoryStats stats;
+        return stats;
+    }
+
+    void record(Operation operation, long ns, long allocations, long bytes)
+    {
+        OperationStats &stats = operations[operation];
+        stats.latency.record(ns < 0 ? 0 : (uint64_t)ns);
+        stats.allocations.fetch_add(allocations, memory_order_relaxed);
+        stats.bytes.fetch_add(bytes, memory_order_relaxed);
+    }
+    void count(Counter counter, long n)
+    {
+        counters[counter].fetch_add(n, memory_order_relaxed);
+    }
+    void reset();
+    string toString() const;
+
+    static const char *name(Operation operation);
+    static const char *name(Counter counter);
+
+private:
+    static void writeColumn(Writer &writer, const string &text);
+};
+
+// -------------------- InventoryStats Method Definitions --------------------
+void InventoryStats::reset()
+{
+    for (int i = 0; i < NUM_OPERATIONS; i++)
+    {
+        operations[i].latency.reset();
+        operations[i].allocations.store(0, memory_order_relaxed);
+        operations[i].bytes.store(0, memory_order_relaxed);
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++)
+        counters[i].store(0, memory_order_relaxed);
+}
+
+string InventoryStats::toString() const
+{
+    /*
+     * One line per operation that ran: calls, latency in ns and allocations per call, then the
+     * non-zero counters. Nested operations are also counted on their own (e.g. removeDuplicates
+     * calls removeProduct).
+     */
+    StringWriter writer(1024);
+    const char *headers[] = {"calls", "mean", "p50", "p90", "p99", "max", "allocs/op", "bytes/op"};
+    writer.write("operation       ");
+    for (int c = 0; c < 8; c++)
+        writeColumn(writer, headers[c]);
+    writer.put('\n');
+    for (int i = 0; i < NUM_OPERATIONS; i++)
+    {
+        const OperationStats &stats = operations[i];
+        long calls = (long)stats.latency.count();
+        if (calls == 0)
+            continue;
+        string label = name((Operation)i);
+        label.resize(16, ' ');
+        writer.write(label);
+        long columns[] = {calls, (long)stats.latency.mean(), (long)stats.latency.percentile(50),
+                          (long)stats.latency.percentile(90), (long)stats.latency.percentile(99),
+                          (long)stats.latency.max(), stats.allocations.load() / calls, stats.bytes.load() / calls};
+        for (int c = 0; c < 8; c++)
+            writeColumn(writer, to_string(columns[c]));
+        writer.put('\n');
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+        long value = counters[i].load(memory_order_relaxed);
+        if (value == 0)
+            continue;
+        writer.write(name((Counter)i));
+        writer.write(": ");
+        writer.writeInt(value);
+        writer.put('\n');
+    }
+    return writer.str();
+}
+
+const char *InventoryStats::name(Operation operation)
+{
+    static const char *names[NUM_OPERATIONS] = {"query", "  query.scan", "  query.sort", "queryRows", "addProduct",
+                                                "removeProduct", "updateQuantity", "removeDuplicates",
+                                                "merge", "split", "aggregate"};
+    return names[operation];
+}
+
+const char *InventoryStats::name(Counter counter)
+{
+    static const char *names[NUM_COUNTERS] = {"query.attributeCopies", "query.nameCompares",
+                                              "query.sortCompares"};
+    return names[counter];
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+void InventoryStats::writeColumn(Writer &writer, const string &text)
+{
+    // right-aligned in 10 characters (at least one space before)
+    int padding = text.size() < 10 ? 10 - (int)text.size() : 1;
+    for (int i = 0; i < padding; i++)
+        writer.put(' ');
+    writer.write(text);
+}
+
+#define INVENTORY_STATS_CONCAT_(a, b) a##b
+#define INVENTORY_STATS_CONCAT(a, b) INVENTORY_STATS_CONCAT_(a, b)
+#define INVENTORY_PROBE(operation) \
+    InventoryStats::Probe INVENTORY_STATS_CONCAT(inventoryProbe, __LINE__)(InventoryStats::operation)
+#define INVENTORY_COUNT(counter, n) InventoryStats::global().count(InventoryStats::counter, (n))
+
+#else
+
+#define INVENTORY_PROBE(operation)
+#define INVENTORY_COUNT(counter, n)
+
+#endif /* INVENTORY_STATS */
+
+#endif /* INVENTORY_STATS_H */
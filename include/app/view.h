@@ -0,0 +1,252 @@
+#ifndef INVENTORY_VIEW_H
+#define INVENTORY_VIEW_H
+
+#include "app/inventory.h"
+#include "app/query.h"
+#include "util/Bitmap.h"
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+class MaterializedView;
+
+// -------------------- ViewListener --------------------
+/*
+ * ViewListener: told how the members of a MaterializedView change (see addListener), so consumers
+ * can react without polling. The view is already up to date, except in productLeaving: called
+ * BEFORE a member is removed from the inventory, "index" can still be read.
+ *  >> productEntered(view, index): product "index" now matches (added, or its quantity changed)
+ *  >> productLeaving(view, index): product "index" is about to stop matching, or to be removed
+ *  >> memberUpdated(view, index, oldQuantity): a member's quantity changed, and it still matches
+ *  >> viewReset(view): the inventory was replaced (assigned); the view was recomputed
+ * All do nothing by default.
+ */
+class ViewListener
+{
+public:
+    virtual ~ViewListener() {}
+    virtual void productEntered(const MaterializedView &view, int index) {}
+    virtual void productLeaving(const MaterializedView &view, int index) {}
+    virtual void memberUpdated(const MaterializedView &view, int index, int oldQuantity) {}
+    virtual void viewReset(const MaterializedView &view) {}
+};
+
+// -------------------- MaterializedView --------------------
+/*
+ * MaterializedView: the products of an InventoryManager matching a standing Predicate, kept up to
+ * date as the inventory changes, so reading it costs nothing: count() and contains(index) are O(1).
+ *
+ * The view observes its inventory (see InventoryObserver); each change is applied incrementally:
+ *  >> addProduct: the predicate is checked on the new product only;
+ *  >> updateQuantity / adjustQuantity / tryReserve: checked again on that product, and only when the
+ *     predicate has a quantity condition;
+ *  >> removeProduct: the product's bit is erased and the later ones move down with the rows
+ *     (O(n / 64) word shifts, well below the O(n) of removeProduct itself).
+ * The members are one bit per product.
+ *
+ * The inventory must outlive the view. Not thread-safe (see InventoryManager::addObserver).
+ *
+ * Example:
+ *  MaterializedView lowStock(inventory, Predicate::below("weight", 5) && Predicate::quantityAtMost(10));
+ *  lowStock.addListener(&dashboard); // a ViewListener
+ *  cout << lowStock.count() << " light products are low on stock" << endl;
+ */
+class MaterializedView : public InventoryObserver
+{
+private:
+    InventoryManager &inventory;
+    Predicate predicate;
+    bool quantityDependent; // predicate has a quantity condition
+    Bitmap members;         // one bit per product of the inventory
+    long numMembers;
+    ViewListener **listeners; // not owned
+    int numListeners;
+
+public:
+    MaterializedView(InventoryManager &inventory, const Predicate &predicate);
+    ~MaterializedView();
+
+    const Predicate &getPredicate() const { return predicate; }
+    long count() const { return numMembers; }
+    bool contains(int index) const;
+
+    /* forEach(f): f(index) for every member, in increasing index order
+     * indices(): the members' indices, in increasing order
+     * names(ascending): the members' names, sorted like InventoryManager::query's
+     */
+    template <class Function>
+    void forEach(Function f) const { members.forEach(f); }
+    List1D<int> indices() const;
+    List1D<string> names(bool ascending = true) const;
+
+    void addListener(ViewListener *listener);
+    bool removeListener(ViewListener *listener);
+
+    // InventoryObserver
+    void productAdded(const InventoryManager &inventory, int index);
+    void productRemoving(const InventoryManager &inventory, int index);
+    void quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity);
+    void inventoryReplaced(const InventoryManager &inventory);
+
+private:
+    MaterializedView(const MaterializedView &);            // not copyable
+    MaterializedView &operator=(const MaterializedView &); // not copyable
+
+    static bool dependsOnQuantity(const Predicate &predicate);
+    void recompute();
+};
+
+// -------------------- MaterializedView Method Definitions --------------------
+MaterializedView::MaterializedView(InventoryManager &inventory, const Predicate &predicate)
+    : inventory(inventory), predicate(predicate), quantityDependent(dependsOnQuantity(predicate)), numMembers(0),
+      listeners(nullptr), numListeners(0)
+{
+    recompute();
+    inventory.addObserver(this);
+}
+
+MaterializedView::~MaterializedView()
+{
+    inventory.removeObserver(this);
+    delete[] listeners;
+}
+
+bool MaterializedView::contains(int index) const
+{
+    if (index < 0 || index >= members.size())
+        throw out_of_range("Product index is out of range!");
+    return members.test(index);
+}
+
+List1D<int> MaterializedView::indices() const
+{
+    List1D<int> result;
+    members.forEach([&](int index)
+                    { result.add(index); });
+    return result;
+}
+
+List1D<string> MaterializedView::names(bool ascending) const
+{
+    List1D<string> result;
+    members.forEach([&](int index)
+                    { result.add(inventory.getProductName(index)); });
+    if (ascending)
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             { return lhs < rhs; });
+    else
+        sort(result.begin(), result.end(), [](const string &lhs, const string &rhs)
+             { return lhs > rhs; });
+    return result;
+}
+
+void MaterializedView::addListener(ViewListener *listener)
+{
+    ViewListener **grown = new ViewListener *[numListeners + 1];
+    for (int i = 0; i < numListeners; i++)
+        grown[i] = listeners[i];
+    grown[numListeners++] = listener;
+    delete[] listeners;
+    listeners = grown;
+}
+
+bool MaterializedView::removeListener(ViewListener *listener)
+{
+    for (int i = 0; i < numListeners; i++)
+    {
+        if (listeners[i] == listener)
+        {
+            for (int j = i + 1; j < numListeners; j++)
+                listeners[j - 1] = listeners[j];
+            numListeners--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MaterializedView::productAdded(const InventoryManager &inventory, int index)
+{
+    members.resize(index + 1);
+    if (!predicate.matches(inventory, index))
+        return;
+    members.set(index);
+    numMembers++;
+    for (int i = 0; i < numListeners; i++)
+        listeners[i]->productEntered(*this, index);
+}
+
+void MaterializedView::productRemoving(const InventoryManager &inventory, int index)
+{
+    if (members.test(index))
+    {
+        for (int i = 0; i < numListeners; i++)
+            listeners[i]->productLeaving(*this, index);
+        numMembers--;
+    }
+    members.erase(index);
+}
+
+void MaterializedView::quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity)
+{
+    bool member = members.test(index);
+    bool matches = quantityDependent ? predicate.matches(inventory, index) : member;
+    if (matches && !member)
+    {
+        members.set(index);
+        numMembers++;
+        for (int i = 0; i < numListeners; i++)
+            listeners[i]->productEntered(*this, index);
+    }
+    else if (!matches && member)
+    {
+        for (int i = 0; i < numListeners; i++)
+            listeners[i]->productLeaving(*this, index);
+        members.reset(index);
+        numMembers--;
+    }
+    else if (member)
+    {
+        for (int i = 0; i < numListeners; i++)
+            listeners[i]->memberUpdated(*this, index, oldQuantity);
+    }
+}
+
+void MaterializedView::inventoryReplaced(const InventoryManager &inventory)
+{
+    recompute();
+    for (int i = 0; i < numListeners; i++)
+        listeners[i]->viewReset(*this);
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+bool MaterializedView::dependsOnQuantity(const Predicate &predicate)
+{
+    if (predicate.kind() == Predicate::QUANTITY)
+        return true;
+    for (int i = 0; i < predicate.size(); i++)
+        if (dependsOnQuantity(predicate.child(i)))
+            return true;
+    return false;
+}
+
+void MaterializedView::recompute()
+{
+    int n = inventory.size();
+    members.resize(0);
+    members.resize(n);
+    numMembers = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (predicate.matches(inventory, i))
+        {
+            members.set(i);
+            numMembers++;
+        }
+    }
+}
+
+#endif /* INVENTORY_VIEW_H */
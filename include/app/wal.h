@@ -0,0 +1,770 @@
+#ifndef INVENTORY_WAL_H
+#define INVENTORY_WAL_H
+
+#include "app/inventory.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <mutex>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// -------------------- InventoryLog --------------------
+/*
+ * InventoryLog: an append-only write-ahead log of InventoryManager mutations, plus snapshots.
+ *
+ *  >> every updateQuantity / addProduct / removeProduct is encoded as one record
+ *     (varints, CRC32-checked) and appended to an in-memory group;
+ *  >> the group is written and fdatasync'd when it holds groupSize records, or when its oldest
+ *     record is older than syncIntervalMs, or on sync(); the age is checked when a record is
+ *     appended and by a flusher thread that wakes every syncIntervalMs, so the last records of a
+ *     burst are synced without waiting for the next mutation;
+ *  >> once the log grows past checkpointBytes, a snapshot of the whole inventory is written
+ *     (to a temporary file, then renamed) and the log is truncated.
+ *
+ * Every record carries a log sequence number (LSN) and the snapshot stores the LSN it includes,
+ * so records already in the snapshot are skipped when a crash happens between the two steps of
+ * a checkpoint. A torn record at the end of the log (crash during a write) is discarded.
+ * When a write or fdatasync fails inside logAdd / logRemove / logUpdate, the record being logged
+ * is dropped (the caller does not apply the mutation) and the exception is rethrown; the records
+ * logged before it stay pending and are written by the next sync.
+ * The records between beginBatch and commitBatch are encoded as one BATCH record (one LSN per
+ * mutation, one checksum for all of them): recovery replays all of them or none, and abortBatch,
+ * or a sync failure in commitBatch, drops all of them.
+ * The public methods lock the log, so the flusher thread can run next to the mutating thread.
+ *
+ * Example:
+ *  InventoryManager inventory;
+ *  InventoryLog::recover("inv.snap", "inv.wal", inventory); // snapshot + replay
+ *  InventoryLog log("inv.snap", "inv.wal");
+ *  inventory.setJournal(&log);
+ *  inventory.updateQuantity(0, 10);   // durable after the next group commit, or after:
+ *  log.sync();
+ */
+class InventoryLog : public InventoryJournal
+{
+private:
+    enum RecordType
+    {
+        ADD = 1,
+        REMOVE = 2,
+        UPDATE = 3,
+        BATCH = 4 // [count (4 bytes)], then "count" records without header nor LSN
+    };
+
+    string snapshotPath;
+    string logPath;
+    int fd;
+    int groupSize;
+    int syncIntervalMs;
+    long checkpointBytes;
+
+    string pending;   // encoded records not written yet
+    int pendingCount; // number of records in pending
+    chrono::steady_clock::time_point pendingSince;
+    long long lsn;        // LSN of the last record appended
+    long long durableLsn; // LSN of the last record synced
+    long logBytes;        // size of the log file after the last sync
+    size_t batchStart;    // offset of the open BATCH record in pending (string::npos: no batch)
+    int batchRecords;     // number of records in the open batch
+
+    mutable mutex lock; // guards everything above (the flusher thread also syncs)
+    condition_variable wakeup;
+    bool stopping;
+    thread flusher; // runs flushLoop while syncIntervalMs > 0
+
+public:
+    /* InventoryLog(snapshotPath, logPath, groupSize, syncIntervalMs, checkpointBytes)
+     *  >> groupSize:       number of records per group commit (1: sync every mutation)
+     *  >> syncIntervalMs:  maximum age of a pending record (0: sync every mutation, like groupSize 1)
+     *  >> checkpointBytes: log size that triggers a checkpoint (0: only explicit checkpoint())
+     * Records already in the log are kept; call recover() first to load them.
+     */
+    InventoryLog(const string &snapshotPath, const string &logPath,
+                 int groupSize = 64, int syncIntervalMs = 5, long checkpointBytes = 64L << 20);
+    ~InventoryLog();
+
+    // Inherit from InventoryJournal: BEGIN
+    void logAdd(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    void logRemove(int index);
+    void logUpdate(int index, int newQuantity);
+    void applied(const InventoryManager &inventory);
+    void replaced(const InventoryManager &inventory); // checkpoints the new state
+    void beginBatch();
+    void commitBatch();
+    void abortBatch();
+    // Inherit from InventoryJournal: END
+
+    /* sync(): write and fdatasync every pending record
+     */
+    void sync();
+
+    /* checkpoint(inventory): snapshot "inventory" (which must contain every logged mutation),
+     *   then truncate the log
+     *   >> throw std::logic_error if a batch is open
+     */
+    void checkpoint(const InventoryManager &inventory);
+
+    long long lastLsn() const;
+    long long lastDurableLsn() const;
+    long size() const;
+
+    /* recover(snapshotPath, logPath, inventory): load the snapshot (if any) into "inventory",
+     *   which should be empty, and replay the log records that follow it.
+     *
+     * return:
+     *  >> the number of log records replayed
+     *  >> throw std::runtime_error if the snapshot is corrupted
+     */
+    static long recover(const string &snapshotPath, const string &logPath, InventoryManager &inventory);
+
+    /* saveSnapshot(inventory, path, lsn): write "inventory" to "path" atomically (temporary file + rename)
+     */
+    static void saveSnapshot(const InventoryManager &inventory, const string &path, long long lsn);
+
+private:
+    InventoryLog(const InventoryLog &log) = delete;
+    InventoryLog &operator=(const InventoryLog &log) = delete;
+
+    // called with "lock" held
+    size_t beginRecord(char type);
+    void endRecord(size_t start);
+    void commitRecord(size_t start, int records);
+    void syncLocked();
+    void flushLoop();
+    static long long snapshotLsn(const string &path);
+    static long long scanLog(const string &path, long long afterLsn, InventoryManager *inventory, long *replayed);
+    static long apply(const char *p, const char *end, InventoryManager &inventory);
+    static void applyOne(const char *&p, const char *end, InventoryManager &inventory);
+
+    static void putVarint(string &out, uint64_t value);
+    static bool getVarint(const char *&p, const char *end, uint64_t &value);
+    static uint64_t zigzag(long long value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+    static long long unzigzag(uint64_t value) { return (long long)(value >> 1) ^ -(long long)(value & 1); }
+    static void putProduct(string &out, const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    static bool getProduct(const char *&p, const char *end, List1D<InventoryAttribute> &attributes, string &name, int &quantity);
+    static void putUint32(char *out, uint32_t value);
+    static uint32_t getUint32(const char *in);
+    static uint32_t crc32(const char *data, size_t size, uint32_t crc = 0);
+    static void writeAll(int fd, const char *data, size_t size, const string &path);
+};
+
+// -------------------- InventoryLog Method Definitions --------------------
+InventoryLog::InventoryLog(const string &snapshotPath, const string &logPath,
+                           int groupSize, int syncIntervalMs, long checkpointBytes)
+    : snapshotPath(snapshotPath), logPath(logPath), groupSize(groupSize < 1 ? 1 : groupSize),
+      syncIntervalMs(syncIntervalMs), checkpointBytes(checkpointBytes), pendingCount(0),
+      batchStart(string::npos), batchRecords(0), stopping(false)
+{
+    long long last = snapshotLsn(snapshotPath);
+    long long logged = scanLog(logPath, last, nullptr, nullptr); // also drops a torn tail
+    lsn = durableLsn = (logged > last) ? logged : last;
+
+    fd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+        throw runtime_error("Cannot open " + logPath + ": " + strerror(errno));
+    struct stat st;
+    fstat(fd, &st);
+    logBytes = (long)st.st_size;
+    if (syncIntervalMs > 0)
+        flusher = thread(&InventoryLog::flushLoop, this);
+}
+
+InventoryLog::~InventoryLog()
+{
+    if (flusher.joinable())
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wakeup.notify_one();
+        flusher.join();
+    }
+    try
+    {
+        sync();
+    }
+    catch (...)
+    {
+    }
+    close(fd);
+}
+
+void InventoryLog::logAdd(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    lock_guard<mutex> guard(lock);
+    size_t start = beginRecord(ADD);
+    putProduct(pending, attributes, name, quantity);
+    endRecord(start);
+}
+
+void InventoryLog::logRemove(int index)
+{
+    lock_guard<mutex> guard(lock);
+    size_t start = beginRecord(REMOVE);
+    putVarint(pending, (uint64_t)index);
+    endRecord(start);
+}
+
+void InventoryLog::logUpdate(int index, int newQuantity)
+{
+    lock_guard<mutex> guard(lock);
+    size_t start = beginRecord(UPDATE);
+    putVarint(pending, (uint64_t)index);
+    putVarint(pending, zigzag(newQuantity));
+    endRecord(start);
+}
+
+void InventoryLog::applied(const InventoryManager &inventory)
+{
+    if (checkpointBytes > 0 && size() >= checkpointBytes)
+        checkpoint(inventory);
+}
+
+void InventoryLog::replaced(const InventoryManager &inventory)
+{
+    checkpoint(inventory);
+}
+
+void InventoryLog::beginBatch()
+{
+    lock_guard<mutex> guard(lock);
+    if (batchStart != string::npos)
+        throw logic_error("A batch is already open!");
+    batchStart = beginRecord(BATCH);
+    pending.append(4, '\0'); // record count, filled in by commitBatch
+}
+
+void InventoryLog::commitBatch()
+{
+    lock_guard<mutex> guard(lock);
+    if (batchStart == string::npos)
+        return;
+    size_t start = batchStart;
+    int records = batchRecords;
+    batchStart = string::npos;
+    batchRecords = 0;
+    if (records == 0)
+    {
+        pending.resize(start);
+        return;
+    }
+    const char *p = pending.data() + start + 8;
+    uint64_t firstLsn;
+    getVarint(p, pending.data() + pending.size(), firstLsn); // skip the LSN, then the type
+    putUint32(&pending[p + 1 - pending.data()], (uint32_t)records);
+    commitRecord(start, records);
+}
+
+void InventoryLog::abortBatch()
+{
+    lock_guard<mutex> guard(lock);
+    if (batchStart == string::npos)
+        return;
+    pending.resize(batchStart);
+    lsn -= batchRecords;
+    batchStart = string::npos;
+    batchRecords = 0;
+}
+
+void InventoryLog::sync()
+{
+    lock_guard<mutex> guard(lock);
+    syncLocked();
+}
+
+long long InventoryLog::lastLsn() const
+{
+    lock_guard<mutex> guard(lock);
+    return lsn;
+}
+
+long long InventoryLog::lastDurableLsn() const
+{
+    lock_guard<mutex> guard(lock);
+    return durableLsn;
+}
+
+long InventoryLog::size() const
+{
+    lock_guard<mutex> guard(lock);
+    return logBytes + (long)pending.size();
+}
+
+void InventoryLog::checkpoint(const InventoryManager &inventory)
+{
+    lock_guard<mutex> guard(lock);
+    if (batchStart != string::npos)
+        throw logic_error("Cannot checkpoint inside a batch!");
+    syncLocked();
+    saveSnapshot(inventory, snapshotPath, lsn);
+    if (ftruncate(fd, 0) != 0 || fdatasync(fd) != 0)
+        throw runtime_error("Cannot truncate " + logPath + ": " + strerror(errno));
+    logBytes = 0;
+}
+
+long InventoryLog::recover(const string &snapshotPath, const string &logPath, InventoryManager &inventory)
+{
+    InventoryJournal *journal = inventory.getJournal();
+    inventory.setJournal(nullptr); // replayed mutations must not be logged again
+
+    long long last = -1;
+    int fd = open(snapshotPath.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        string data;
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+            data.append(chunk, n);
+        close(fd);
+
+        const char *p = data.data();
+        const char *end = p + data.size();
+        if (data.size() < 24 || memcmp(p, "INVSNAP1", 8) != 0 ||
+            crc32(p + 8, data.size() - 12) != getUint32(end - 4))
+            throw runtime_error("Corrupted snapshot " + snapshotPath);
+        uint64_t value;
+        p += 8;
+        memcpy(&value, p, 8);
+        last = (long long)value;
+        p += 8;
+        uint32_t count = getUint32(p);
+        p += 4;
+        List1D<InventoryAttribute> attributes;
+        string name;
+        int quantity;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!getProduct(p, end - 4, attributes, name, quantity))
+                throw runtime_error("Corrupted snapshot " + snapshotPath);
+            inventory.addProduct(attributes, name, quantity);
+        }
+    }
+
+    long replayed = 0;
+    scanLog(logPath, last, &inventory, &replayed);
+    inventory.setJournal(journal);
+    return replayed;
+}
+
+void InventoryLog::saveSnapshot(const InventoryManager &inventory, const string &path, long long lsn)
+{
+    string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw runtime_error("Cannot create " + tmpPath + ": " + strerror(errno));
+
+    string block;
+    block.append("INVSNAP1", 8);
+    uint64_t value = (uint64_t)lsn;
+    block.append((const char *)&value, 8);
+    char word[4];
+    putUint32(word, (uint32_t)inventory.size());
+    block.append(word, 4);
+    uint32_t crc = 0;
+    size_t unchecked = 8; // the checksum covers everything after the magic
+    try
+    {
+        for (int i = 0; i < inventory.size(); i++)
+        {
+            putProduct(block, inventory.getProductAttributes(i), inventory.getProductName(i),
+                       inventory.getProductQuantity(i));
+            if (block.size() >= (1 << 16))
+            {
+                crc = crc32(block.data() + unchecked, block.size() - unchecked, crc);
+                writeAll(fd, block.data(), block.size(), tmpPath);
+                block.clear();
+                unchecked = 0;
+            }
+        }
+        crc = crc32(block.data() + unchecked, block.size() - unchecked, crc);
+        putUint32(word, crc);
+        block.append(word, 4);
+        writeAll(fd, block.data(), block.size(), tmpPath);
+        if (fsync(fd) != 0)
+            throw runtime_error("Cannot sync " + tmpPath + ": " + strerror(errno));
+    }
+    catch (...)
+    {
+        close(fd);
+        unlink(tmpPath.c_str());
+        throw;
+    }
+    close(fd);
+
+    if (rename(tmpPath.c_str(), path.c_str()) != 0)
+        throw runtime_error("Cannot rename " + tmpPath + ": " + strerror(errno));
+    // make the rename itself durable
+    size_t slash = path.find_last_of('/');
+    string dir = (slash == string::npos) ? "." : path.substr(0, slash + 1);
+    int dirFd = open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+size_t InventoryLog::beginRecord(char type)
+{
+    /*
+     * Records are encoded directly into the pending group as
+     *      [payload length][crc32 of payload][payload: LSN, type, fields]
+     * beginRecord reserves the header and writes LSN and type; endRecord fills in the header.
+     * Inside a batch, a record is only [type, fields], appended to the payload of the BATCH record.
+     */
+    size_t start = pending.size();
+    if (batchStart == string::npos)
+    {
+        pending.append(8, '\0');
+        putVarint(pending, (uint64_t)(lsn + 1));
+    }
+    pending.push_back(type);
+    return start;
+}
+
+void InventoryLog::endRecord(size_t start)
+{
+    lsn++;
+    if (batchStart != string::npos)
+        batchRecords++; // completed by commitBatch
+    else
+        commitRecord(start, 1);
+}
+
+void InventoryLog::commitRecord(size_t start, int records)
+{
+    /*
+     * Fills in the header of the record started at "start" (which holds "records" mutations),
+     * then commits the group when it is full or too old.
+     */
+    char *header = &pending[start];
+    size_t length = pending.size() - start - 8;
+    putUint32(header, (uint32_t)length);
+    putUint32(header + 4, crc32(header + 8, length));
+    if (pendingCount == 0)
+        pendingSince = chrono::steady_clock::now();
+    pendingCount += records;
+
+    if (pendingCount >= groupSize ||
+        chrono::steady_clock::now() - pendingSince >= chrono::milliseconds(syncIntervalMs))
+    {
+        try
+        {
+            syncLocked();
+        }
+        catch (...)
+        {
+            // the caller will not apply these mutations: they must not reach the log later
+            pending.resize(start);
+            pendingCount -= records;
+            lsn -= records;
+            throw;
+        }
+    }
+}
+
+void InventoryLog::syncLocked()
+{
+    /*
+     * Writes the complete records of the group; an open batch stays pending.
+     */
+    if (pendingCount == 0)
+        return;
+    size_t complete = (batchStart == string::npos) ? pending.size() : batchStart;
+    try
+    {
+        writeAll(fd, pending.data(), complete, logPath);
+        if (fdatasync(fd) != 0)
+            throw runtime_error("Cannot sync " + logPath + ": " + strerror(errno));
+    }
+    catch (...)
+    {
+        // drop what a failed write left behind: the group is written again, whole, next time
+        // (best effort: the original error is the one reported)
+        int ignored = ftruncate(fd, (off_t)logBytes);
+        (void)ignored;
+        throw;
+    }
+    logBytes += (long)complete;
+    pending.erase(0, complete);
+    if (batchStart != string::npos)
+        batchStart = 0;
+    pendingCount = 0;
+    durableLsn = lsn - batchRecords;
+}
+
+void InventoryLog::flushLoop()
+{
+    /*
+     * Syncs the pending group once its oldest record is syncIntervalMs old, even when no other
+     * record is appended. A failure is left for the next append or sync() to report.
+     */
+    unique_lock<mutex> guard(lock);
+    while (!stopping)
+    {
+        wakeup.wait_for(guard, chrono::milliseconds(syncIntervalMs));
+        if (stopping || pendingCount == 0 ||
+            chrono::steady_clock::now() - pendingSince < chrono::milliseconds(syncIntervalMs))
+            continue;
+        try
+        {
+            syncLocked();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+long long InventoryLog::snapshotLsn(const string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+    char header[16];
+    ssize_t n = read(fd, header, 16);
+    close(fd);
+    if (n != 16 || memcmp(header, "INVSNAP1", 8) != 0)
+        return -1;
+    uint64_t value;
+    memcpy(&value, header + 8, 8);
+    return (long long)value;
+}
+
+long long InventoryLog::scanLog(const string &path, long long afterLsn, InventoryManager *inventory, long *replayed)
+{
+    /*
+     * Reads the log record by record. Records with LSN <= afterLsn are skipped; the others are
+     * applied to "inventory" (if not NULL). Reading stops at the first incomplete or corrupted
+     * record, and the file is truncated there. Returns the LSN of the last valid record (-1 if none).
+     * A BATCH record holds the LSNs from its own up to its own + count - 1.
+     */
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0)
+        return -1;
+    string data;
+    char chunk[1 << 16];
+    ssize_t n;
+    while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+        data.append(chunk, n);
+
+    long long last = -1;
+    size_t offset = 0;
+    while (offset + 8 <= data.size())
+    {
+        const char *header = data.data() + offset;
+        uint32_t length = getUint32(header);
+        if (length > data.size() - offset - 8 || crc32(header + 8, length) != getUint32(header + 4))
+            break; // torn or corrupted: everything after it is lost
+        const char *p = header + 8;
+        const char *end = p + length;
+        uint64_t recordLsn;
+        if (!getVarint(p, end, recordLsn))
+            break;
+        if (p < end && *p == BATCH && end - p < 5)
+            break;
+        long long lastOfRecord = (long long)recordLsn;
+        if (p < end && *p == BATCH)
+            lastOfRecord += (long long)getUint32(p + 1) - 1;
+        if ((long long)recordLsn > afterLsn && inventory != nullptr)
+        {
+            long applied = apply(p, end, *inventory);
+            if (replayed != nullptr)
+                *replayed += applied;
+        }
+        last = lastOfRecord;
+        offset += 8 + length;
+    }
+    if (offset < data.size())
+    {
+        if (ftruncate(fd, (off_t)offset) != 0)
+        {
+            close(fd);
+            throw runtime_error("Cannot truncate " + path + ": " + strerror(errno));
+        }
+    }
+    close(fd);
+    return last;
+}
+
+long InventoryLog::apply(const char *p, const char *end, InventoryManager &inventory)
+{
+    /*
+     * Applies the record payload [p, end) (after its LSN); returns the number of mutations applied.
+     */
+    if (p < end && *p == BATCH)
+    {
+        uint32_t count = getUint32(p + 1);
+        p += 5;
+        for (uint32_t i = 0; i < count; i++)
+            applyOne(p, end, inventory);
+        return count;
+    }
+    applyOne(p, end, inventory);
+    return 1;
+}
+
+void InventoryLog::applyOne(const char *&p, const char *end, InventoryManager &inventory)
+{
+    if (p >= end)
+        throw runtime_error("Corrupted log record");
+    char type = *p++;
+    uint64_t index, value;
+    if (type == ADD)
+    {
+        List1D<InventoryAttribute> attributes;
+        string name;
+        int quantity;
+        if (!getProduct(p, end, attributes, name, quantity))
+            throw runtime_error("Corrupted log record");
+        inventory.addProduct(attributes, name, quantity);
+    }
+    else if (type == REMOVE)
+    {
+        if (!getVarint(p, end, index))
+            throw runtime_error("Corrupted log record");
+        inventory.removeProduct((int)index);
+    }
+    else if (type == UPDATE)
+    {
+        if (!getVarint(p, end, index) || !getVarint(p, end, value))
+            throw runtime_error("Corrupted log record");
+        inventory.updateQuantity((int)index, (int)unzigzag(value));
+    }
+    else
+    {
+        throw runtime_error("Unknown log record type");
+    }
+}
+
+void InventoryLog::putVarint(string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+bool InventoryLog::getVarint(const char *&p, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = (unsigned char)*p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+void InventoryLog::putProduct(string &out, const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    putVarint(out, zigzag(quantity));
+    putVarint(out, name.size());
+    out.append(name);
+    putVarint(out, (uint64_t)attributes.size());
+    for (int i = 0; i < attributes.size(); i++)
+    {
+        InventoryAttribute attr = attributes.get(i);
+        putVarint(out, attr.name.size());
+        out.append(attr.name);
+        out.append((const char *)&attr.value, sizeof(double));
+    }
+}
+
+bool InventoryLog::getProduct(const char *&p, const char *end, List1D<InventoryAttribute> &attributes, string &name, int &quantity)
+{
+    uint64_t value, length, count;
+    if (!getVarint(p, end, value) || !getVarint(p, end, length) || length > (uint64_t)(end - p))
+        return false;
+    quantity = (int)unzigzag(value);
+    name.assign(p, length);
+    p += length;
+    if (!getVarint(p, end, count))
+        return false;
+    attributes.clear();
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (!getVarint(p, end, length) || length + sizeof(double) > (uint64_t)(end - p))
+            return false;
+        InventoryAttribute attr;
+        attr.name.assign(p, length);
+        p += length;
+        memcpy(&attr.value, p, sizeof(double));
+        p += sizeof(double);
+        attributes.add(attr);
+    }
+    return true;
+}
+
+void InventoryLog::putUint32(char *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = (char)(value >> (8 * i));
+}
+
+uint32_t InventoryLog::getUint32(const char *in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= (uint32_t)(unsigned char)in[i] << (8 * i);
+    return value;
+}
+
+uint32_t InventoryLog::crc32(const char *data, size_t size, uint32_t crc)
+{
+    struct Table
+    {
+        uint32_t entry[256];
+        Table()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entry[i] = c;
+            }
+        }
+    };
+    static const Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table.entry[(crc ^ (unsigned char)data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+void InventoryLog::writeAll(int fd, const char *data, size_t size, const string &path)
+{
+    while (size > 0)
+    {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw runtime_error("Cannot write " + path + ": " + strerror(errno));
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+}
+
+#endif /* INVENTORY_WAL_H */
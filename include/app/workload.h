@@ -0,0 +1,742 @@
+#ifndef INVENTORY_WORKLOAD_H
+#define INVENTORY_WORKLOAD_H
+
+#include "app/inventory.h"
+#include "app/importer.h" // InventoryImporter::parseDouble / parseInt
+#include "util/Random.h"
+#include "util/Writer.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+// -------------------- WorkloadOperation --------------------
+struct WorkloadOperation
+{
+    enum Type
+    {
+        QUERY = 'Q',
+        UPDATE = 'U',
+        ADD = 'A',
+        REMOVE = 'R'
+    };
+
+    Type type;
+    int index;            // UPDATE, REMOVE: product index
+    int quantity;         // UPDATE, ADD: new quantity; QUERY: minQuantity
+    string name;          // ADD: product name; QUERY: attribute name
+    double minValue;      // QUERY
+    double maxValue;      // QUERY
+    bool ascending;       // QUERY
+    int attributeStart;   // ADD: the product's attributes, in the workload's attribute pool
+    int attributeCount;
+
+    WorkloadOperation() : type(QUERY), index(0), quantity(0), minValue(0), maxValue(0), ascending(true),
+                          attributeStart(0), attributeCount(0) {}
+};
+
+inline bool operator==(const WorkloadOperation &lhs, const WorkloadOperation &rhs)
+{
+    return lhs.type == rhs.type && lhs.index == rhs.index && lhs.quantity == rhs.quantity &&
+           lhs.name == rhs.name && lhs.minValue == rhs.minValue && lhs.maxValue == rhs.maxValue &&
+           lhs.ascending == rhs.ascending && lhs.attributeStart == rhs.attributeStart &&
+           lhs.attributeCount == rhs.attributeCount;
+}
+
+// e.g. "Q(weight, 10, 20, 0, 1)", "U(3, 40)", "A(Product 7, 12, 2 attributes)", "R(3)"
+inline ostream &operator<<(ostream &os, const WorkloadOperation &operation)
+{
+    os << (char)operation.type << "(";
+    switch (operation.type)
+    {
+    case WorkloadOperation::QUERY:
+        os << operation.name << ", " << operation.minValue << ", " << operation.maxValue << ", "
+           << operation.quantity << ", " << operation.ascending;
+        break;
+    case WorkloadOperation::UPDATE:
+        os << operation.index << ", " << operation.quantity;
+        break;
+    case WorkloadOperation::ADD:
+        os << operation.name << ", " << operation.quantity << ", " << operation.attributeCount << " attributes";
+        break;
+    case WorkloadOperation::REMOVE:
+        os << operation.index;
+        break;
+    }
+    return os << ")";
+}
+
+// -------------------- WorkloadResult --------------------
+/*
+ * WorkloadResult: what a replay did. Two backends given the same inventory and the same
+ * workload must produce the same result (checksum covers every query answer).
+ */
+struct WorkloadResult
+{
+    long queries;
+    long updates;
+    long adds;
+    long removes;
+    long rowsReturned; // total size of the query answers
+    uint64_t checksum;
+
+    WorkloadResult() : queries(0), updates(0), adds(0), removes(0), rowsReturned(0), checksum(0) {}
+    string toString() const;
+};
+
+// -------------------- Workload --------------------
+/*
+ * Workload: a recorded sequence of inventory operations (a trace).
+ *
+ *  >> query / updateQuantity / addProduct / removeProduct append an operation, with the same
+ *     arguments as the InventoryManager method of the same name;
+ *  >> replay(backend) runs the operations, in order, against any class with those four methods
+ *     (InventoryManager, ConcurrentInventory, ...);
+ *  >> save / load store a trace in a text file, one operation per line (tab-separated, doubles
+ *     written with 17 significant digits so they read back exactly):
+ *        Q <attribute> <minValue> <maxValue> <minQuantity> <ascending 0|1>
+ *        U <index> <quantity>
+ *        A <name> <quantity> [<attribute> <value>]...
+ *        R <index>
+ *
+ * Example:
+ *  Workload trace = Workload::load("orders.trace");
+ *  InventoryManager inventory = ...;
+ *  WorkloadResult result = trace.replay(inventory);
+ */
+class Workload
+{
+private:
+    XArrayList<WorkloadOperation> *operations;
+    XArrayList<InventoryAttribute> *attributes; // attributes of all ADD operations, back to back
+
+public:
+    Workload();
+    Workload(const Workload &other);
+    Workload &operator=(const Workload &other);
+    ~Workload();
+
+    int size() const;
+    const WorkloadOperation &get(int index) const;
+    List1D<InventoryAttribute> getAttributes(int index) const; // of an ADD operation
+    long count(WorkloadOperation::Type type) const;
+
+    void query(const string &attributeName, double minValue, double maxValue, int minQuantity, bool ascending);
+    void updateQuantity(int index, int newQuantity);
+    void addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity);
+    void removeProduct(int index);
+    void clear();
+
+    /* replay(backend): run every operation against "backend", in order
+     *
+     * return:
+     *  >> the number of operations of each type, and a checksum of the query answers
+     *  >> exceptions thrown by the backend are not caught (e.g. out_of_range when the trace
+     *     removes a product the backend does not have)
+     */
+    template <class Backend>
+    WorkloadResult replay(Backend &backend) const;
+
+    /* save(path), load(path): write / read the trace file described above
+     *   >> throw std::runtime_error if the file cannot be written or read,
+     *      std::invalid_argument if a name contains a tab or a newline (save),
+     *      or if a line is malformed (load, with the line number)
+     */
+    void save(const string &path) const;
+    static Workload load(const string &path);
+
+private:
+    static void checkName(const string &name);
+    static void mixAnswer(WorkloadResult &result, const List1D<string> &answer);
+};
+
+// -------------------- WorkloadConfig --------------------
+/*
+ * WorkloadConfig: the shape of a generated inventory and trace.
+ *   Skews are Zipf exponents: 0 is uniform, around 1 a few items take most of the traffic.
+ */
+struct WorkloadConfig
+{
+    uint64_t seed;
+
+    // inventory
+    int products;                 // products in the generated inventory
+    int attributeNames;           // size of the attribute name pool
+    int maxAttributesPerProduct;  // each product has 1..max distinct attributes
+    double attributeSkew;         // popularity of attribute names (on products and in queries)
+    double valueSkew;             // values are maxValue * u^valueSkew: > 1 favours small values
+    double maxValue;
+    double duplicateRatio;        // chance that a product reuses the name of an earlier one
+    int maxQuantity;
+
+    // trace: relative weights of the operation types
+    double queryRatio;
+    double updateRatio;
+    double addRatio;
+    double removeRatio;
+    double keySkew;               // popularity of products for updates and removes
+    double maxQueryWidth;         // a query range covers up to this fraction of [0, maxValue]
+
+    WorkloadConfig()
+        : seed(1), products(1000), attributeNames(8), maxAttributesPerProduct(4), attributeSkew(0.8),
+          valueSkew(2.0), maxValue(1000.0), duplicateRatio(0.05), maxQuantity(1000),
+          queryRatio(0.2), updateRatio(0.7), addRatio(0.05), removeRatio(0.05), keySkew(0.99),
+          maxQueryWidth(0.1) {}
+};
+
+// -------------------- WorkloadGenerator --------------------
+/*
+ * WorkloadGenerator: seeded, reproducible inventories and traces with the shape of production data.
+ *
+ *  >> generateInventory(inventory): appends config.products products. Product names are
+ *     "Product <id>"; with probability duplicateRatio a product reuses an earlier id (duplicates
+ *     for removeDuplicates). Attribute names are drawn by popularity (attributeSkew), values and
+ *     initial quantities are skewed towards small numbers.
+ *  >> generateTrace(n): n operations meant to be replayed on that inventory. Updates and removes
+ *     pick products by Zipf popularity (keySkew); hot products are scattered over the index range.
+ *     The generator tracks the inventory size, so every index of the trace is valid at its turn.
+ *
+ * The inventory and the trace use independent random streams derived from config.seed: the same
+ * config always produces the same inventory and the same trace, whichever is generated first.
+ *
+ * Example:
+ *  WorkloadConfig config;
+ *  config.products = 100000;
+ *  config.keySkew = 1.2;
+ *  WorkloadGenerator generator(config);
+ *  InventoryManager inventory;
+ *  generator.generateInventory(inventory);
+ *  Workload trace = generator.generateTrace(1000000);
+ */
+class WorkloadGenerator
+{
+private:
+    WorkloadConfig config;
+    List1D<string> names; // attribute name pool
+
+public:
+    WorkloadGenerator(const WorkloadConfig &config = WorkloadConfig());
+
+    const WorkloadConfig &getConfig() const { return config; }
+    string attributeName(int rank) const; // rank 1 is the most popular attribute
+
+    void generateInventory(InventoryManager &inventory) const;
+    Workload generateTrace(long numOperations) const;
+
+private:
+    List1D<InventoryAttribute> randomAttributes(SplitMix64 &random, const ZipfDistribution &attributeZipf) const;
+    string randomName(SplitMix64 &random, long &nextId) const;
+    double randomValue(SplitMix64 &random) const;
+    int randomQuantity(SplitMix64 &random) const;
+    static bool contains(const long *ranks, int count, long rank);
+};
+
+// -------------------- WorkloadResult Method Definitions --------------------
+string WorkloadResult::toString() const
+{
+    StringWriter writer;
+    writer.write("queries=");
+    writer.writeInt(queries);
+    writer.write(", updates=");
+    writer.writeInt(updates);
+    writer.write(", adds=");
+    writer.writeInt(adds);
+    writer.write(", removes=");
+    writer.writeInt(removes);
+    writer.write(", rows=");
+    writer.writeInt(rowsReturned);
+    writer.write(", checksum=");
+    writer.writeUnsigned(checksum);
+    return writer.str();
+}
+
+// -------------------- Workload Method Definitions --------------------
+Workload::Workload()
+{
+    operations = new XArrayList<WorkloadOperation>();
+    attributes = new XArrayList<InventoryAttribute>();
+}
+
+Workload::Workload(const Workload &other)
+{
+    operations = new XArrayList<WorkloadOperation>(*other.operations);
+    attributes = new XArrayList<InventoryAttribute>(*other.attributes);
+}
+
+Workload &Workload::operator=(const Workload &other)
+{
+    if (this != &other)
+    {
+        *operations = *other.operations;
+        *attributes = *other.attributes;
+    }
+    return *this;
+}
+
+Workload::~Workload()
+{
+    delete operations;
+    delete attributes;
+}
+
+int Workload::size() const
+{
+    return operations->size();
+}
+
+const WorkloadOperation &Workload::get(int index) const
+{
+    if (index < 0 || index >= operations->size())
+        throw out_of_range("Index is out of range!");
+    return operations->get(index);
+}
+
+List1D<InventoryAttribute> Workload::getAttributes(int index) const
+{
+    const WorkloadOperation &operation = get(index);
+    List1D<InventoryAttribute> result;
+    for (int i = 0; i < operation.attributeCount; i++)
+        result.add(attributes->get(operation.attributeStart + i));
+    return result;
+}
+
+long Workload::count(WorkloadOperation::Type type) const
+{
+    long n = 0;
+    for (int i = 0; i < operations->size(); i++)
+        if (operations->get(i).type == type)
+            n++;
+    return n;
+}
+
+void Workload::query(const string &attributeName, double minValue, double maxValue, int minQuantity, bool ascending)
+{
+    WorkloadOperation operation;
+    operation.type = WorkloadOperation::QUERY;
+    operation.name = attributeName;
+    operation.minValue = minValue;
+    operation.maxValue = maxValue;
+    operation.quantity = minQuantity;
+    operation.ascending = ascending;
+    operations->add(operation);
+}
+
+void Workload::updateQuantity(int index, int newQuantity)
+{
+    WorkloadOperation operation;
+    operation.type = WorkloadOperation::UPDATE;
+    operation.index = index;
+    operation.quantity = newQuantity;
+    operations->add(operation);
+}
+
+void Workload::addProduct(const List1D<InventoryAttribute> &attributes, const string &name, int quantity)
+{
+    WorkloadOperation operation;
+    operation.type = WorkloadOperation::ADD;
+    operation.name = name;
+    operation.quantity = quantity;
+    operation.attributeStart = this->attributes->size();
+    operation.attributeCount = attributes.size();
+    for (int i = 0; i < attributes.size(); i++)
+        this->attributes->add(attributes.get(i));
+    operations->add(operation);
+}
+
+void Workload::removeProduct(int index)
+{
+    WorkloadOperation operation;
+    operation.type = WorkloadOperation::REMOVE;
+    operation.index = index;
+    operations->add(operation);
+}
+
+void Workload::clear()
+{
+    operations->clear();
+    attributes->clear();
+}
+
+template <class Backend>
+WorkloadResult Workload::replay(Backend &backend) const
+{
+    WorkloadResult result;
+    int n = operations->size();
+    for (int i = 0; i < n; i++)
+    {
+        const WorkloadOperation &operation = operations->get(i);
+        switch (operation.type)
+        {
+        case WorkloadOperation::QUERY:
+            mixAnswer(result, backend.query(operation.name, operation.minValue, operation.maxValue,
+                                            operation.quantity, operation.ascending));
+            result.queries++;
+            break;
+        case WorkloadOperation::UPDATE:
+            backend.updateQuantity(operation.index, operation.quantity);
+            result.updates++;
+            break;
+        case WorkloadOperation::ADD:
+            backend.addProduct(getAttributes(i), operation.name, operation.quantity);
+            result.adds++;
+            break;
+        case WorkloadOperation::REMOVE:
+            backend.removeProduct(operation.index);
+            result.removes++;
+            break;
+        }
+    }
+    return result;
+}
+
+void Workload::save(const string &path) const
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw runtime_error("cannot open " + path + ": " + strerror(errno));
+    try
+    {
+        FdWriter writer(fd);
+        for (int i = 0; i < operations->size(); i++)
+        {
+            const WorkloadOperation &operation = operations->get(i);
+            writer.put((char)operation.type);
+            switch (operation.type)
+            {
+            case WorkloadOperation::QUERY:
+                checkName(operation.name);
+                writer.put('\t');
+                writer.write(operation.name);
+                writer.put('\t');
+                writer.writeDouble(operation.minValue, 17);
+                writer.put('\t');
+                writer.writeDouble(operation.maxValue, 17);
+                writer.put('\t');
+                writer.writeInt(operation.quantity);
+                writer.put('\t');
+                writer.put(operation.ascending ? '1' : '0');
+                break;
+            case WorkloadOperation::UPDATE:
+                writer.put('\t');
+                writer.writeInt(operation.index);
+                writer.put('\t');
+                writer.writeInt(operation.quantity);
+                break;
+            case WorkloadOperation::ADD:
+                checkName(operation.name);
+                writer.put('\t');
+                writer.write(operation.name);
+                writer.put('\t');
+                writer.writeInt(operation.quantity);
+                for (int j = 0; j < operation.attributeCount; j++)
+                {
+                    InventoryAttribute &attribute = attributes->get(operation.attributeStart + j);
+                    checkName(attribute.name);
+                    writer.put('\t');
+                    writer.write(attribute.name);
+                    writer.put('\t');
+                    writer.writeDouble(attribute.value, 17);
+                }
+                break;
+            case WorkloadOperation::REMOVE:
+                writer.put('\t');
+                writer.writeInt(operation.index);
+                break;
+            }
+            writer.put('\n');
+        }
+        writer.flush();
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0)
+        throw runtime_error("cannot write " + path + ": " + strerror(errno));
+}
+
+Workload Workload::load(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == NULL)
+        throw runtime_error("cannot open " + path + ": " + strerror(errno));
+
+    Workload workload;
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    long lineNumber = 0;
+    XArrayList<const char *> fields; // start and end of each tab-separated field of the line
+    XArrayList<const char *> ends;
+    try
+    {
+        ssize_t length;
+        while ((length = getline(&line, &lineCapacity, file)) >= 0)
+        {
+            lineNumber++;
+            if (length > 0 && line[length - 1] == '\n')
+                line[--length] = '\0';
+            if (length == 0)
+                continue;
+
+            // split on tabs
+            fields.clear();
+            ends.clear();
+            char *p = line;
+            while (true)
+            {
+                fields.add(p);
+                char *tab = (char *)memchr(p, '\t', line + length - p);
+                ends.add(tab == NULL ? line + length : tab);
+                if (tab == NULL)
+                    break;
+                p = tab + 1;
+            }
+            int numFields = fields.size();
+
+            string error = "line " + to_string(lineNumber) + ": malformed operation";
+            bool ok = ends.get(0) - fields.get(0) == 1;
+            char type = fields.get(0)[0];
+            if (ok && type == WorkloadOperation::QUERY && numFields == 6)
+            {
+                double minValue, maxValue;
+                int minQuantity;
+                ok = InventoryImporter::parseDouble(fields.get(2), ends.get(2), minValue) &&
+                     InventoryImporter::parseDouble(fields.get(3), ends.get(3), maxValue) &&
+                     InventoryImporter::parseInt(fields.get(4), ends.get(4), minQuantity) &&
+                     ends.get(5) - fields.get(5) == 1 && (fields.get(5)[0] == '0' || fields.get(5)[0] == '1');
+                if (ok)
+                    workload.query(string(fields.get(1), ends.get(1)), minValue, maxValue, minQuantity,
+                                   fields.get(5)[0] == '1');
+            }
+            else if (ok && type == WorkloadOperation::UPDATE && numFields == 3)
+            {
+                int index, quantity;
+                ok = InventoryImporter::parseInt(fields.get(1), ends.get(1), index) &&
+                     InventoryImporter::parseInt(fields.get(2), ends.get(2), quantity);
+                if (ok)
+                    workload.updateQuantity(index, quantity);
+            }
+            else if (ok && type == WorkloadOperation::ADD && numFields >= 3 && numFields % 2 == 1)
+            {
+                int quantity;
+                ok = InventoryImporter::parseInt(fields.get(2), ends.get(2), quantity);
+                List1D<InventoryAttribute> attributes;
+                for (int i = 3; ok && i < numFields; i += 2)
+                {
+                    double value;
+                    ok = InventoryImporter::parseDouble(fields.get(i + 1), ends.get(i + 1), value);
+                    attributes.add(InventoryAttribute(string(fields.get(i), ends.get(i)), value));
+                }
+                if (ok)
+                    workload.addProduct(attributes, string(fields.get(1), ends.get(1)), quantity);
+            }
+            else if (ok && type == WorkloadOperation::REMOVE && numFields == 2)
+            {
+                int index;
+                ok = InventoryImporter::parseInt(fields.get(1), ends.get(1), index);
+                if (ok)
+                    workload.removeProduct(index);
+            }
+            else
+                ok = false;
+
+            if (!ok)
+                throw invalid_argument(error);
+        }
+        if (ferror(file))
+            throw runtime_error("cannot read " + path + ": " + strerror(errno));
+    }
+    catch (...)
+    {
+        free(line);
+        fclose(file);
+        throw;
+    }
+    free(line);
+    fclose(file);
+    return workload;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+void Workload::checkName(const string &name)
+{
+    if (name.find_first_of("\t\n") != string::npos)
+        throw invalid_argument("name contains a tab or a newline: " + name);
+}
+
+void Workload::mixAnswer(WorkloadResult &result, const List1D<string> &answer)
+{
+    /*
+     * Folds the answer (its size and every name, in order) into the checksum with FNV-1a,
+     * which does not depend on the platform's std::hash.
+     */
+    uint64_t hash = result.checksum ^ 0xCBF29CE484222325ULL;
+    int n = answer.size();
+    for (int i = 0; i < n; i++)
+    {
+        string name = answer.get(i);
+        for (size_t j = 0; j < name.size(); j++)
+            hash = (hash ^ (unsigned char)name[j]) * 0x100000001B3ULL;
+        hash = (hash ^ 0xFF) * 0x100000001B3ULL; // separator
+    }
+    result.checksum = SplitMix64::mix(hash + n);
+    result.rowsReturned += n;
+}
+
+// -------------------- WorkloadGenerator Method Definitions --------------------
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig &config) : config(config)
+{
+    if (config.products < 0 || config.attributeNames <= 0 || config.maxAttributesPerProduct <= 0 ||
+        config.maxQuantity < 0 || config.maxValue <= 0)
+        throw invalid_argument("invalid workload config");
+    double totalRatio = config.queryRatio + config.updateRatio + config.addRatio + config.removeRatio;
+    if (config.queryRatio < 0 || config.updateRatio < 0 || config.addRatio < 0 || config.removeRatio < 0 ||
+        totalRatio <= 0)
+        throw invalid_argument("operation ratios must be non-negative, and not all zero");
+    // at most 64 (and at most attributeNames) distinct attributes per product
+    if (this->config.maxAttributesPerProduct > config.attributeNames)
+        this->config.maxAttributesPerProduct = config.attributeNames;
+    if (this->config.maxAttributesPerProduct > 64)
+        this->config.maxAttributesPerProduct = 64;
+
+    const char *common[] = {"weight", "height", "depth", "width", "price", "rating", "volume", "color"};
+    for (int i = 0; i < config.attributeNames; i++)
+        names.add(i < 8 ? string(common[i]) : "attr" + to_string(i));
+}
+
+string WorkloadGenerator::attributeName(int rank) const
+{
+    if (rank < 1 || rank > config.attributeNames)
+        throw out_of_range("Index is out of range!");
+    return names.get(rank - 1);
+}
+
+void WorkloadGenerator::generateInventory(InventoryManager &inventory) const
+{
+    SplitMix64 random(SplitMix64::mix(config.seed));
+    ZipfDistribution attributeZipf(config.attributeNames, config.attributeSkew);
+    long nextId = 0;
+    for (int i = 0; i < config.products; i++)
+    {
+        string name = randomName(random, nextId);
+        List1D<InventoryAttribute> attributes = randomAttributes(random, attributeZipf);
+        inventory.addProduct(attributes, name, randomQuantity(random));
+    }
+}
+
+Workload WorkloadGenerator::generateTrace(long numOperations) const
+{
+    SplitMix64 random(SplitMix64::mix(config.seed ^ 0x5452414345ULL)); // "TRACE"
+    uint64_t keySalt = random.next();
+    ZipfDistribution attributeZipf(config.attributeNames, config.attributeSkew);
+    ZipfDistribution keyZipf(1, config.keySkew);
+    double total = config.queryRatio + config.updateRatio + config.addRatio + config.removeRatio;
+    double queryLimit = config.queryRatio / total;
+    double updateLimit = queryLimit + config.updateRatio / total;
+    double addLimit = updateLimit + config.addRatio / total;
+
+    Workload workload;
+    long size = config.products;
+    long nextId = config.products; // names of added products continue the inventory's ids
+    for (long i = 0; i < numOperations; i++)
+    {
+        double u = random.nextDouble();
+        if (u < queryLimit)
+        {
+            string attribute = attributeName((int)attributeZipf.sample(random));
+            double minValue = randomValue(random);
+            double maxValue = minValue + random.nextDouble() * config.maxQueryWidth * config.maxValue;
+            int minQuantity = random.nextBool(0.5) ? 0 : randomQuantity(random);
+            workload.query(attribute, minValue, maxValue, minQuantity, random.nextBool(0.5));
+        }
+        else if (size == 0 || (u >= updateLimit && u < addLimit)) // nothing to update or remove: add
+        {
+            string name = randomName(random, nextId);
+            List1D<InventoryAttribute> attributes = randomAttributes(random, attributeZipf);
+            workload.addProduct(attributes, name, randomQuantity(random));
+            size++;
+        }
+        else
+        {
+            // hot products: Zipf rank, scattered over the current index range
+            if (keyZipf.size() != size)
+                keyZipf = ZipfDistribution(size, config.keySkew);
+            long rank = keyZipf.sample(random);
+            int index = (int)(SplitMix64::mix(keySalt + rank) % (uint64_t)size);
+            if (u < updateLimit)
+                workload.updateQuantity(index, (int)random.nextInt(config.maxQuantity + 1));
+            else
+            {
+                workload.removeProduct(index);
+                size--;
+            }
+        }
+    }
+    return workload;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+List1D<InventoryAttribute> WorkloadGenerator::randomAttributes(SplitMix64 &random,
+                                                               const ZipfDistribution &attributeZipf) const
+{
+    /*
+     * 1..maxAttributesPerProduct distinct names, drawn by popularity: a draw that hits a name the
+     * product already has is retried a few times, then the next unused rank is taken.
+     */
+    int k = 1 + (int)random.nextInt(config.maxAttributesPerProduct);
+    List1D<InventoryAttribute> attributes;
+    long ranks[64];
+    for (int i = 0; i < k; i++)
+    {
+        long rank = attributeZipf.sample(random);
+        for (int retry = 0; retry < 4 && contains(ranks, i, rank); retry++)
+            rank = attributeZipf.sample(random);
+        while (contains(ranks, i, rank))
+            rank = rank % config.attributeNames + 1;
+        ranks[i] = rank;
+        attributes.add(InventoryAttribute(attributeName((int)rank), randomValue(random)));
+    }
+    return attributes;
+}
+
+string WorkloadGenerator::randomName(SplitMix64 &random, long &nextId) const
+{
+    long id = nextId;
+    if (nextId > 0 && random.nextBool(config.duplicateRatio))
+        id = (long)random.nextInt(nextId);
+    else
+        nextId++;
+    return "Product " + to_string(id);
+}
+
+double WorkloadGenerator::randomValue(SplitMix64 &random) const
+{
+    // rounded to 3 decimals, so values print back exactly with the inventory's 6 digits
+    double value = config.maxValue * pow(random.nextDouble(), config.valueSkew);
+    return (double)(long)(value * 1000.0 + 0.5) / 1000.0;
+}
+
+int WorkloadGenerator::randomQuantity(SplitMix64 &random) const
+{
+    double u = random.nextDouble();
+    return (int)(config.maxQuantity * u * u);
+}
+
+bool WorkloadGenerator::contains(const long *ranks, int count, long rank)
+{
+    for (int i = 0; i < count; i++)
+        if (ranks[i] == rank)
+            return true;
+    return false;
+}
+
+#endif /* INVENTORY_WORKLOAD_H */
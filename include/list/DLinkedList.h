@@ -6,33 +6,50 @@
 #define DLINKEDLIST_H
 
 #include "list/IList.h"
+#include "util/Writer.h"
+#include "list/ListPolicies.h"
 
 #include <sstream>
 #include <iostream>
 #include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
 using namespace std;
 
-template <class T>
+/*
+ * DLinkedList<T, Equal, Deleter>: a doubly linked list. Equal compares the items and Deleter
+ * releases what they own; both default to the function pointers given to the constructor (see
+ * list/ListPolicies.h).
+ */
+template <class T, class Equal = ItemEqualFunction<T>, class Deleter = DeleteUserDataHook>
 class DLinkedList : public IList<T>
 {
 public:
     class Node;        // Forward declaration
-    class Iterator;    // Forward declaration
-    class BWDIterator; // Forward declaration
+    class Iterator;      // Forward declaration
+    class ConstIterator; // Forward declaration
+    class BWDIterator;   // Forward declaration
+
+    // what the list stores for Deleter: for DeleteUserDataHook, a void (*)(DLinkedList *)
+    typedef typename DeleterOf<Deleter, DLinkedList<T, Equal, Deleter>>::type DeleterType;
 
 protected:
     Node *head; // this node does not contain user's data
     Node *tail; // this node does not contain user's data
     int count;
-    bool (*itemEqual)(T &lhs, T &rhs);        // function pointer: test if two items (type: T&) are equal or not
-    void (*deleteUserData)(DLinkedList<T> *); // function pointer: be called to remove items (if they are pointer type)
+    Equal itemEqual;            // test if two items (type: T&) are equal or not
+    DeleterType deleteUserData; // be called to remove items (if they are pointer type)
 
 public:
     DLinkedList(
-        void (*deleteUserData)(DLinkedList<T> *) = 0,
-        bool (*itemEqual)(T &, T &) = 0);
-    DLinkedList(const DLinkedList<T> &list);
-    DLinkedList<T> &operator=(const DLinkedList<T> &list);
+        DeleterType deleteUserData = DeleterType(),
+        Equal itemEqual = Equal());
+    DLinkedList(const DLinkedList<T, Equal, Deleter> &list);
+    DLinkedList(DLinkedList<T, Equal, Deleter> &&list); // move: take the nodes of "list", left empty
+    DLinkedList<T, Equal, Deleter> &operator=(const DLinkedList<T, Equal, Deleter> &list);
+    DLinkedList<T, Equal, Deleter> &operator=(DLinkedList<T, Equal, Deleter> &&list);
     ~DLinkedList();
 
     // Inherit from IList: BEGIN
@@ -49,11 +66,59 @@ public:
     string toString(string (*item2str)(T &) = 0);
     // Inherit from IList: END
 
+    void writeTo(Writer &writer, string (*item2str)(T &) = 0);
+
+    /* Bulk operations (see IList): one walk to the position, then every node is linked or
+     * unlinked in O(1); no other item is touched.
+     *  >> addAll / insertRange(index, first, last): any input iterators over items that are not
+     *     in this list
+     *  >> removeRange(from, to): the nodes are cut out with a single splice, then deleted
+     *  >> removeIf(predicate): any callable bool(T &), inlined
+     */
+    void addAll(const T *items, int k);
+    void insertRange(int index, const T *items, int k);
+    void removeRange(int from, int to, void (*removeItemData)(T) = 0);
+    int removeIf(bool (*predicate)(T &), void (*removeItemData)(T) = 0);
+    template <class InputIterator>
+    void addAll(InputIterator first, InputIterator last);
+    template <class InputIterator>
+    void insertRange(int index, InputIterator first, InputIterator last);
+    template <class Predicate>
+    int removeIf(Predicate predicate, void (*removeItemData)(T) = 0);
+
+    /* Splicing: the nodes move from one list to the other and are relinked; nothing is allocated,
+     * copied or deleted. Every node records the list it is in, so moving k items into another list
+     * costs O(k) to relabel them. Iterators to the moved items stay valid and keep pointing at
+     * them, in the list they moved into: remove them with that list's erase(it).
+     *  >> splice(pos, other): move all the items of "other" before "pos" (an iterator of this
+     *     list; end() appends), in O(k); "other" is left empty
+     *  >> splice(pos, other, first, last): move the items [first, last) of "other" before "pos";
+     *     O(k) when "other" is another list, O(1) within this list ("pos" must not be in
+     *     [first, last))
+     *  >> splitAt(index): move the items [index, size) into a new list, which is returned (same
+     *     Equal and Deleter); O(size - index)
+     *  >> concat(other): splice(end(), other)
+     * A list with a deleting Deleter owns the items it holds at destruction: moving items moves
+     * their ownership too. Iterators that do not point into the list they are given to throw
+     * std::invalid_argument.
+     */
+    /* erase(pos, removeItemData): remove the item at "pos" from this list, in O(1); returns an
+     *   iterator to the next item (end() after the last one). "pos" may come from any list the
+     *   item was in before being spliced here.
+     *   Throws std::out_of_range on end(), std::invalid_argument if the item is not in this list.
+     */
+    Iterator erase(Iterator pos, void (*removeItemData)(T) = 0);
+
+    void splice(Iterator pos, DLinkedList<T, Equal, Deleter> &other);
+    void splice(Iterator pos, DLinkedList<T, Equal, Deleter> &other, Iterator first, Iterator last);
+    DLinkedList<T, Equal, Deleter> splitAt(int index);
+    void concat(DLinkedList<T, Equal, Deleter> &other);
+
     void println(string (*item2str)(T &) = 0)
     {
         cout << toString(item2str) << endl;
     }
-    void setDeleteUserDataPtr(void (*deleteUserData)(DLinkedList<T> *) = 0)
+    void setDeleteUserDataPtr(DeleterType deleteUserData = DeleterType())
     {
         this->deleteUserData = deleteUserData;
     }
@@ -61,7 +126,7 @@ public:
     bool contains(T array[], int size)
     {
         int idx = 0;
-        for (DLinkedList<T>::Iterator it = begin(); it != end(); it++)
+        for (DLinkedList<T, Equal, Deleter>::Iterator it = begin(); it != end(); it++)
         {
             if (!equals(*it, array[idx++], this->itemEqual))
                 return false;
@@ -76,10 +141,11 @@ public:
      *      he/she must pass "free" to constructor of DLinkedList
      *      Example:
      *      DLinkedList<T> list(&DLinkedList<T>::free);
+     *      (the Deleter policy DeleteItems does the same, without the function pointer)
      */
-    static void free(DLinkedList<T> *list)
+    static void free(DLinkedList<T, Equal, Deleter> *list)
     {
-        typename DLinkedList<T>::Iterator it = list->begin();
+        typename DLinkedList<T, Equal, Deleter>::Iterator it = list->begin();
         while (it != list->end())
         {
             delete *it;
@@ -104,6 +170,22 @@ public:
     {
         return Iterator(this, false);
     }
+    ConstIterator begin() const
+    {
+        return ConstIterator(this, true);
+    }
+    ConstIterator end() const
+    {
+        return ConstIterator(this, false);
+    }
+    ConstIterator cbegin() const
+    {
+        return ConstIterator(this, true);
+    }
+    ConstIterator cend() const
+    {
+        return ConstIterator(this, false);
+    }
 
     /* last, beforeFirst and BWDIterator helps user to traverse a list backwardly
      * Example: assume "list" is object of DLinkedList
@@ -124,16 +206,15 @@ public:
     }
 
 protected:
-    static bool equals(T &lhs, T &rhs, bool (*itemEqual)(T &, T &))
+    static bool equals(T &lhs, T &rhs, const Equal &itemEqual)
     {
-        if (itemEqual == 0)
-            return lhs == rhs;
-        else
-            return itemEqual(lhs, rhs);
+        return itemEqual(lhs, rhs);
     }
-    void copyFrom(const DLinkedList<T> &list);
+    void copyFrom(const DLinkedList<T, Equal, Deleter> &list);
     void removeInternalData();
     Node *getPreviousNodeOf(int index);
+    void checkIterator(const Iterator &iterator) const; // an iterator into this list (end() included)
+    static void linkBefore(Node *pos, Node *first, Node *last); // the chain first..last, detached
 
     //////////////////////////////////////////////////////////////////////
     ////////////////////////  INNER CLASSES DEFNITION ////////////////////
@@ -145,31 +226,48 @@ public:
         T data;
         Node *next;
         Node *prev;
-        friend class DLinkedList<T>;
+        Node *owner; // the tail sentinel of the list holding this node
+        friend class DLinkedList<T, Equal, Deleter>;
 
     public:
         Node(Node *next = 0, Node *prev = 0)
         {
             this->next = next;
             this->prev = prev;
+            this->owner = 0;
         }
+        // a node linked before "next" joins the list of "next"
         Node(T data, Node *next = 0, Node *prev = 0)
         {
             this->data = data;
             this->next = next;
             this->prev = prev;
+            this->owner = next != 0 ? next->owner : 0;
         }
     };
 
     //////////////////////////////////////////////////////////////////////
+    /* Iterator, ConstIterator: bidirectional iterators (std::iterator_traits, std::find_if,
+     * std::reverse, ...). --end() is the last item.
+     */
     class Iterator
     {
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
     private:
-        DLinkedList<T> *pList;
+        DLinkedList<T, Equal, Deleter> *pList;
         Node *pNode;
+        friend class ConstIterator;
+        friend class BWDIterator;
+        friend class DLinkedList<T, Equal, Deleter>;
 
     public:
-        Iterator(DLinkedList<T> *pList = 0, bool begin = true)
+        Iterator(DLinkedList<T, Equal, Deleter> *pList = 0, bool begin = true)
         {
             if (begin)
             {
@@ -188,29 +286,29 @@ public:
             this->pList = pList;
         }
 
-        Iterator &operator=(const Iterator &iterator)
-        {
-            this->pNode = iterator.pNode;
-            this->pList = iterator.pList;
-            return *this;
-        }
+        // remove(): as pList->erase(*this); throws if the item was spliced into another list
         void remove(void (*removeItemData)(T) = 0)
         {
-            pNode->prev->next = pNode->next;
-            pNode->next->prev = pNode->prev;
+            if (pList == 0)
+                throw invalid_argument("Iterator does not point into a list!");
             Node *pNext = pNode->prev; // MUST prev, so iterator++ will go to end
-            if (removeItemData != 0)
-                removeItemData(pNode->data);
-            delete pNode;
+            pList->erase(*this, removeItemData);
             pNode = pNext;
-            pList->count -= 1;
         }
 
-        T &operator*()
+        T &operator*() const
         {
             return pNode->data;
         }
-        bool operator!=(const Iterator &iterator)
+        T *operator->() const
+        {
+            return &pNode->data;
+        }
+        bool operator==(const Iterator &iterator) const
+        {
+            return pNode == iterator.pNode;
+        }
+        bool operator!=(const Iterator &iterator) const
         {
             return pNode != iterator.pNode;
         }
@@ -227,17 +325,93 @@ public:
             ++*this;
             return iterator;
         }
+        Iterator &operator--()
+        {
+            pNode = pNode->prev;
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator iterator = *this;
+            --*this;
+            return iterator;
+        }
+    };
+
+    class ConstIterator
+    {
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+    private:
+        const Node *pNode;
+
+    public:
+        ConstIterator(const DLinkedList<T, Equal, Deleter> *pList = 0, bool begin = true)
+        {
+            if (pList == 0)
+                pNode = 0;
+            else
+                pNode = begin ? pList->head->next : pList->tail;
+        }
+        ConstIterator(const Iterator &iterator)
+        {
+            pNode = iterator.pNode;
+        }
+
+        const T &operator*() const
+        {
+            return pNode->data;
+        }
+        const T *operator->() const
+        {
+            return &pNode->data;
+        }
+        bool operator==(const ConstIterator &iterator) const
+        {
+            return pNode == iterator.pNode;
+        }
+        bool operator!=(const ConstIterator &iterator) const
+        {
+            return pNode != iterator.pNode;
+        }
+        ConstIterator &operator++()
+        {
+            pNode = pNode->next;
+            return *this;
+        }
+        ConstIterator operator++(int)
+        {
+            ConstIterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+        ConstIterator &operator--()
+        {
+            pNode = pNode->prev;
+            return *this;
+        }
+        ConstIterator operator--(int)
+        {
+            ConstIterator iterator = *this;
+            --*this;
+            return iterator;
+        }
     };
 
     // Backward Iterator
     class BWDIterator
     {
     private:
-        DLinkedList<T> *pList;
+        DLinkedList<T, Equal, Deleter> *pList;
         Node *pNode;
 
     public:
-        BWDIterator(DLinkedList<T> *pList = 0, bool last = true)
+        BWDIterator(DLinkedList<T, Equal, Deleter> *pList = 0, bool last = true)
         {
             if (last)
             {
@@ -256,22 +430,15 @@ public:
             this->pList = pList;
         }
 
-        BWDIterator &operator=(const BWDIterator &iterator)
-        {
-            this->pNode = iterator.pNode;
-            this->pList = iterator.pList;
-            return *this;
-        }
         void remove(void (*removeItemData)(T) = 0)
         {
-            pNode->prev->next = pNode->next;
-            pNode->next->prev = pNode->prev;
+            if (pList == 0)
+                throw invalid_argument("Iterator does not point into a list!");
+            Iterator it(pList);
+            it.pNode = pNode;
             Node *pNext = pNode->next; // MUST next, so iterator-- will go to head
-            if (removeItemData != 0)
-                removeItemData(pNode->data);
-            delete pNode;
+            pList->erase(it, removeItemData);
             pNode = pNext;
-            pList->count -= 1;
         }
 
         T &operator*()
@@ -307,34 +474,51 @@ using List = DLinkedList<T>;
 ////////////////////////     METHOD DEFNITION      ///////////////////
 //////////////////////////////////////////////////////////////////////
 
-template <class T>
-DLinkedList<T>::DLinkedList(
-    void (*deleteUserData)(DLinkedList<T> *),
-    bool (*itemEqual)(T &, T &))
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter>::DLinkedList(
+    DeleterType deleteUserData,
+    Equal itemEqual) : itemEqual(itemEqual), deleteUserData(deleteUserData)
 {
     this->count = 0;
-    this->setDeleteUserDataPtr(deleteUserData);
-    this->itemEqual = itemEqual;
     this->head = new Node(); // Dummy head
     this->tail = new Node(); // Dummy tail
     this->head->next = this->tail;
     this->tail->prev = this->head;
+    this->head->owner = this->tail->owner = this->tail;
 }
 
-template <class T>
-DLinkedList<T>::DLinkedList(const DLinkedList<T> &list)
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter>::DLinkedList(const DLinkedList<T, Equal, Deleter> &list)
+    : itemEqual(list.itemEqual), deleteUserData(list.deleteUserData)
 {
     // Khởi tạo head và tail
     this->head = new Node();
     this->tail = new Node();
     this->head->next = this->tail;
     this->tail->prev = this->head;
+    this->head->owner = this->tail->owner = this->tail;
     this->count = 0;
     copyFrom(list);
 }
 
-template <class T>
-DLinkedList<T> &DLinkedList<T>::operator=(const DLinkedList<T> &list)
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter>::DLinkedList(DLinkedList<T, Equal, Deleter> &&list)
+    : itemEqual(list.itemEqual), deleteUserData(list.deleteUserData)
+{
+    this->head = new Node();
+    this->tail = new Node();
+    this->head->next = this->tail;
+    this->tail->prev = this->head;
+    this->head->owner = this->tail->owner = this->tail;
+    this->count = 0;
+    // trade sentinels: the nodes stay labeled with their tail sentinel, which moves with them
+    swap(head, list.head);
+    swap(tail, list.tail);
+    swap(count, list.count);
+}
+
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter> &DLinkedList<T, Equal, Deleter>::operator=(const DLinkedList<T, Equal, Deleter> &list)
 {
     if (this != &list)
     {
@@ -344,16 +528,31 @@ DLinkedList<T> &DLinkedList<T>::operator=(const DLinkedList<T> &list)
     return *this;
 }
 
-template <class T>
-DLinkedList<T>::~DLinkedList()
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter> &DLinkedList<T, Equal, Deleter>::operator=(DLinkedList<T, Equal, Deleter> &&list)
+{
+    if (this != &list)
+    {
+        removeInternalData();
+        itemEqual = list.itemEqual;
+        deleteUserData = list.deleteUserData;
+        swap(head, list.head);
+        swap(tail, list.tail);
+        swap(count, list.count);
+    }
+    return *this;
+}
+
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter>::~DLinkedList()
 {
     clear();
     delete head;
     delete tail;
 }
 
-template <class T>
-void DLinkedList<T>::add(T e)
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::add(T e)
 {
     Node *newNode = new Node(e, this->tail, this->tail->prev);
     this->tail->prev->next = newNode;
@@ -361,8 +560,8 @@ void DLinkedList<T>::add(T e)
     count++;
 }
 
-template <class T>
-void DLinkedList<T>::add(int index, T e)
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::add(int index, T e)
 {
     if (index < 0 || index > count)
     {
@@ -396,8 +595,8 @@ void DLinkedList<T>::add(int index, T e)
     count++;
 }
 
-template <class T>
-typename DLinkedList<T>::Node *DLinkedList<T>::getPreviousNodeOf(int index)
+template <class T, class Equal, class Deleter>
+typename DLinkedList<T, Equal, Deleter>::Node *DLinkedList<T, Equal, Deleter>::getPreviousNodeOf(int index)
 {
     if (index < 0 || index > count)
     {
@@ -432,8 +631,8 @@ typename DLinkedList<T>::Node *DLinkedList<T>::getPreviousNodeOf(int index)
     }
 }
 
-template <class T>
-T DLinkedList<T>::removeAt(int index)
+template <class T, class Equal, class Deleter>
+T DLinkedList<T, Equal, Deleter>::removeAt(int index)
 {
     if (index < 0 || index > count)
         throw out_of_range("Index is out of range!");
@@ -450,26 +649,26 @@ T DLinkedList<T>::removeAt(int index)
     return removedData;
 }
 
-template <class T>
-bool DLinkedList<T>::empty()
+template <class T, class Equal, class Deleter>
+bool DLinkedList<T, Equal, Deleter>::empty()
 {
     return count == 0;
 }
 
-template <class T>
-int DLinkedList<T>::size()
+template <class T, class Equal, class Deleter>
+int DLinkedList<T, Equal, Deleter>::size()
 {
     return count;
 }
 
-template <class T>
-void DLinkedList<T>::clear()
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::clear()
 {
     removeInternalData();
 }
 
-template <class T>
-T &DLinkedList<T>::get(int index)
+template <class T, class Equal, class Deleter>
+T &DLinkedList<T, Equal, Deleter>::get(int index)
 {
     if (index < 0 || index >= count)
         throw out_of_range("Index is out of range!");
@@ -477,8 +676,8 @@ T &DLinkedList<T>::get(int index)
     return p->data;
 }
 
-template <class T>
-int DLinkedList<T>::indexOf(T item)
+template <class T, class Equal, class Deleter>
+int DLinkedList<T, Equal, Deleter>::indexOf(T item)
 {
     int index = 0;
     for (Node *node = head->next; node != tail; node = node->next)
@@ -492,8 +691,8 @@ int DLinkedList<T>::indexOf(T item)
     return -1;
 }
 
-template <class T>
-bool DLinkedList<T>::removeItem(T item, void (*removeItemData)(T))
+template <class T, class Equal, class Deleter>
+bool DLinkedList<T, Equal, Deleter>::removeItem(T item, void (*removeItemData)(T))
 {
     int index = indexOf(item);
     if (index == -1)
@@ -504,14 +703,14 @@ bool DLinkedList<T>::removeItem(T item, void (*removeItemData)(T))
     return true;
 }
 
-template <class T>
-bool DLinkedList<T>::contains(T item)
+template <class T, class Equal, class Deleter>
+bool DLinkedList<T, Equal, Deleter>::contains(T item)
 {
     return indexOf(item) != -1;
 }
 
-template <class T>
-string DLinkedList<T>::toString(string (*item2str)(T &))
+template <class T, class Equal, class Deleter>
+string DLinkedList<T, Equal, Deleter>::toString(string (*item2str)(T &))
 {
     /**
      * Converts the list into a string representation, where each element is formatted using a user-provided function.
@@ -521,31 +720,257 @@ string DLinkedList<T>::toString(string (*item2str)(T &))
      * @param item2str A function that converts an item of type T to a string. If null, default to string conversion of T.
      * @return A string representation of the list with elements separated by commas and enclosed in square brackets.
      */
-    stringstream oss;
-    oss << "[";
+    StringWriter writer;
+    writeTo(writer, item2str);
+    return writer.str();
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::writeTo(Writer &writer, string (*item2str)(T &))
+{
+    /**
+     * Appends the text returned by toString to "writer", without building intermediate strings
+     * (except the ones returned by item2str).
+     */
+    writer.put('[');
     Node *p = head->next;
     while (p != tail)
     {
         if (item2str != 0)
         {
-            oss << item2str(p->data);
+            writer.write(item2str(p->data));
         }
         else
         {
-            oss << p->data;
+            writeItem(writer, p->data);
         }
         p = p->next;
         if (p != tail)
         {
-            oss << ", ";
+            writer.write(", ", 2);
         }
     }
-    oss << "]";
-    return oss.str();
+    writer.put(']');
 }
 
-template <class T>
-void DLinkedList<T>::copyFrom(const DLinkedList<T> &list)
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::addAll(const T *items, int k)
+{
+    insertRange(count, items, items + k);
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::insertRange(int index, const T *items, int k)
+{
+    insertRange(index, items, items + k);
+}
+
+template <class T, class Equal, class Deleter>
+template <class InputIterator>
+void DLinkedList<T, Equal, Deleter>::addAll(InputIterator first, InputIterator last)
+{
+    insertRange(count, first, last);
+}
+
+template <class T, class Equal, class Deleter>
+template <class InputIterator>
+void DLinkedList<T, Equal, Deleter>::insertRange(int index, InputIterator first, InputIterator last)
+{
+    if (index < 0 || index > count)
+    {
+        throw out_of_range("Index is out of range!");
+    }
+
+    // Các phần tử mới được chèn lần lượt ngay trước node "at"
+    Node *at = index == count ? tail : getPreviousNodeOf(index)->next;
+    for (; first != last; ++first)
+    {
+        Node *newNode = new Node(*first, at, at->prev);
+        at->prev->next = newNode;
+        at->prev = newNode;
+        count++;
+    }
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::removeRange(int from, int to, void (*removeItemData)(T))
+{
+    if (from < 0 || from > to || to > count)
+    {
+        throw out_of_range("Range is out of range!");
+    }
+    if (from == to)
+    {
+        return;
+    }
+
+    // Cắt cả đoạn [from, to) ra khỏi danh sách một lần, rồi xoá các node của đoạn đó
+    Node *before = getPreviousNodeOf(from);
+    Node *after = before->next;
+    for (int i = from; i < to; i++)
+    {
+        after = after->next;
+    }
+    Node *node = before->next;
+    before->next = after;
+    after->prev = before;
+    while (node != after)
+    {
+        Node *nextNode = node->next;
+        if (removeItemData != 0)
+        {
+            removeItemData(node->data);
+        }
+        delete node;
+        node = nextNode;
+    }
+    count -= to - from;
+}
+
+template <class T, class Equal, class Deleter>
+int DLinkedList<T, Equal, Deleter>::removeIf(bool (*predicate)(T &), void (*removeItemData)(T))
+{
+    return removeIf<bool (*)(T &)>(predicate, removeItemData);
+}
+
+template <class T, class Equal, class Deleter>
+template <class Predicate>
+int DLinkedList<T, Equal, Deleter>::removeIf(Predicate predicate, void (*removeItemData)(T))
+{
+    int removed = 0;
+    Node *node = head->next;
+    while (node != tail)
+    {
+        Node *nextNode = node->next;
+        if (predicate(node->data))
+        {
+            node->prev->next = nextNode;
+            nextNode->prev = node->prev;
+            if (removeItemData != 0)
+            {
+                removeItemData(node->data);
+            }
+            delete node;
+            removed++;
+        }
+        node = nextNode;
+    }
+    count -= removed;
+    return removed;
+}
+
+template <class T, class Equal, class Deleter>
+typename DLinkedList<T, Equal, Deleter>::Iterator DLinkedList<T, Equal, Deleter>::erase(Iterator pos, void (*removeItemData)(T))
+{
+    checkIterator(pos); // a.erase(b.end()) throws here, before b's sentinel is touched
+    if (pos.pNode == tail || pos.pNode == head)
+    {
+        throw out_of_range("Cannot erase end()!");
+    }
+    Node *node = pos.pNode;
+    Iterator next(this);
+    next.pNode = node->next;
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    if (removeItemData != 0)
+        removeItemData(node->data);
+    delete node;
+    count -= 1;
+    return next;
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::splice(Iterator pos, DLinkedList<T, Equal, Deleter> &other)
+{
+    if (&other == this)
+    {
+        throw invalid_argument("Cannot splice a list into itself!");
+    }
+    checkIterator(pos);
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    // Tháo toàn bộ chuỗi node khỏi "other" rồi nối vào trước pos
+    Node *first = other.head->next;
+    Node *last = other.tail->prev;
+    for (Node *node = first; node != other.tail; node = node->next)
+    {
+        node->owner = tail;
+    }
+    other.head->next = other.tail;
+    other.tail->prev = other.head;
+    linkBefore(pos.pNode, first, last);
+    count += other.count;
+    other.count = 0;
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::splice(Iterator pos, DLinkedList<T, Equal, Deleter> &other, Iterator first, Iterator last)
+{
+    checkIterator(pos);
+    other.checkIterator(first);
+    other.checkIterator(last);
+    if (first == last)
+    {
+        return;
+    }
+    if (&other != this)
+    {
+        int k = 0;
+        for (Node *node = first.pNode; node != last.pNode; node = node->next)
+        {
+            node->owner = tail;
+            k++;
+        }
+        count += k;
+        other.count -= k;
+    }
+
+    Node *firstNode = first.pNode;
+    Node *lastNode = last.pNode->prev;
+    firstNode->prev->next = last.pNode;
+    last.pNode->prev = firstNode->prev;
+    linkBefore(pos.pNode, firstNode, lastNode);
+}
+
+template <class T, class Equal, class Deleter>
+DLinkedList<T, Equal, Deleter> DLinkedList<T, Equal, Deleter>::splitAt(int index)
+{
+    if (index < 0 || index > count)
+    {
+        throw out_of_range("Index is out of range!");
+    }
+    DLinkedList<T, Equal, Deleter> rest(deleteUserData, itemEqual);
+    if (index == count)
+    {
+        return rest;
+    }
+
+    Node *before = getPreviousNodeOf(index);
+    Node *first = before->next;
+    Node *last = tail->prev;
+    before->next = tail;
+    tail->prev = before;
+    for (Node *node = first; node != tail; node = node->next)
+    {
+        node->owner = rest.tail;
+    }
+    linkBefore(rest.tail, first, last);
+    rest.count = count - index;
+    count = index;
+    return rest;
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::concat(DLinkedList<T, Equal, Deleter> &other)
+{
+    splice(end(), other);
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::copyFrom(const DLinkedList<T, Equal, Deleter> &list)
 {
     // Kiểm tra danh sách nguồn có rỗng không
     if (list.count == 0)
@@ -575,13 +1000,10 @@ void DLinkedList<T>::copyFrom(const DLinkedList<T> &list)
     }
 }
 
-template <class T>
-void DLinkedList<T>::removeInternalData()
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::removeInternalData()
 {
-    if (deleteUserData != nullptr)
-    {
-        deleteUserData(this); // hàm free sẽ duyệt và delete từng node->data
-    }
+    deleteUserData(this); // hàm free sẽ duyệt và delete từng node->data
 
     // Duyệt để xóa từng node (nhưng KHÔNG xóa node->data nữa!)
     Node *node = head->next;
@@ -597,4 +1019,26 @@ void DLinkedList<T>::removeInternalData()
     count = 0;
 }
 
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::checkIterator(const Iterator &iterator) const
+{
+    if (iterator.pNode == 0)
+    {
+        throw invalid_argument("Iterator does not point into a list!");
+    }
+    if (iterator.pNode->owner != tail)
+    {
+        throw invalid_argument("Iterator does not point into this list!");
+    }
+}
+
+template <class T, class Equal, class Deleter>
+void DLinkedList<T, Equal, Deleter>::linkBefore(Node *pos, Node *first, Node *last)
+{
+    first->prev = pos->prev;
+    last->next = pos;
+    pos->prev->next = first;
+    pos->prev = last;
+}
+
 #endif /* DLINKEDLIST_H */
@@ -15,6 +15,7 @@
 #ifndef ILIST_H
 #define ILIST_H
 #include <string>
+#include <stdexcept>
 using namespace std;
 
 template<class T>
@@ -101,6 +102,51 @@ public:
      *          that can convert the item (passed to that function) to a string
      */
     virtual string  toString(string (*item2str)(T&)=0 )=0;
+    
+    
+    
+    /* Bulk operations. The defaults below are built on add / removeAt / get (one shift per item);
+     * XArrayList and DLinkedList override them to move the other items only once.
+     *  >> addAll(items, k): append items[0..k-1]
+     *  >> insertRange(index, items, k): insert items[0..k-1] at location "index" (0 <= index <= size)
+     *  >> removeRange(from, to): remove the items at locations [from, to);
+     *      throw an exception (std::out_of_range) unless 0 <= from <= to <= size
+     *  >> removeIf(predicate): remove every item for which predicate(item) is true, keeping the
+     *      order of the others; return the number of items removed
+     * As in removeItem, removeItemData (if given) is called on every removed item, e.g. to delete
+     * the items of a list that owns them; without it, the removed items' data is not deleted.
+     */
+    virtual void    addAll(const T* items, int k){
+        for(int i = 0; i < k; i++)
+            add(items[i]);
+    }
+    virtual void    insertRange(int index, const T* items, int k){
+        for(int i = 0; i < k; i++)
+            add(index + i, items[i]);
+    }
+    virtual void    removeRange(int from, int to, void (*removeItemData)(T)=0){
+        if(from < 0 || from > to || to > size())
+            throw std::out_of_range("Range is out of range!");
+        for(int i = from; i < to; i++){
+            T item = removeAt(from);
+            if(removeItemData != 0)
+                removeItemData(item);
+        }
+    }
+    virtual int     removeIf(bool (*predicate)(T&), void (*removeItemData)(T)=0){
+        int removed = 0;
+        for(int i = 0; i < size(); ){
+            if(predicate(get(i))){
+                T item = removeAt(i);
+                if(removeItemData != 0)
+                    removeItemData(item);
+                removed++;
+            }
+            else
+                i++;
+        }
+        return removed;
+    }
 };
 #endif /* ILIST_H */
 
@@ -0,0 +1,509 @@
+/*
+ * File:   IntrusiveDList.h
+ */
+
+#ifndef INTRUSIVEDLIST_H
+#define INTRUSIVEDLIST_H
+#include "util/Writer.h"
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+/*
+ * DListHook: the links of an object in an IntrusiveDList, stored inside the object itself. An
+ * object can be in as many lists at once as it has hooks (one list per hook at a time).
+ * While linked, the hook also records the list it is in and the object it belongs to, so the list
+ * finds the object from the hook without pointer arithmetic, and knows whether an object is its own.
+ * Copying an object does not copy its links: the copy is in no list.
+ */
+struct DListHook
+{
+    DListHook *next;
+    DListHook *prev;
+    const void *list; // the IntrusiveDList holding the object, 0 when unlinked
+    void *item;       // the object the hook is a member of (0 for a list's sentinel)
+
+    DListHook() : next(0), prev(0), list(0), item(0) {}
+    DListHook(const DListHook &) : next(0), prev(0), list(0), item(0) {}
+    DListHook &operator=(const DListHook &) { return *this; }
+
+    bool isLinked() const { return list != 0; }
+};
+
+/*
+ * IntrusiveDList<T, Hook>: a doubly linked list of objects that carry their own links, in the
+ * member "Hook" (a DListHook). The list does not own the objects, never copies them and never
+ * allocates:
+ *  >> add / addFirst / insertBefore / remove / removeFirst / removeLast: a few pointer updates;
+ *  >> remove(item) and contains(item) are O(1) from the item itself, no search;
+ *  >> clear() and the destructor unlink the items, they do not delete them; an item must be
+ *     removed from its lists before it is destroyed.
+ * Iterator and ConstIterator work as DLinkedList's (begin / end, ++ / --, *, ->, remove()), and are
+ * bidirectional iterators for the standard algorithms; *it is the object itself, T &.
+ *
+ * Example:
+ *  struct Product { string name; DListHook lowStock, recent; };
+ *  IntrusiveDList<Product, &Product::lowStock> lowStock;
+ *  IntrusiveDList<Product, &Product::recent> recent;
+ *  lowStock.add(product);
+ *  recent.addFirst(product); // the same object, in both lists
+ *  lowStock.remove(product); // O(1)
+ */
+template <class T, DListHook T::*Hook>
+class IntrusiveDList
+{
+public:
+    class Iterator;      // Forward declaration
+    class ConstIterator; // Forward declaration
+
+protected:
+    DListHook head; // sentinel: head.next is the first item, head.prev the last one
+    int count;
+
+public:
+    IntrusiveDList();
+    ~IntrusiveDList();
+
+    void add(T &item);      // at the end
+    void addFirst(T &item); // at the front
+    void insertBefore(Iterator pos, T &item);
+    bool remove(T &item); // false (nothing changes) if "item" is not in this list
+    T &removeFirst();
+    T &removeLast();
+    T &first();
+    T &last();
+    bool empty();
+    int size();
+    void clear();
+    T &get(int index);
+    int indexOf(const T &item);   // the position of this object (not of an equal one), or -1
+    bool contains(const T &item); // this object (not an equal one) is in this list
+    string toString(string (*item2str)(T &) = 0);
+    void writeTo(Writer &writer, string (*item2str)(T &) = 0);
+
+    void println(string (*item2str)(T &) = 0)
+    {
+        cout << toString(item2str) << endl;
+    }
+
+    // isLinked(item): true when "item" is in a list through Hook (this one or another)
+    static bool isLinked(const T &item)
+    {
+        return (item.*Hook).isLinked();
+    }
+
+    Iterator begin()
+    {
+        return Iterator(this, head.next);
+    }
+    Iterator end()
+    {
+        return Iterator(this, &head);
+    }
+    ConstIterator begin() const
+    {
+        return ConstIterator(head.next);
+    }
+    ConstIterator end() const
+    {
+        return ConstIterator(&head);
+    }
+    ConstIterator cbegin() const
+    {
+        return ConstIterator(head.next);
+    }
+    ConstIterator cend() const
+    {
+        return ConstIterator(&head);
+    }
+
+    // an item has one link per hook, so it cannot be in a copy of the list too
+    IntrusiveDList(const IntrusiveDList<T, Hook> &list) = delete;
+    IntrusiveDList<T, Hook> &operator=(const IntrusiveDList<T, Hook> &list) = delete;
+
+protected:
+    void checkNotLinked(const T &item);
+    void checkNotEmpty();
+    void link(T &item, DListHook *before);
+    static void unlink(DListHook *hook);
+    static T *itemOf(const DListHook *hook) { return static_cast<T *>(hook->item); }
+
+    //////////////////////////////////////////////////////////////////////
+    ////////////////////////  INNER CLASSES DEFNITION ////////////////////
+    //////////////////////////////////////////////////////////////////////
+public:
+    class Iterator
+    {
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+    private:
+        IntrusiveDList<T, Hook> *pList;
+        DListHook *pHook;
+        friend class ConstIterator;
+        friend class IntrusiveDList<T, Hook>;
+
+    public:
+        Iterator(IntrusiveDList<T, Hook> *pList = 0, DListHook *pHook = 0)
+        {
+            this->pList = pList;
+            this->pHook = pHook;
+        }
+        /* unlink the current item; the iterator moves back, so ++ goes to the next item
+         *   Throws std::out_of_range on end(), std::invalid_argument if the item is no longer in pList
+         */
+        void remove()
+        {
+            if (pList == 0 || pHook == 0 || pHook->list != pList)
+                throw invalid_argument("Iterator does not belong to the list!");
+            if (pHook == &pList->head)
+                throw out_of_range("Cannot remove end()!");
+            DListHook *pPrev = pHook->prev;
+            unlink(pHook);
+            pList->count -= 1;
+            pHook = pPrev;
+        }
+
+        T &operator*() const
+        {
+            return *itemOf(pHook);
+        }
+        T *operator->() const
+        {
+            return itemOf(pHook);
+        }
+        bool operator==(const Iterator &iterator) const
+        {
+            return pHook == iterator.pHook;
+        }
+        bool operator!=(const Iterator &iterator) const
+        {
+            return pHook != iterator.pHook;
+        }
+        // Prefix ++ overload
+        Iterator &operator++()
+        {
+            pHook = pHook->next;
+            return *this;
+        }
+        // Postfix ++ overload
+        Iterator operator++(int)
+        {
+            Iterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+        Iterator &operator--()
+        {
+            pHook = pHook->prev;
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator iterator = *this;
+            --*this;
+            return iterator;
+        }
+    };
+
+    class ConstIterator
+    {
+    public:
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+    private:
+        const DListHook *pHook;
+
+    public:
+        ConstIterator(const DListHook *pHook = 0)
+        {
+            this->pHook = pHook;
+        }
+        ConstIterator(const Iterator &iterator)
+        {
+            pHook = iterator.pHook;
+        }
+
+        const T &operator*() const
+        {
+            return *itemOf(pHook);
+        }
+        const T *operator->() const
+        {
+            return itemOf(pHook);
+        }
+        bool operator==(const ConstIterator &iterator) const
+        {
+            return pHook == iterator.pHook;
+        }
+        bool operator!=(const ConstIterator &iterator) const
+        {
+            return pHook != iterator.pHook;
+        }
+        ConstIterator &operator++()
+        {
+            pHook = pHook->next;
+            return *this;
+        }
+        ConstIterator operator++(int)
+        {
+            ConstIterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+        ConstIterator &operator--()
+        {
+            pHook = pHook->prev;
+            return *this;
+        }
+        ConstIterator operator--(int)
+        {
+            ConstIterator iterator = *this;
+            --*this;
+            return iterator;
+        }
+    };
+};
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class T, DListHook T::*Hook>
+IntrusiveDList<T, Hook>::IntrusiveDList() : count(0)
+{
+    head.next = &head;
+    head.prev = &head;
+    head.list = this;
+}
+
+template <class T, DListHook T::*Hook>
+IntrusiveDList<T, Hook>::~IntrusiveDList()
+{
+    clear();
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::add(T &item)
+{
+    checkNotLinked(item);
+    link(item, &head);
+    count++;
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::addFirst(T &item)
+{
+    checkNotLinked(item);
+    link(item, head.next);
+    count++;
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::insertBefore(Iterator pos, T &item)
+{
+    if (pos.pList != this || pos.pHook == 0)
+    {
+        throw invalid_argument("Iterator does not belong to the list!");
+    }
+    checkNotLinked(item);
+    link(item, pos.pHook);
+    count++;
+}
+
+template <class T, DListHook T::*Hook>
+bool IntrusiveDList<T, Hook>::remove(T &item)
+{
+    if ((item.*Hook).list != this)
+    {
+        return false;
+    }
+    unlink(&(item.*Hook));
+    count--;
+    return true;
+}
+
+template <class T, DListHook T::*Hook>
+T &IntrusiveDList<T, Hook>::removeFirst()
+{
+    checkNotEmpty();
+    T *item = itemOf(head.next);
+    unlink(head.next);
+    count--;
+    return *item;
+}
+
+template <class T, DListHook T::*Hook>
+T &IntrusiveDList<T, Hook>::removeLast()
+{
+    checkNotEmpty();
+    T *item = itemOf(head.prev);
+    unlink(head.prev);
+    count--;
+    return *item;
+}
+
+template <class T, DListHook T::*Hook>
+T &IntrusiveDList<T, Hook>::first()
+{
+    checkNotEmpty();
+    return *itemOf(head.next);
+}
+
+template <class T, DListHook T::*Hook>
+T &IntrusiveDList<T, Hook>::last()
+{
+    checkNotEmpty();
+    return *itemOf(head.prev);
+}
+
+template <class T, DListHook T::*Hook>
+bool IntrusiveDList<T, Hook>::empty()
+{
+    return count == 0;
+}
+
+template <class T, DListHook T::*Hook>
+int IntrusiveDList<T, Hook>::size()
+{
+    return count;
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::clear()
+{
+    DListHook *hook = head.next;
+    while (hook != &head)
+    {
+        DListHook *nextHook = hook->next;
+        hook->next = 0;
+        hook->prev = 0;
+        hook->list = 0;
+        hook->item = 0;
+        hook = nextHook;
+    }
+    head.next = &head;
+    head.prev = &head;
+    count = 0;
+}
+
+template <class T, DListHook T::*Hook>
+T &IntrusiveDList<T, Hook>::get(int index)
+{
+    if (index < 0 || index >= count)
+        throw out_of_range("Index is out of range!");
+    // from the nearer end
+    DListHook *hook;
+    if (index <= count / 2)
+    {
+        hook = head.next;
+        for (int i = 0; i < index; i++)
+            hook = hook->next;
+    }
+    else
+    {
+        hook = head.prev;
+        for (int i = count - 1; i > index; i--)
+            hook = hook->prev;
+    }
+    return *itemOf(hook);
+}
+
+template <class T, DListHook T::*Hook>
+int IntrusiveDList<T, Hook>::indexOf(const T &item)
+{
+    const DListHook *target = &(item.*Hook);
+    int index = 0;
+    for (DListHook *hook = head.next; hook != &head; hook = hook->next)
+    {
+        if (hook == target)
+        {
+            return index;
+        }
+        index++;
+    }
+    return -1;
+}
+
+template <class T, DListHook T::*Hook>
+bool IntrusiveDList<T, Hook>::contains(const T &item)
+{
+    return (item.*Hook).list == this;
+}
+
+template <class T, DListHook T::*Hook>
+string IntrusiveDList<T, Hook>::toString(string (*item2str)(T &))
+{
+    StringWriter writer;
+    writeTo(writer, item2str);
+    return writer.str();
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::writeTo(Writer &writer, string (*item2str)(T &))
+{
+    writer.put('[');
+    for (DListHook *hook = head.next; hook != &head; hook = hook->next)
+    {
+        if (item2str != 0)
+            writer.write(item2str(*itemOf(hook)));
+        else
+            writeItem(writer, *itemOf(hook));
+        if (hook->next != &head)
+            writer.write(", ", 2);
+    }
+    writer.put(']');
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::checkNotLinked(const T &item)
+{
+    if (isLinked(item))
+        throw invalid_argument("Item is already in a list!");
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::checkNotEmpty()
+{
+    if (count == 0)
+        throw out_of_range("List is empty!");
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::link(T &item, DListHook *before)
+{
+    DListHook *hook = &(item.*Hook);
+    hook->list = this;
+    hook->item = &item;
+    hook->next = before;
+    hook->prev = before->prev;
+    before->prev->next = hook;
+    before->prev = hook;
+}
+
+template <class T, DListHook T::*Hook>
+void IntrusiveDList<T, Hook>::unlink(DListHook *hook)
+{
+    hook->prev->next = hook->next;
+    hook->next->prev = hook->prev;
+    hook->next = 0;
+    hook->prev = 0;
+    hook->list = 0;
+    hook->item = 0;
+}
+
+#endif /* INTRUSIVEDLIST_H */
@@ -0,0 +1,106 @@
+/*
+ * File:   ListPolicies.h
+ */
+
+#ifndef LISTPOLICIES_H
+#define LISTPOLICIES_H
+using namespace std;
+
+/*
+ * Policies of XArrayList<T, Equal, Deleter> and DLinkedList<T, Equal, Deleter>: classes given as
+ * template arguments, so the compiler can inline the comparisons and the destruction.
+ *
+ * Equal: compares two items, as equal(lhs, rhs), in indexOf, contains and removeItem.
+ *  >> ItemEqualFunction<T> (default): the function pointer "itemEqual" given to the constructor,
+ *     or operator== when it is NULL (the lists' historical behavior);
+ *  >> OperatorEqual<T>: operator==, no pointer test and no indirect call;
+ *  >> any class with a "bool operator()(T &, T &)", e.g. one comparing what two pointers point to.
+ *
+ * Deleter: called with the list, deleter(list), when the list is destroyed or assigned, before its
+ * own storage is freed: it releases what the items own (when T is a pointer type).
+ *  >> DeleteUserDataHook (default): the function pointer "deleteUserData" given to the constructor,
+ *     e.g. &XArrayList<Point *>::free, or nothing when it is NULL;
+ *  >> NoDelete: nothing;
+ *  >> DeleteItems: "delete item" for every item.
+ *
+ * Example:
+ *  XArrayList<int, OperatorEqual<int>, NoDelete> ids;              // inlined ==
+ *  XArrayList<Point *, PointPtrEqual, DeleteItems> owned;           // owns its points
+ *  XArrayList<Point *> points(&XArrayList<Point *>::free, &Point::pointEQ); // function pointers
+ */
+template <class T>
+struct ItemEqualFunction
+{
+    bool (*function)(T &, T &);
+
+    ItemEqualFunction(bool (*function)(T &, T &) = 0) : function(function) {}
+    bool operator()(T &lhs, T &rhs) const
+    {
+        return function == 0 ? lhs == rhs : function(lhs, rhs);
+    }
+};
+
+template <class T>
+struct OperatorEqual
+{
+    bool operator()(const T &lhs, const T &rhs) const { return lhs == rhs; }
+};
+
+/* usesOperatorEqual(equal): true when "equal" compares with operator==, so faster paths that rely
+ * on it (e.g. SIMD search) can be used
+ */
+template <class Equal>
+bool usesOperatorEqual(const Equal &equal) { return false; }
+template <class T>
+bool usesOperatorEqual(const ItemEqualFunction<T> &equal) { return equal.function == 0; }
+template <class T>
+bool usesOperatorEqual(const OperatorEqual<T> &equal) { return true; }
+
+// marker: the default Deleter, see DeleteUserDataFunction
+struct DeleteUserDataHook
+{
+};
+
+// the deleter of a list whose Deleter is DeleteUserDataHook: a function pointer, maybe NULL
+template <class List>
+struct DeleteUserDataFunction
+{
+    void (*function)(List *);
+
+    DeleteUserDataFunction(void (*function)(List *) = 0) : function(function) {}
+    void operator()(List *list) const
+    {
+        if (function != 0)
+            function(list);
+    }
+};
+
+struct NoDelete
+{
+    template <class List>
+    void operator()(List *list) const {}
+};
+
+struct DeleteItems
+{
+    template <class List>
+    void operator()(List *list) const
+    {
+        for (typename List::Iterator it = list->begin(); it != list->end(); it++)
+            delete *it;
+    }
+};
+
+// DeleterOf<Deleter, List>::type: the object a list stores for its Deleter
+template <class Deleter, class List>
+struct DeleterOf
+{
+    typedef Deleter type;
+};
+template <class List>
+struct DeleterOf<DeleteUserDataHook, List>
+{
+    typedef DeleteUserDataFunction<List> type;
+};
+
+#endif /* LISTPOLICIES_H */
@@ -0,0 +1,276 @@
+/*
+ * File:   SmallArrayList.h
+ */
+
+#ifndef SMALLARRAYLIST_H
+#define SMALLARRAYLIST_H
+#include "list/IList.h"
+#include "util/Writer.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+using namespace std;
+
+/*
+ * SmallArrayList<T, N>: an array list whose first N items are stored inside the object itself
+ * (small-buffer optimization); the items move to a heap array only when more than N are added.
+ *  >> a list of at most N items costs no allocation beyond the object's own;
+ *  >> past N, it grows like XArrayList (capacity doubled); it never moves back inline, except
+ *     through clear() or an assignment from a list of at most N items;
+ *  >> begin() / end() are plain pointers: contiguous, random-access;
+ *  >> removeAt, removeItem and clear reset the slots they empty to T(), so the items they held
+ *     (e.g. the heap buffer of a long string) are freed at once, not when the slot is reused.
+ * Items are compared with operator== (indexOf, contains, removeItem) and written with writeItem
+ * (toString), as XArrayList does without itemEqual / item2str.
+ *
+ * Example:
+ *  SmallArrayList<InventoryAttribute, 4> row; // 4 attributes inline
+ *  row.add(InventoryAttribute("weight", 10));
+ */
+template <class T, int N>
+class SmallArrayList : public IList<T>
+{
+    static_assert(N > 0, "SmallArrayList needs room for at least one inline item");
+
+protected:
+    T *data;         // inlineItems, or a heap array once more than N items were stored
+    int capacity;    // N while inline
+    int count;
+    T inlineItems[N];
+
+public:
+    SmallArrayList();
+    SmallArrayList(const SmallArrayList<T, N> &list);
+    SmallArrayList<T, N> &operator=(const SmallArrayList<T, N> &list);
+    ~SmallArrayList();
+
+    // Inherit from IList: BEGIN
+    void add(T e);
+    void add(int index, T e);
+    T removeAt(int index);
+    bool removeItem(T item, void (*removeItemData)(T) = 0);
+    bool empty();
+    int size();
+    void clear();
+    T &get(int index);
+    int indexOf(T item);
+    bool contains(T item);
+    string toString(string (*item2str)(T &) = 0);
+    // Inherit from IList: END
+
+    void writeTo(Writer &writer, string (*item2str)(T &) = 0);
+
+    /* reserve(capacity): room for "capacity" items without growing again (no effect if there is
+     * already enough); isInline(): true while the items are stored inside the object
+     */
+    void reserve(int capacity);
+    bool isInline() const { return data == inlineItems; }
+    int getCapacity() const { return capacity; }
+
+    T *begin() { return data; }
+    T *end() { return data + count; }
+    const T *begin() const { return data; }
+    const T *end() const { return data + count; }
+
+protected:
+    void checkIndex(int index); // 0 <= index < size()
+    void ensureCapacity(int index);
+    void copyFrom(const SmallArrayList<T, N> &list);
+    void removeInternalData();
+};
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class T, int N>
+SmallArrayList<T, N>::SmallArrayList() : data(inlineItems), capacity(N), count(0)
+{
+}
+
+template <class T, int N>
+SmallArrayList<T, N>::SmallArrayList(const SmallArrayList<T, N> &list) : data(inlineItems), capacity(N), count(0)
+{
+    copyFrom(list);
+}
+
+template <class T, int N>
+SmallArrayList<T, N> &SmallArrayList<T, N>::operator=(const SmallArrayList<T, N> &list)
+{
+    if (this != &list)
+    {
+        removeInternalData();
+        copyFrom(list);
+    }
+    return *this;
+}
+
+template <class T, int N>
+SmallArrayList<T, N>::~SmallArrayList()
+{
+    if (!isInline())
+        delete[] data;
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::add(T e)
+{
+    ensureCapacity(count);
+    data[count++] = std::move(e);
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::add(int index, T e)
+{
+    if (index < 0 || index > count)
+        throw out_of_range("Index out of range");
+    ensureCapacity(count);
+    for (int i = count; i > index; i--)
+        data[i] = std::move(data[i - 1]);
+    data[index] = std::move(e);
+    count++;
+}
+
+template <class T, int N>
+T SmallArrayList<T, N>::removeAt(int index)
+{
+    checkIndex(index);
+    T removedItem = std::move(data[index]);
+    for (int i = index; i < count - 1; i++)
+        data[i] = std::move(data[i + 1]);
+    data[count - 1] = T();
+    count--;
+    return removedItem;
+}
+
+template <class T, int N>
+bool SmallArrayList<T, N>::removeItem(T item, void (*removeItemData)(T))
+{
+    int idx = indexOf(item);
+    if (idx == -1)
+        return false;
+    T removedItem = removeAt(idx);
+    if (removeItemData != nullptr)
+        removeItemData(removedItem);
+    return true;
+}
+
+template <class T, int N>
+bool SmallArrayList<T, N>::empty()
+{
+    return count == 0;
+}
+
+template <class T, int N>
+int SmallArrayList<T, N>::size()
+{
+    return count;
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::clear()
+{
+    removeInternalData();
+}
+
+template <class T, int N>
+T &SmallArrayList<T, N>::get(int index)
+{
+    checkIndex(index);
+    return data[index];
+}
+
+template <class T, int N>
+int SmallArrayList<T, N>::indexOf(T item)
+{
+    for (int i = 0; i < count; i++)
+        if (data[i] == item)
+            return i;
+    return -1;
+}
+
+template <class T, int N>
+bool SmallArrayList<T, N>::contains(T item)
+{
+    return indexOf(item) != -1;
+}
+
+template <class T, int N>
+string SmallArrayList<T, N>::toString(string (*item2str)(T &))
+{
+    StringWriter writer;
+    writeTo(writer, item2str);
+    return writer.str();
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::writeTo(Writer &writer, string (*item2str)(T &))
+{
+    writer.put('[');
+    for (int i = 0; i < count; i++)
+    {
+        if (item2str != nullptr)
+            writer.write(item2str(data[i]));
+        else
+            writeItem(writer, data[i]);
+        if (i < count - 1)
+            writer.write(", ", 2);
+    }
+    writer.put(']');
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::reserve(int newCapacity)
+{
+    if (newCapacity <= capacity)
+        return;
+    T *newData = new T[newCapacity];
+    for (int i = 0; i < count; i++)
+        newData[i] = std::move(data[i]);
+    if (!isInline())
+        delete[] data;
+    data = newData;
+    capacity = newCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+template <class T, int N>
+void SmallArrayList<T, N>::checkIndex(int index)
+{
+    if (index < 0 || index >= count)
+        throw out_of_range("Index out of range");
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::ensureCapacity(int index)
+{
+    if (index >= capacity)
+        reserve(capacity * 2);
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::copyFrom(const SmallArrayList<T, N> &list)
+{
+    // this list is empty and inline: the copy stays inline whenever the items fit
+    reserve(list.count);
+    for (int i = 0; i < list.count; i++)
+        data[i] = list.data[i];
+    count = list.count;
+}
+
+template <class T, int N>
+void SmallArrayList<T, N>::removeInternalData()
+{
+    if (!isInline())
+        delete[] data;
+    else
+        for (int i = 0; i < count; i++)
+            inlineItems[i] = T();
+    data = inlineItems;
+    capacity = N;
+    count = 0;
+}
+
+#endif /* SMALLARRAYLIST_H */
@@ -0,0 +1,354 @@
+/*
+ * File:   SortedArrayList.h
+ */
+
+#ifndef SORTEDARRAYLIST_H
+#define SORTEDARRAYLIST_H
+#include "list/IList.h"
+#include "util/Writer.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+/*
+ * SortedArrayList<T, Compare>: an array list kept in the order of Compare (std::less<T> by default),
+ * so lookups are binary searches.
+ *  >> add(e): inserts "e" after the items equivalent to it (O(log n) search, O(n) move);
+ *  >> indexOf / contains / removeItem: O(log n) search; two items are equal when neither compares
+ *     before the other (Compare, not operator==);
+ *  >> lowerBound / upperBound(item): first index whose item is not before / is after "item";
+ *     range(low, high): a copy of the items in [low, high], countRange(low, high) their number;
+ *  >> addAll(first, last): merges a batch in one pass, O(n + k) when the batch is sorted (it is
+ *     sorted first otherwise).
+ * For trivially copyable T (numbers, pointers) the search is branchless: the step is a conditional
+ * move, not a mispredicted jump.
+ *
+ * add(index, e) keeps the IList contract only when "e" belongs at "index" (std::invalid_argument
+ * otherwise). get(index) returns a reference, as IList requires: changing an item's key through it
+ * breaks the order.
+ *
+ * Example:
+ *  SortedArrayList<string> skus;
+ *  skus.add("SKU-42");
+ *  skus.contains("SKU-7"); // binary search
+ */
+template <class T, class Compare = less<T>>
+class SortedArrayList : public IList<T>
+{
+protected:
+    T *data;
+    int capacity;
+    int count;
+    Compare compare;
+
+public:
+    SortedArrayList(Compare compare = Compare(), int capacity = 10);
+    SortedArrayList(const SortedArrayList<T, Compare> &list);
+    SortedArrayList<T, Compare> &operator=(const SortedArrayList<T, Compare> &list);
+    ~SortedArrayList();
+
+    // Inherit from IList: BEGIN
+    void add(T e);
+    void add(int index, T e);
+    T removeAt(int index);
+    bool removeItem(T item, void (*removeItemData)(T) = 0);
+    bool empty();
+    int size();
+    void clear();
+    T &get(int index);
+    int indexOf(T item);
+    bool contains(T item);
+    string toString(string (*item2str)(T &) = 0);
+    // Inherit from IList: END
+
+    void writeTo(Writer &writer, string (*item2str)(T &) = 0);
+
+    int lowerBound(const T &item) const;
+    int upperBound(const T &item) const;
+    int countRange(const T &low, const T &high) const;
+    SortedArrayList<T, Compare> range(const T &low, const T &high) const;
+
+    template <class Iterator>
+    void addAll(Iterator first, Iterator last);
+    void addAll(const T *items, int k) { addAll(items, items + k); } // IList::addAll, merged
+
+    const T *begin() const { return data; }
+    const T *end() const { return data + count; }
+
+protected:
+    void checkIndex(int index); // 0 <= index < size()
+    void ensureCapacity(int capacity);
+    void copyFrom(const SortedArrayList<T, Compare> &list);
+};
+
+//////////////////////////////////////////////////////////////////////
+////////////////////////     METHOD DEFNITION      ///////////////////
+//////////////////////////////////////////////////////////////////////
+
+template <class T, class Compare>
+SortedArrayList<T, Compare>::SortedArrayList(Compare compare, int capacity) : compare(compare)
+{
+    this->capacity = capacity > 0 ? capacity : 1;
+    this->count = 0;
+    this->data = new T[this->capacity];
+}
+
+template <class T, class Compare>
+SortedArrayList<T, Compare>::SortedArrayList(const SortedArrayList<T, Compare> &list) : compare(list.compare)
+{
+    copyFrom(list);
+}
+
+template <class T, class Compare>
+SortedArrayList<T, Compare> &SortedArrayList<T, Compare>::operator=(const SortedArrayList<T, Compare> &list)
+{
+    if (this != &list)
+    {
+        delete[] data;
+        compare = list.compare;
+        copyFrom(list);
+    }
+    return *this;
+}
+
+template <class T, class Compare>
+SortedArrayList<T, Compare>::~SortedArrayList()
+{
+    delete[] data;
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::add(T e)
+{
+    int index = upperBound(e);
+    ensureCapacity(count + 1);
+    for (int i = count; i > index; i--)
+        data[i] = std::move(data[i - 1]);
+    data[index] = std::move(e);
+    count++;
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::add(int index, T e)
+{
+    if (index < 0 || index > count)
+        throw out_of_range("Index out of range");
+    if ((index > 0 && compare(e, data[index - 1])) || (index < count && compare(data[index], e)))
+        throw invalid_argument("SortedArrayList: the item does not belong at this index");
+    ensureCapacity(count + 1);
+    for (int i = count; i > index; i--)
+        data[i] = std::move(data[i - 1]);
+    data[index] = std::move(e);
+    count++;
+}
+
+template <class T, class Compare>
+T SortedArrayList<T, Compare>::removeAt(int index)
+{
+    checkIndex(index);
+    T removedItem = std::move(data[index]);
+    for (int i = index; i < count - 1; i++)
+        data[i] = std::move(data[i + 1]);
+    count--;
+    return removedItem;
+}
+
+template <class T, class Compare>
+bool SortedArrayList<T, Compare>::removeItem(T item, void (*removeItemData)(T))
+{
+    int idx = indexOf(item);
+    if (idx == -1)
+        return false;
+    T removedItem = removeAt(idx);
+    if (removeItemData != nullptr)
+        removeItemData(removedItem);
+    return true;
+}
+
+template <class T, class Compare>
+bool SortedArrayList<T, Compare>::empty()
+{
+    return count == 0;
+}
+
+template <class T, class Compare>
+int SortedArrayList<T, Compare>::size()
+{
+    return count;
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::clear()
+{
+    count = 0;
+}
+
+template <class T, class Compare>
+T &SortedArrayList<T, Compare>::get(int index)
+{
+    checkIndex(index);
+    return data[index];
+}
+
+template <class T, class Compare>
+int SortedArrayList<T, Compare>::indexOf(T item)
+{
+    int index = lowerBound(item);
+    return index < count && !compare(item, data[index]) ? index : -1;
+}
+
+template <class T, class Compare>
+bool SortedArrayList<T, Compare>::contains(T item)
+{
+    return indexOf(item) != -1;
+}
+
+template <class T, class Compare>
+string SortedArrayList<T, Compare>::toString(string (*item2str)(T &))
+{
+    StringWriter writer;
+    writeTo(writer, item2str);
+    return writer.str();
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::writeTo(Writer &writer, string (*item2str)(T &))
+{
+    writer.put('[');
+    for (int i = 0; i < count; i++)
+    {
+        if (item2str != nullptr)
+            writer.write(item2str(data[i]));
+        else
+            writeItem(writer, data[i]);
+        if (i < count - 1)
+            writer.write(", ", 2);
+    }
+    writer.put(']');
+}
+
+template <class T, class Compare>
+int SortedArrayList<T, Compare>::lowerBound(const T &item) const
+{
+    if constexpr (is_trivially_copyable<T>::value)
+    {
+        if (count == 0)
+            return 0;
+        // the answer stays in [base, base + n]; each step halves n without a branch on the data
+        const T *base = data;
+        int n = count;
+        while (n > 1)
+        {
+            int half = n / 2;
+            base = compare(base[half], item) ? base + half : base;
+            n -= half;
+        }
+        return (int)(base - data) + (compare(*base, item) ? 1 : 0);
+    }
+    else
+        return (int)(lower_bound(data, data + count, item, compare) - data);
+}
+
+template <class T, class Compare>
+int SortedArrayList<T, Compare>::upperBound(const T &item) const
+{
+    if constexpr (is_trivially_copyable<T>::value)
+    {
+        if (count == 0)
+            return 0;
+        const T *base = data;
+        int n = count;
+        while (n > 1)
+        {
+            int half = n / 2;
+            base = compare(item, base[half]) ? base : base + half;
+            n -= half;
+        }
+        return (int)(base - data) + (compare(item, *base) ? 0 : 1);
+    }
+    else
+        return (int)(upper_bound(data, data + count, item, compare) - data);
+}
+
+template <class T, class Compare>
+int SortedArrayList<T, Compare>::countRange(const T &low, const T &high) const
+{
+    int begin = lowerBound(low), end = upperBound(high);
+    return end > begin ? end - begin : 0;
+}
+
+template <class T, class Compare>
+SortedArrayList<T, Compare> SortedArrayList<T, Compare>::range(const T &low, const T &high) const
+{
+    int begin = lowerBound(low), end = upperBound(high);
+    SortedArrayList<T, Compare> result(compare, end > begin ? end - begin : 1);
+    for (int i = begin; i < end; i++)
+        result.data[result.count++] = data[i];
+    return result;
+}
+
+template <class T, class Compare>
+template <class Iterator>
+void SortedArrayList<T, Compare>::addAll(Iterator first, Iterator last)
+{
+    long k = (long)distance(first, last);
+    if (k == 0)
+        return;
+    T *batch = new T[k];
+    copy(first, last, batch);
+    if (!is_sorted(batch, batch + k, compare))
+        stable_sort(batch, batch + k, compare);
+
+    // merge from the back, into the grown array: every item moves once
+    ensureCapacity(count + (int)k);
+    int i = count - 1, j = (int)k - 1, out = count + (int)k - 1;
+    while (j >= 0)
+    {
+        if (i >= 0 && compare(batch[j], data[i]))
+            data[out--] = std::move(data[i--]);
+        else
+            data[out--] = std::move(batch[j--]);
+    }
+    count += (int)k;
+    delete[] batch;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::checkIndex(int index)
+{
+    if (index < 0 || index >= count)
+        throw out_of_range("Index out of range");
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::ensureCapacity(int needed)
+{
+    if (needed <= capacity)
+        return;
+    int newCapacity = capacity * 2 > needed ? capacity * 2 : needed;
+    T *newData = new T[newCapacity];
+    for (int i = 0; i < count; i++)
+        newData[i] = std::move(data[i]);
+    delete[] data;
+    data = newData;
+    capacity = newCapacity;
+}
+
+template <class T, class Compare>
+void SortedArrayList<T, Compare>::copyFrom(const SortedArrayList<T, Compare> &list)
+{
+    this->capacity = list.capacity;
+    this->count = list.count;
+    this->data = new T[this->capacity];
+    for (int i = 0; i < list.count; i++)
+        this->data[i] = list.data[i];
+}
+
+#endif /* SORTEDARRAYLIST_H */
@@ -5,32 +5,47 @@
 #ifndef XARRAYLIST_H
 #define XARRAYLIST_H
 #include "list/IList.h"
+#include "util/Writer.h"
+#include "util/Simd.h"
+#include "list/ListPolicies.h"
 #include <memory.h>
 #include <sstream>
 #include <iostream>
 #include <type_traits>
+#include <utility>
+#include <iterator>
+#include <cstddef>
 using namespace std;
 
-template <class T>
+/*
+ * XArrayList<T, Equal, Deleter>: a dynamic array list. Equal compares the items and Deleter
+ * releases what they own; both default to the function pointers given to the constructor (see
+ * list/ListPolicies.h).
+ */
+template <class T, class Equal = ItemEqualFunction<T>, class Deleter = DeleteUserDataHook>
 class XArrayList : public IList<T>
 {
 public:
-    class Iterator; // forward declaration
+    class Iterator;      // forward declaration
+    class ConstIterator; // forward declaration
+
+    // what the list stores for Deleter: for DeleteUserDataHook, a void (*)(XArrayList *)
+    typedef typename DeleterOf<Deleter, XArrayList<T, Equal, Deleter>>::type DeleterType;
 
 protected:
-    T *data;                                 // dynamic array to store the list's items
-    int capacity;                            // size of the dynamic array
-    int count;                               // number of items stored in the array
-    bool (*itemEqual)(T &lhs, T &rhs);       // function pointer: test if two items (type: T&) are equal or not
-    void (*deleteUserData)(XArrayList<T> *); // function pointer: be called to remove items (if they are pointer type)
+    T *data;                    // dynamic array to store the list's items
+    int capacity;               // size of the dynamic array
+    int count;                  // number of items stored in the array
+    Equal itemEqual;            // test if two items (type: T&) are equal or not
+    DeleterType deleteUserData; // be called to remove items (if they are pointer type)
 
 public:
     XArrayList(
-        void (*deleteUserData)(XArrayList<T> *) = 0,
-        bool (*itemEqual)(T &, T &) = 0,
+        DeleterType deleteUserData = DeleterType(),
+        Equal itemEqual = Equal(),
         int capacity = 10);
-    XArrayList(const XArrayList<T> &list);
-    XArrayList<T> &operator=(const XArrayList<T> &list);
+    XArrayList(const XArrayList<T, Equal, Deleter> &list);
+    XArrayList<T, Equal, Deleter> &operator=(const XArrayList<T, Equal, Deleter> &list);
     ~XArrayList();
 
     // Inherit from IList: BEGIN
@@ -47,11 +62,41 @@ public:
     string toString(string (*item2str)(T &) = 0);
     // Inherit from IList: BEGIN
 
+    void writeTo(Writer &writer, string (*item2str)(T &) = 0);
+
+    /* countOf(item): number of items equal to "item"
+     * indexOfAll(item): indices of the items equal to "item", in increasing order
+     * As indexOf, they compare with itemEqual; when it is operator== (no function pointer given, or
+     * OperatorEqual), lists of int, unsigned int, float and double are scanned with SIMD compares
+     * (util/Simd.h).
+     */
+    int countOf(T item);
+    XArrayList<int> indexOfAll(T item);
+
+    /* Bulk operations (see IList): the array grows at most once and the other items move once.
+     *  >> addAll / insertRange(index, first, last): any forward iterators (pointers, iterators of
+     *     an XArrayList, DLinkedList, std::vector, ...) over items that are not in this list
+     *  >> removeIf(predicate): any callable bool(T &), inlined; the items kept are moved down in
+     *     the same pass
+     *  >> removeRange / removeIf reset the slots they empty to T(), so the items they held are
+     *     released now rather than when the slots are overwritten
+     */
+    void addAll(const T *items, int k);
+    void insertRange(int index, const T *items, int k);
+    void removeRange(int from, int to, void (*removeItemData)(T) = 0);
+    int removeIf(bool (*predicate)(T &), void (*removeItemData)(T) = 0);
+    template <class ForwardIterator>
+    void addAll(ForwardIterator first, ForwardIterator last);
+    template <class ForwardIterator>
+    void insertRange(int index, ForwardIterator first, ForwardIterator last);
+    template <class Predicate>
+    int removeIf(Predicate predicate, void (*removeItemData)(T) = 0);
+
     void println(string (*item2str)(T &) = 0)
     {
         cout << toString(item2str) << endl;
     }
-    void setDeleteUserDataPtr(void (*deleteUserData)(XArrayList<T> *) = 0)
+    void setDeleteUserDataPtr(DeleterType deleteUserData = DeleterType())
     {
         this->deleteUserData = deleteUserData;
     }
@@ -64,6 +109,22 @@ public:
     {
         return Iterator(this, count);
     }
+    ConstIterator begin() const
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator end() const
+    {
+        return ConstIterator(this, count);
+    }
+    ConstIterator cbegin() const
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator cend() const
+    {
+        return ConstIterator(this, count);
+    }
 
     /** free:
      * if T is pointer type:
@@ -72,10 +133,11 @@ public:
      * Example:
      *  XArrayList<Point*> list(&XArrayList<Point*>::free);
      *  => Destructor will call free via function pointer "deleteUserData"
+     *  (the Deleter policy DeleteItems does the same, without the function pointer)
      */
-    static void free(XArrayList<T> *list)
+    static void free(XArrayList<T, Equal, Deleter> *list)
     {
-        typename XArrayList<T>::Iterator it = list->begin();
+        typename XArrayList<T, Equal, Deleter>::Iterator it = list->begin();
         while (it != list->end())
         {
             delete *it;
@@ -103,16 +165,15 @@ protected:
      *      (2): must define a method for comparing
      *           the content pointed by two pointers of type T
      *          See: definition of "equals" of class Point for more detail
+     * All of this is the default Equal policy, ItemEqualFunction<T>; with another Equal (e.g.
+     * OperatorEqual<T>, or a functor comparing pointed-to items), the call below is inlined.
      */
-    static bool equals(T &lhs, T &rhs, bool (*itemEqual)(T &, T &))
+    static bool equals(T &lhs, T &rhs, const Equal &itemEqual)
     {
-        if (itemEqual == 0)
-            return lhs == rhs;
-        else
-            return itemEqual(lhs, rhs);
+        return itemEqual(lhs, rhs);
     }
 
-    void copyFrom(const XArrayList<T> &list);
+    void copyFrom(const XArrayList<T, Equal, Deleter> &list);
 
     void removeInternalData();
 
@@ -121,14 +182,26 @@ protected:
     //////////////////////////////////////////////////////////////////////
 public:
     // Iterator: BEGIN
+    /* Iterator, ConstIterator: random-access iterators (std::iterator_traits, std::sort,
+     * std::lower_bound, parallel algorithms, ...). An iterator is a position in the list: it stays
+     * valid while the list grows, but moves with removals before it.
+     */
     class Iterator
     {
+    public:
+        typedef random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
     private:
         int cursor;
-        XArrayList<T> *pList;
+        XArrayList<T, Equal, Deleter> *pList;
+        friend class ConstIterator;
 
     public:
-        Iterator(XArrayList<T> *pList = 0, int index = 0)
+        Iterator(XArrayList<T, Equal, Deleter> *pList = 0, int index = 0)
         {
             this->pList = pList;
             this->cursor = index;
@@ -147,14 +220,42 @@ public:
             cursor -= 1; // MUST keep index of previous, for ++ later
         }
 
-        T &operator*()
+        T &operator*() const
         {
             return pList->data[cursor];
         }
-        bool operator!=(const Iterator &iterator)
+        T *operator->() const
+        {
+            return &pList->data[cursor];
+        }
+        T &operator[](difference_type n) const
+        {
+            return pList->data[cursor + n];
+        }
+        bool operator==(const Iterator &iterator) const
+        {
+            return cursor == iterator.cursor;
+        }
+        bool operator!=(const Iterator &iterator) const
         {
             return cursor != iterator.cursor;
         }
+        bool operator<(const Iterator &iterator) const
+        {
+            return cursor < iterator.cursor;
+        }
+        bool operator>(const Iterator &iterator) const
+        {
+            return cursor > iterator.cursor;
+        }
+        bool operator<=(const Iterator &iterator) const
+        {
+            return cursor <= iterator.cursor;
+        }
+        bool operator>=(const Iterator &iterator) const
+        {
+            return cursor >= iterator.cursor;
+        }
         // Prefix ++ overload
         Iterator &operator++()
         {
@@ -168,6 +269,154 @@ public:
             ++*this;
             return iterator;
         }
+        Iterator &operator--()
+        {
+            this->cursor--;
+            return *this;
+        }
+        Iterator operator--(int)
+        {
+            Iterator iterator = *this;
+            --*this;
+            return iterator;
+        }
+        Iterator &operator+=(difference_type n)
+        {
+            cursor += (int)n;
+            return *this;
+        }
+        Iterator &operator-=(difference_type n)
+        {
+            cursor -= (int)n;
+            return *this;
+        }
+        Iterator operator+(difference_type n) const
+        {
+            return Iterator(pList, cursor + (int)n);
+        }
+        Iterator operator-(difference_type n) const
+        {
+            return Iterator(pList, cursor - (int)n);
+        }
+        friend Iterator operator+(difference_type n, const Iterator &iterator)
+        {
+            return iterator + n;
+        }
+        difference_type operator-(const Iterator &iterator) const
+        {
+            return cursor - iterator.cursor;
+        }
+    };
+
+    class ConstIterator
+    {
+    public:
+        typedef random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+    private:
+        int cursor;
+        const XArrayList<T, Equal, Deleter> *pList;
+
+    public:
+        ConstIterator(const XArrayList<T, Equal, Deleter> *pList = 0, int index = 0)
+        {
+            this->pList = pList;
+            this->cursor = index;
+        }
+        ConstIterator(const Iterator &iterator)
+        {
+            this->pList = iterator.pList;
+            this->cursor = iterator.cursor;
+        }
+
+        const T &operator*() const
+        {
+            return pList->data[cursor];
+        }
+        const T *operator->() const
+        {
+            return &pList->data[cursor];
+        }
+        const T &operator[](difference_type n) const
+        {
+            return pList->data[cursor + n];
+        }
+        bool operator==(const ConstIterator &iterator) const
+        {
+            return cursor == iterator.cursor;
+        }
+        bool operator!=(const ConstIterator &iterator) const
+        {
+            return cursor != iterator.cursor;
+        }
+        bool operator<(const ConstIterator &iterator) const
+        {
+            return cursor < iterator.cursor;
+        }
+        bool operator>(const ConstIterator &iterator) const
+        {
+            return cursor > iterator.cursor;
+        }
+        bool operator<=(const ConstIterator &iterator) const
+        {
+            return cursor <= iterator.cursor;
+        }
+        bool operator>=(const ConstIterator &iterator) const
+        {
+            return cursor >= iterator.cursor;
+        }
+        ConstIterator &operator++()
+        {
+            this->cursor++;
+            return *this;
+        }
+        ConstIterator operator++(int)
+        {
+            ConstIterator iterator = *this;
+            ++*this;
+            return iterator;
+        }
+        ConstIterator &operator--()
+        {
+            this->cursor--;
+            return *this;
+        }
+        ConstIterator operator--(int)
+        {
+            ConstIterator iterator = *this;
+            --*this;
+            return iterator;
+        }
+        ConstIterator &operator+=(difference_type n)
+        {
+            cursor += (int)n;
+            return *this;
+        }
+        ConstIterator &operator-=(difference_type n)
+        {
+            cursor -= (int)n;
+            return *this;
+        }
+        ConstIterator operator+(difference_type n) const
+        {
+            return ConstIterator(pList, cursor + (int)n);
+        }
+        ConstIterator operator-(difference_type n) const
+        {
+            return ConstIterator(pList, cursor - (int)n);
+        }
+        friend ConstIterator operator+(difference_type n, const ConstIterator &iterator)
+        {
+            return iterator + n;
+        }
+        difference_type operator-(const ConstIterator &iterator) const
+        {
+            return cursor - iterator.cursor;
+        }
     };
     // Iterator: END
 };
@@ -176,21 +425,19 @@ public:
 ////////////////////////     METHOD DEFNITION      ///////////////////
 //////////////////////////////////////////////////////////////////////
 
-template <class T>
-XArrayList<T>::XArrayList(
-    void (*deleteUserData)(XArrayList<T> *),
-    bool (*itemEqual)(T &, T &),
-    int capacity)
+template <class T, class Equal, class Deleter>
+XArrayList<T, Equal, Deleter>::XArrayList(
+    DeleterType deleteUserData,
+    Equal itemEqual,
+    int capacity) : itemEqual(itemEqual), deleteUserData(deleteUserData)
 {
     this->capacity = capacity;
     this->count = 0;
     this->data = new T[capacity]();
-    this->deleteUserData = deleteUserData;
-    this->itemEqual = itemEqual;
 }
 
-template <class T>
-void XArrayList<T>::copyFrom(const XArrayList<T> &list)
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::copyFrom(const XArrayList<T, Equal, Deleter> &list)
 {
     /*
      * Copies the contents of another XArrayList into this list.
@@ -210,35 +457,29 @@ void XArrayList<T>::copyFrom(const XArrayList<T> &list)
     this->deleteUserData = list.deleteUserData;
 }
 
-template <class T>
-void XArrayList<T>::removeInternalData()
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::removeInternalData()
 {
     /*
      * Clears the internal data of the list by deleting the dynamic array and any user-defined data.
-     * If a custom deletion function is provided, it is used to free the stored elements.
-     * Finally, the dynamic array itself is deallocated from memory.
+     * The Deleter (by default, the deletion function given to the constructor, if any) frees the
+     * stored elements. Finally, the dynamic array itself is deallocated from memory.
      */
-    if (deleteUserData != nullptr)
-    {
-        deleteUserData(this);
-    }
-    else
-    {
-        delete[] data;
-    }
+    deleteUserData(this);
+    delete[] data;
     data = nullptr;
     count = 0;
     capacity = 0;
 }
 
-template <class T>
-XArrayList<T>::XArrayList(const XArrayList<T> &list)
+template <class T, class Equal, class Deleter>
+XArrayList<T, Equal, Deleter>::XArrayList(const XArrayList<T, Equal, Deleter> &list)
 {
     copyFrom(list);
 }
 
-template <class T>
-XArrayList<T> &XArrayList<T>::operator=(const XArrayList<T> &list)
+template <class T, class Equal, class Deleter>
+XArrayList<T, Equal, Deleter> &XArrayList<T, Equal, Deleter>::operator=(const XArrayList<T, Equal, Deleter> &list)
 {
     if (this != &list)
     {
@@ -248,21 +489,21 @@ XArrayList<T> &XArrayList<T>::operator=(const XArrayList<T> &list)
     return *this;
 }
 
-template <class T>
-XArrayList<T>::~XArrayList()
+template <class T, class Equal, class Deleter>
+XArrayList<T, Equal, Deleter>::~XArrayList()
 {
     removeInternalData();
 }
 
-template <class T>
-void XArrayList<T>::add(T e)
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::add(T e)
 {
     ensureCapacity(count);
     data[count++] = e;
 }
 
-template <class T>
-void XArrayList<T>::add(int index, T e)
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::add(int index, T e)
 {
     checkIndex(index);
     ensureCapacity(count);
@@ -276,8 +517,8 @@ void XArrayList<T>::add(int index, T e)
     count++;
 }
 
-template <class T>
-T XArrayList<T>::removeAt(int index)
+template <class T, class Equal, class Deleter>
+T XArrayList<T, Equal, Deleter>::removeAt(int index)
 {
     checkIndex(index);
 
@@ -290,8 +531,8 @@ T XArrayList<T>::removeAt(int index)
     return removedItem;
 }
 
-template <class T>
-bool XArrayList<T>::removeItem(T item, void (*removeItemData)(T))
+template <class T, class Equal, class Deleter>
+bool XArrayList<T, Equal, Deleter>::removeItem(T item, void (*removeItemData)(T))
 {
     int idx = indexOf(item);
     if (idx != -1)
@@ -306,34 +547,39 @@ bool XArrayList<T>::removeItem(T item, void (*removeItemData)(T))
     return false;
 }
 
-template <class T>
-bool XArrayList<T>::empty()
+template <class T, class Equal, class Deleter>
+bool XArrayList<T, Equal, Deleter>::empty()
 {
     return count == 0;
 }
 
-template <class T>
-int XArrayList<T>::size()
+template <class T, class Equal, class Deleter>
+int XArrayList<T, Equal, Deleter>::size()
 {
     return count;
 }
 
-template <class T>
-void XArrayList<T>::clear()
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::clear()
 {
     count = 0;
 }
 
-template <class T>
-T &XArrayList<T>::get(int index)
+template <class T, class Equal, class Deleter>
+T &XArrayList<T, Equal, Deleter>::get(int index)
 {
     checkIndex(index);
     return data[index];
 }
 
-template <class T>
-int XArrayList<T>::indexOf(T item)
+template <class T, class Equal, class Deleter>
+int XArrayList<T, Equal, Deleter>::indexOf(T item)
 {
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        if (usesOperatorEqual(itemEqual))
+            return simdIndexOf(data, count, item);
+    }
     for (int i = 0; i < count; i++)
     {
         if (equals(data[i], item, itemEqual))
@@ -343,14 +589,161 @@ int XArrayList<T>::indexOf(T item)
     }
     return -1;
 }
-template <class T>
-bool XArrayList<T>::contains(T item)
+template <class T, class Equal, class Deleter>
+bool XArrayList<T, Equal, Deleter>::contains(T item)
 {
     return indexOf(item) != -1;
 }
 
-template <class T>
-string XArrayList<T>::toString(string (*item2str)(T &))
+template <class T, class Equal, class Deleter>
+int XArrayList<T, Equal, Deleter>::countOf(T item)
+{
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        if (usesOperatorEqual(itemEqual))
+            return simdCount(data, count, item);
+    }
+    int matches = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (equals(data[i], item, itemEqual))
+        {
+            matches++;
+        }
+    }
+    return matches;
+}
+
+template <class T, class Equal, class Deleter>
+XArrayList<int> XArrayList<T, Equal, Deleter>::indexOfAll(T item)
+{
+    XArrayList<int> indices(0, 0, countOf(item) + 1);
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        if (usesOperatorEqual(itemEqual))
+        {
+            simdForEachMatch(data, count, item, [&](int index)
+                             { indices.add(index); });
+            return indices;
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (equals(data[i], item, itemEqual))
+        {
+            indices.add(i);
+        }
+    }
+    return indices;
+}
+
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::addAll(const T *items, int k)
+{
+    insertRange(count, items, items + k);
+}
+
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::insertRange(int index, const T *items, int k)
+{
+    insertRange(index, items, items + k);
+}
+
+template <class T, class Equal, class Deleter>
+template <class ForwardIterator>
+void XArrayList<T, Equal, Deleter>::addAll(ForwardIterator first, ForwardIterator last)
+{
+    insertRange(count, first, last);
+}
+
+template <class T, class Equal, class Deleter>
+template <class ForwardIterator>
+void XArrayList<T, Equal, Deleter>::insertRange(int index, ForwardIterator first, ForwardIterator last)
+{
+    checkIndex(index);
+    int k = (int)distance(first, last);
+    if (k <= 0)
+    {
+        return;
+    }
+    ensureCapacity(count + k - 1);
+
+    // Dời phần đuôi sang phải k vị trí một lần, rồi chép k phần tử vào khoảng trống
+    for (int i = count - 1; i >= index; i--)
+    {
+        data[i + k] = std::move(data[i]);
+    }
+    for (int i = index; first != last; ++first, ++i)
+    {
+        data[i] = *first;
+    }
+    count += k;
+}
+
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::removeRange(int from, int to, void (*removeItemData)(T))
+{
+    if (from < 0 || from > to || to > count)
+    {
+        throw out_of_range("Range is out of range!");
+    }
+    if (removeItemData != 0)
+    {
+        for (int i = from; i < to; i++)
+        {
+            removeItemData(data[i]);
+        }
+    }
+    int k = to - from;
+    for (int i = to; i < count; i++)
+    {
+        data[i - k] = std::move(data[i]);
+    }
+    for (int i = count - k; i < count; i++)
+    {
+        data[i] = T();
+    }
+    count -= k;
+}
+
+template <class T, class Equal, class Deleter>
+int XArrayList<T, Equal, Deleter>::removeIf(bool (*predicate)(T &), void (*removeItemData)(T))
+{
+    return removeIf<bool (*)(T &)>(predicate, removeItemData);
+}
+
+template <class T, class Equal, class Deleter>
+template <class Predicate>
+int XArrayList<T, Equal, Deleter>::removeIf(Predicate predicate, void (*removeItemData)(T))
+{
+    // "kept" is where the next item to keep goes: every kept item moves at most once
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!predicate(data[i]))
+        {
+            if (kept != i)
+            {
+                data[kept] = std::move(data[i]);
+            }
+            kept++;
+        }
+        else if (removeItemData != 0)
+        {
+            removeItemData(data[i]);
+        }
+    }
+    for (int i = kept; i < count; i++)
+    {
+        data[i] = T();
+    }
+    int removed = count - kept;
+    count = kept;
+    return removed;
+}
+
+template <class T, class Equal, class Deleter>
+string XArrayList<T, Equal, Deleter>::toString(string (*item2str)(T &))
 {
     /**
      * Converts the array list into a string representation, formatting each element using a user-defined function.
@@ -360,33 +753,42 @@ string XArrayList<T>::toString(string (*item2str)(T &))
      * @param item2str A function pointer for converting items of type T to strings. If null, default to the string conversion of T.
      * @return A string representation of the array list with elements separated by commas and enclosed in square brackets.
      */
+    StringWriter writer;
+    writeTo(writer, item2str);
+    return writer.str();
+}
 
-    stringstream ss;
-    ss << "[";
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::writeTo(Writer &writer, string (*item2str)(T &))
+{
+    /**
+     * Appends the text returned by toString to "writer", without building intermediate strings
+     * (except the ones returned by item2str).
+     */
+    writer.put('[');
     for (int i = 0; i < count; i++)
     {
         if (item2str != nullptr)
         {
-            ss << item2str(data[i]);
+            writer.write(item2str(data[i]));
         }
         else
         {
-            ss << data[i];
+            writeItem(writer, data[i]);
         }
         if (i < count - 1)
         {
-            ss << ", ";
+            writer.write(", ", 2);
         }
     }
-    ss << "]";
-    return ss.str();
+    writer.put(']');
 }
 
 //////////////////////////////////////////////////////////////////////
 //////////////////////// (private) METHOD DEFNITION //////////////////
 //////////////////////////////////////////////////////////////////////
-template <class T>
-void XArrayList<T>::checkIndex(int index)
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::checkIndex(int index)
 {
     /**
      * Validates whether the given index is within the valid range of the list.
@@ -398,20 +800,25 @@ void XArrayList<T>::checkIndex(int index)
         throw out_of_range("Index out of range");
     }
 }
-template <class T>
-void XArrayList<T>::ensureCapacity(int index)
+template <class T, class Equal, class Deleter>
+void XArrayList<T, Equal, Deleter>::ensureCapacity(int index)
 {
     /**
      * Ensures that the list has enough capacity to accommodate the given index.
      * If the index is out of range, it throws an std::out_of_range exception. If the index exceeds the current capacity,
-     * reallocates the internal array with increased capacity, copying the existing elements to the new array.
+     * reallocates the internal array with increased capacity, moving the existing elements to the new array
+     * (element-wise, so that types owning heap memory such as std::string stay valid).
+     * The capacity doubles, or grows to index + 1 at once when that is more (insertRange).
      * In case of memory allocation failure, catches std::bad_alloc.
      */
     if (index >= capacity)
     {
-        int newCapacity = capacity * 2;
+        int newCapacity = capacity * 2 > index ? capacity * 2 : index + 1;
         T *newData = new T[newCapacity];
-        memcpy(newData, data, count * sizeof(T));
+        for (int i = 0; i < count; i++)
+        {
+            newData[i] = std::move(data[i]);
+        }
         delete[] data;
         data = newData;
         capacity = newCapacity;
@@ -0,0 +1,107 @@
+/*
+ * File:   AllocCounter.h
+ */
+
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+/*
+ * AllocCounter: counts the calls to the global operator new / delete made by the current thread.
+ *
+ * The counting allocation functions are in src/alloc_counter.cpp: linking it into a program
+ * REPLACES the program's global operator new / delete (they count, then call malloc /
+ * posix_memalign / free). It is opt-in, and linked once per program: run.sh links it (the test
+ * cases check allocation budgets), bench.sh only with -DINVENTORY_STATS. Without it the counters
+ * stay 0. Including this header replaces nothing.
+ *
+ * Counters are per thread: a Scope measures the allocations of the code it encloses, whatever
+ * other threads do meanwhile.
+ *
+ * Example:
+ *  AllocCounter::Scope scope;
+ *  list.add(x);
+ *  cout << scope.allocations() << " allocations, " << scope.bytes() << " bytes" << endl;
+ */
+class AllocCounter
+{
+public:
+    // totals of the calling thread since it started
+    static long allocations() { return counts().allocations; }
+    static long deallocations() { return counts().deallocations; }
+    static long bytes() { return counts().bytes; }
+
+    class Scope
+    {
+    private:
+        long allocations0, deallocations0, bytes0;
+
+    public:
+        Scope() { restart(); }
+        void restart()
+        {
+            allocations0 = AllocCounter::allocations();
+            deallocations0 = AllocCounter::deallocations();
+            bytes0 = AllocCounter::bytes();
+        }
+        long allocations() const { return AllocCounter::allocations() - allocations0; }
+        long deallocations() const { return AllocCounter::deallocations() - deallocations0; }
+        long bytes() const { return AllocCounter::bytes() - bytes0; }
+    };
+
+    // called by the replaced operators (src/alloc_counter.cpp)
+    static void countAllocation(size_t size)
+    {
+        Counts &c = counts();
+        c.allocations++;
+        c.bytes += (long)size;
+    }
+    static void countDeallocation()
+    {
+        counts().deallocations++;
+    }
+
+private:
+    struct Counts
+    {
+        long allocations;
+        long deallocations;
+        long bytes;
+    };
+    static Counts &counts()
+    {
+        // trivially constructible: usable from operator new at any point of a thread's life
+        static thread_local Counts threadCounts = {0, 0, 0};
+        return threadCounts;
+    }
+
+public:
+    static void *allocate(size_t size)
+    {
+        countAllocation(size);
+        return malloc(size == 0 ? 1 : size);
+    }
+    static void *allocateAligned(size_t size, size_t alignment)
+    {
+        countAllocation(size);
+        void *p = nullptr;
+        if (alignment < sizeof(void *))
+            alignment = sizeof(void *);
+        if (posix_memalign(&p, alignment, size == 0 ? 1 : size) != 0)
+            return nullptr;
+        return p;
+    }
+    static void release(void *p)
+    {
+        if (p != nullptr)
+        {
+            countDeallocation();
+            free(p);
+        }
+    }
+};
+
+#endif /* ALLOC_COUNTER_H */
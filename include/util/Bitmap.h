@@ -0,0 +1,218 @@
+/*
+ * File:   Bitmap.h
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+using namespace std;
+
+/*
+ * Bitmap: a fixed-size set of integers in [0, size), one bit each (dense).
+ *  >> set / reset / test are O(1);
+ *  >> &=, |=, andNot and count run over 64-bit words, in loops the compiler vectorizes;
+ *  >> forEach(f) calls f(i) for every i in the set, in increasing order.
+ *  >> resize / erase change the size: a bitmap can follow a list whose items are added and removed
+ *     (erase(i) shifts the bits above i down by one, in O(size / 64)).
+ * Binary operations require bitmaps of the same size (std::invalid_argument otherwise).
+ */
+class Bitmap
+{
+private:
+    uint64_t *words;
+    int numBits;
+    int numWords;
+    int capacity; // allocated words; the bits from numBits on are always 0
+
+public:
+    Bitmap(int size = 0);
+    Bitmap(const Bitmap &other);
+    Bitmap &operator=(const Bitmap &other);
+    ~Bitmap();
+
+    int size() const { return numBits; }
+    void set(int index) { words[index >> 6] |= (uint64_t)1 << (index & 63); }
+    void reset(int index) { words[index >> 6] &= ~((uint64_t)1 << (index & 63)); }
+    bool test(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+
+    void clear();
+    void fill(); // every integer of [0, size)
+    void resize(int size); // new integers are not in the set
+    void erase(int index); // remove integer "index"; the ones above it decrease by 1
+    long count() const;
+    bool empty() const;
+
+    Bitmap &operator&=(const Bitmap &other);
+    Bitmap &operator|=(const Bitmap &other);
+    Bitmap &andNot(const Bitmap &other); // remove the integers of other
+
+    template <class Function>
+    void forEach(Function f) const;
+
+private:
+    void checkSize(const Bitmap &other) const;
+};
+
+// -------------------- Bitmap Method Definitions --------------------
+Bitmap::Bitmap(int size)
+{
+    if (size < 0)
+        throw invalid_argument("Bitmap size must not be negative");
+    numBits = size;
+    numWords = (size + 63) / 64;
+    capacity = numWords > 0 ? numWords : 1;
+    words = new uint64_t[capacity]();
+}
+
+Bitmap::Bitmap(const Bitmap &other)
+{
+    numBits = other.numBits;
+    numWords = other.numWords;
+    capacity = numWords > 0 ? numWords : 1;
+    words = new uint64_t[capacity]();
+    memcpy(words, other.words, numWords * sizeof(uint64_t));
+}
+
+Bitmap &Bitmap::operator=(const Bitmap &other)
+{
+    if (this != &other)
+    {
+        if (capacity < other.numWords)
+        {
+            delete[] words;
+            capacity = other.numWords;
+            words = new uint64_t[capacity];
+        }
+        memset(words, 0, capacity * sizeof(uint64_t));
+        numBits = other.numBits;
+        numWords = other.numWords;
+        memcpy(words, other.words, numWords * sizeof(uint64_t));
+    }
+    return *this;
+}
+
+Bitmap::~Bitmap()
+{
+    delete[] words;
+}
+
+void Bitmap::clear()
+{
+    memset(words, 0, numWords * sizeof(uint64_t));
+}
+
+void Bitmap::fill()
+{
+    memset(words, 0xFF, numWords * sizeof(uint64_t));
+    if (numBits % 64 != 0)
+        words[numWords - 1] = ((uint64_t)1 << (numBits % 64)) - 1;
+}
+
+void Bitmap::resize(int size)
+{
+    if (size < 0)
+        throw invalid_argument("Bitmap size must not be negative");
+    int needed = (size + 63) / 64;
+    if (needed > capacity)
+    {
+        int grown = capacity * 2 > needed ? capacity * 2 : needed;
+        uint64_t *moved = new uint64_t[grown]();
+        memcpy(moved, words, numWords * sizeof(uint64_t));
+        delete[] words;
+        words = moved;
+        capacity = grown;
+    }
+    if (size < numBits)
+    {
+        // clear the bits beyond the new size
+        memset(words + needed, 0, (numWords - needed) * sizeof(uint64_t));
+        if (size % 64 != 0)
+            words[needed - 1] &= ((uint64_t)1 << (size % 64)) - 1;
+    }
+    numBits = size;
+    numWords = needed;
+}
+
+void Bitmap::erase(int index)
+{
+    if (index < 0 || index >= numBits)
+        throw out_of_range("Index is out of range!");
+    int w = index >> 6;
+    uint64_t below = ((uint64_t)1 << (index & 63)) - 1;
+    words[w] = (words[w] & below) | ((words[w] >> 1) & ~below);
+    for (int i = w; i < numWords - 1; i++)
+    {
+        words[i] |= words[i + 1] << 63;
+        words[i + 1] >>= 1;
+    }
+    numBits--;
+    numWords = (numBits + 63) / 64;
+}
+
+long Bitmap::count() const
+{
+    long n = 0;
+    for (int i = 0; i < numWords; i++)
+        n += __builtin_popcountll(words[i]);
+    return n;
+}
+
+bool Bitmap::empty() const
+{
+    uint64_t any = 0;
+    for (int i = 0; i < numWords; i++)
+        any |= words[i];
+    return any == 0;
+}
+
+Bitmap &Bitmap::operator&=(const Bitmap &other)
+{
+    checkSize(other);
+    for (int i = 0; i < numWords; i++)
+        words[i] &= other.words[i];
+    return *this;
+}
+
+Bitmap &Bitmap::operator|=(const Bitmap &other)
+{
+    checkSize(other);
+    for (int i = 0; i < numWords; i++)
+        words[i] |= other.words[i];
+    return *this;
+}
+
+Bitmap &Bitmap::andNot(const Bitmap &other)
+{
+    checkSize(other);
+    for (int i = 0; i < numWords; i++)
+        words[i] &= ~other.words[i];
+    return *this;
+}
+
+template <class Function>
+void Bitmap::forEach(Function f) const
+{
+    for (int i = 0; i < numWords; i++)
+    {
+        uint64_t word = words[i];
+        while (word != 0)
+        {
+            f(i * 64 + __builtin_ctzll(word));
+            word &= word - 1; // clear the lowest set bit
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+void Bitmap::checkSize(const Bitmap &other) const
+{
+    if (other.numBits != numBits)
+        throw invalid_argument("Bitmaps have different sizes");
+}
+
+#endif /* BITMAP_H */
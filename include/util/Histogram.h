@@ -0,0 +1,106 @@
+/*
+ * File:   Histogram.h
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <stdint.h>
+using namespace std;
+
+/*
+ * LatencyHistogram: HDR-style histogram of non-negative integer values (e.g. nanoseconds).
+ *
+ * Buckets are log-linear: every power of two [2^e, 2^(e+1)) is split into 16 equal sub-buckets,
+ * so a recorded value is known within 1/16 (6.25%) whatever its magnitude; values below 16 are
+ * exact. Values up to 2^48 are covered (3 days in ns); larger ones go to the last bucket.
+ *
+ *  >> record is lock-free (relaxed atomic increments) and may be called from many threads;
+ *  >> percentile(p) returns the highest value of the bucket holding the p-th percentile.
+ */
+class LatencyHistogram
+{
+public:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_EXPONENT = 47;
+    static const int NUM_BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS;
+
+private:
+    atomic<uint64_t> buckets[NUM_BUCKETS];
+    atomic<uint64_t> total;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> maximum;
+
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t value)
+    {
+        buckets[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        sum.fetch_add(value, memory_order_relaxed);
+        uint64_t current = maximum.load(memory_order_relaxed);
+        while (value > current && !maximum.compare_exchange_weak(current, value, memory_order_relaxed))
+            ;
+    }
+    void reset()
+    {
+        for (int i = 0; i < NUM_BUCKETS; i++)
+            buckets[i].store(0, memory_order_relaxed);
+        total.store(0, memory_order_relaxed);
+        sum.store(0, memory_order_relaxed);
+        maximum.store(0, memory_order_relaxed);
+    }
+
+    uint64_t count() const { return total.load(memory_order_relaxed); }
+    uint64_t max() const { return maximum.load(memory_order_relaxed); }
+    double mean() const
+    {
+        uint64_t n = count();
+        return n == 0 ? 0.0 : (double)sum.load(memory_order_relaxed) / n;
+    }
+    // p in [0, 100]
+    uint64_t percentile(double p) const
+    {
+        uint64_t n = count();
+        if (n == 0)
+            return 0;
+        uint64_t rank = (uint64_t)(p / 100.0 * n + 0.5);
+        if (rank < 1)
+            rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++)
+        {
+            seen += buckets[i].load(memory_order_relaxed);
+            if (seen >= rank)
+            {
+                uint64_t high = highestOf(i);
+                return high < max() ? high : max();
+            }
+        }
+        return max();
+    }
+
+    static int bucketOf(uint64_t value)
+    {
+        if (value < (uint64_t)SUB_BUCKETS)
+            return (int)value;
+        int exponent = 63 - __builtin_clzll(value);
+        if (exponent > MAX_EXPONENT)
+            return NUM_BUCKETS - 1;
+        int sub = (int)(value >> (exponent - SUB_BITS)); // in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub - SUB_BUCKETS;
+    }
+    static uint64_t highestOf(int bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        int exponent = bucket / SUB_BUCKETS + SUB_BITS - 1;
+        uint64_t sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << (exponent - SUB_BITS)) - 1;
+    }
+};
+
+#endif /* HISTOGRAM_H */
@@ -0,0 +1,393 @@
+/*
+ * File:   KDTree.h
+ */
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include "list/XArrayList.h"
+#include "util/Point.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+/*
+ * KDTree: a static 3D k-d tree over a set of Points, for nearest-neighbour, k-nearest, radius and
+ * box queries in O(log n) expected (plus the size of the answer) instead of a scan.
+ *
+ *  >> built in one go (O(n log n)) from an array of points, e.g. the output of Point::genPoints;
+ *     the tree keeps its own copy of the coordinates, so the array can be freed afterwards;
+ *  >> queries answer indices into that array;
+ *  >> the tree is implicit: the points are reordered so that every range [begin, end) has its
+ *     splitting point at (begin + end) / 2, split on the axis of largest spread; ranges of at most
+ *     LEAF_SIZE points are scanned. No node pointers, 16 bytes per point.
+ *
+ * Distances are Euclidean; ties between equally near points go to the smaller index.
+ * Queries are const and may run from many threads at once.
+ *
+ * Example:
+ *  Point *bins = Point::genPoints(1000000, 0, 100, true, 1);
+ *  KDTree tree(bins, 1000000);
+ *  int nearest = tree.nearest(Point(50, 50, 0));
+ *  XArrayList<int> shelf = tree.box(Point(10, 10, 0), Point(20, 20, 5));
+ */
+class KDTree
+{
+public:
+    static const int LEAF_SIZE = 8;
+
+private:
+    struct Node
+    {
+        float x, y, z;
+        int index; // in the points given to the constructor
+    };
+    Node *nodes;
+    unsigned char *axes; // splitting axis of the range whose middle is i
+    int count;
+
+public:
+    KDTree(const Point *points, int size);
+    KDTree(const KDTree &other);
+    KDTree &operator=(const KDTree &other);
+    ~KDTree();
+
+    int size() const { return count; }
+
+    /* nearest(query): index of the point nearest to "query" (throws std::out_of_range if empty)
+     * kNearest(query, k): indices of the min(k, size()) nearest points, nearest first
+     */
+    int nearest(const Point &query) const;
+    XArrayList<int> kNearest(const Point &query, int k) const;
+
+    /* radius(query, r): indices of the points at distance <= r from "query"
+     * box(low, high): indices of the points with low.x <= x <= high.x, and the same for y and z
+     * Both in no particular order; forEachInRadius / forEachInBox call f(index) instead.
+     */
+    XArrayList<int> radius(const Point &query, float r) const;
+    XArrayList<int> box(const Point &low, const Point &high) const;
+    template <class Function>
+    void forEachInRadius(const Point &query, float r, Function f) const;
+    template <class Function>
+    void forEachInBox(const Point &low, const Point &high, Function f) const;
+
+private:
+    static float coordinate(const Node &node, int axis) { return axis == 0 ? node.x : (axis == 1 ? node.y : node.z); }
+    static float coordinate(const Point &point, int axis)
+    {
+        return axis == 0 ? point.getX() : (axis == 1 ? point.getY() : point.getZ());
+    }
+    static float distance2(const Node &node, const Point &query);
+    static bool closer(float d1, int i1, float d2, int i2) { return d1 < d2 || (d1 == d2 && i1 < i2); }
+
+    void build(int begin, int end);
+    void nearest(int begin, int end, const Point &query, float &best, int &bestIndex) const;
+    void kNearest(int begin, int end, const Point &query, int k, float *heapDistances, int *heapIndices,
+                  int &heapSize) const;
+    template <class Function>
+    void forEachInRadius(int begin, int end, const Point &query, float r2, Function &f) const;
+    template <class Function>
+    void forEachInBox(int begin, int end, const Point &low, const Point &high, Function &f) const;
+};
+
+// -------------------- KDTree Method Definitions --------------------
+KDTree::KDTree(const Point *points, int size)
+{
+    if (size < 0)
+        throw invalid_argument("KDTree size must not be negative");
+    count = size;
+    nodes = new Node[size > 0 ? size : 1];
+    axes = new unsigned char[size > 0 ? size : 1]();
+    for (int i = 0; i < size; i++)
+    {
+        nodes[i].x = points[i].getX();
+        nodes[i].y = points[i].getY();
+        nodes[i].z = points[i].getZ();
+        nodes[i].index = i;
+    }
+    build(0, size);
+}
+
+KDTree::KDTree(const KDTree &other)
+{
+    count = other.count;
+    nodes = new Node[count > 0 ? count : 1];
+    axes = new unsigned char[count > 0 ? count : 1];
+    copy(other.nodes, other.nodes + count, nodes);
+    copy(other.axes, other.axes + count, axes);
+}
+
+KDTree &KDTree::operator=(const KDTree &other)
+{
+    if (this != &other)
+    {
+        KDTree copied(other);
+        swap(nodes, copied.nodes);
+        swap(axes, copied.axes);
+        swap(count, copied.count);
+    }
+    return *this;
+}
+
+KDTree::~KDTree()
+{
+    delete[] nodes;
+    delete[] axes;
+}
+
+int KDTree::nearest(const Point &query) const
+{
+    if (count == 0)
+        throw out_of_range("KDTree is empty!");
+    float best = numeric_limits<float>::infinity();
+    int bestIndex = -1;
+    nearest(0, count, query, best, bestIndex);
+    return bestIndex;
+}
+
+XArrayList<int> KDTree::kNearest(const Point &query, int k) const
+{
+    // a max-heap of the k best so far (worst on top), sorted at the end
+    if (k > count)
+        k = count;
+    XArrayList<int> result(0, 0, k > 0 ? k : 1);
+    if (k <= 0)
+        return result;
+    float *heapDistances = new float[k];
+    int *heapIndices = new int[k];
+    int heapSize = 0;
+    kNearest(0, count, query, k, heapDistances, heapIndices, heapSize);
+
+    int *order = new int[heapSize];
+    for (int i = 0; i < heapSize; i++)
+        order[i] = i;
+    sort(order, order + heapSize, [&](int lhs, int rhs)
+         { return closer(heapDistances[lhs], heapIndices[lhs], heapDistances[rhs], heapIndices[rhs]); });
+    for (int i = 0; i < heapSize; i++)
+        result.add(heapIndices[order[i]]);
+    delete[] order;
+    delete[] heapDistances;
+    delete[] heapIndices;
+    return result;
+}
+
+XArrayList<int> KDTree::radius(const Point &query, float r) const
+{
+    XArrayList<int> result;
+    forEachInRadius(query, r, [&](int index)
+                    { result.add(index); });
+    return result;
+}
+
+XArrayList<int> KDTree::box(const Point &low, const Point &high) const
+{
+    XArrayList<int> result;
+    forEachInBox(low, high, [&](int index)
+                 { result.add(index); });
+    return result;
+}
+
+template <class Function>
+void KDTree::forEachInRadius(const Point &query, float r, Function f) const
+{
+    if (r >= 0)
+        forEachInRadius(0, count, query, r * r, f);
+}
+
+template <class Function>
+void KDTree::forEachInBox(const Point &low, const Point &high, Function f) const
+{
+    forEachInBox(0, count, low, high, f);
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+float KDTree::distance2(const Node &node, const Point &query)
+{
+    float dx = node.x - query.getX(), dy = node.y - query.getY(), dz = node.z - query.getZ();
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void KDTree::build(int begin, int end)
+{
+    if (end - begin <= LEAF_SIZE)
+        return;
+    // split on the axis of largest spread, at the median
+    float low[3], high[3];
+    for (int a = 0; a < 3; a++)
+        low[a] = high[a] = coordinate(nodes[begin], a);
+    for (int i = begin + 1; i < end; i++)
+        for (int a = 0; a < 3; a++)
+        {
+            float c = coordinate(nodes[i], a);
+            low[a] = c < low[a] ? c : low[a];
+            high[a] = c > high[a] ? c : high[a];
+        }
+    int axis = 0;
+    for (int a = 1; a < 3; a++)
+        if (high[a] - low[a] > high[axis] - low[axis])
+            axis = a;
+    int middle = (begin + end) / 2;
+    nth_element(nodes + begin, nodes + middle, nodes + end, [axis](const Node &lhs, const Node &rhs)
+                { return coordinate(lhs, axis) < coordinate(rhs, axis); });
+    axes[middle] = (unsigned char)axis;
+    build(begin, middle);
+    build(middle + 1, end);
+}
+
+void KDTree::nearest(int begin, int end, const Point &query, float &best, int &bestIndex) const
+{
+    if (end - begin <= LEAF_SIZE)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            float d = distance2(nodes[i], query);
+            if (closer(d, nodes[i].index, best, bestIndex))
+            {
+                best = d;
+                bestIndex = nodes[i].index;
+            }
+        }
+        return;
+    }
+    int middle = (begin + end) / 2;
+    int axis = axes[middle];
+    float d = distance2(nodes[middle], query);
+    if (closer(d, nodes[middle].index, best, bestIndex))
+    {
+        best = d;
+        bestIndex = nodes[middle].index;
+    }
+    float delta = coordinate(query, axis) - coordinate(nodes[middle], axis);
+    // near side first; the far side only if the splitting plane is within the best distance
+    if (delta < 0)
+    {
+        nearest(begin, middle, query, best, bestIndex);
+        if (delta * delta <= best)
+            nearest(middle + 1, end, query, best, bestIndex);
+    }
+    else
+    {
+        nearest(middle + 1, end, query, best, bestIndex);
+        if (delta * delta <= best)
+            nearest(begin, middle, query, best, bestIndex);
+    }
+}
+
+void KDTree::kNearest(int begin, int end, const Point &query, int k, float *heapDistances, int *heapIndices,
+                      int &heapSize) const
+{
+    // heap of positions 0..heapSize-1 ordered by (distance, index), the worst on top
+    auto offer = [&](const Node &node)
+    {
+        float d = distance2(node, query);
+        if (heapSize == k && !closer(d, node.index, heapDistances[0], heapIndices[0]))
+            return;
+        if (heapSize == k)
+        {
+            // pop the worst: move the last element to the top and sift it down
+            heapSize--;
+            float lastD = heapDistances[heapSize];
+            int lastI = heapIndices[heapSize];
+            int hole = 0;
+            while (true)
+            {
+                int child = 2 * hole + 1;
+                if (child >= heapSize)
+                    break;
+                if (child + 1 < heapSize && closer(heapDistances[child], heapIndices[child],
+                                                   heapDistances[child + 1], heapIndices[child + 1]))
+                    child++;
+                if (!closer(lastD, lastI, heapDistances[child], heapIndices[child]))
+                    break;
+                heapDistances[hole] = heapDistances[child];
+                heapIndices[hole] = heapIndices[child];
+                hole = child;
+            }
+            heapDistances[hole] = lastD;
+            heapIndices[hole] = lastI;
+        }
+        // push: sift up
+        int hole = heapSize++;
+        while (hole > 0)
+        {
+            int parent = (hole - 1) / 2;
+            if (!closer(heapDistances[parent], heapIndices[parent], d, node.index))
+                break;
+            heapDistances[hole] = heapDistances[parent];
+            heapIndices[hole] = heapIndices[parent];
+            hole = parent;
+        }
+        heapDistances[hole] = d;
+        heapIndices[hole] = node.index;
+    };
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        for (int i = begin; i < end; i++)
+            offer(nodes[i]);
+        return;
+    }
+    int middle = (begin + end) / 2;
+    int axis = axes[middle];
+    offer(nodes[middle]);
+    float delta = coordinate(query, axis) - coordinate(nodes[middle], axis);
+    int nearBegin = delta < 0 ? begin : middle + 1, nearEnd = delta < 0 ? middle : end;
+    int farBegin = delta < 0 ? middle + 1 : begin, farEnd = delta < 0 ? end : middle;
+    kNearest(nearBegin, nearEnd, query, k, heapDistances, heapIndices, heapSize);
+    if (heapSize < k || delta * delta <= heapDistances[0])
+        kNearest(farBegin, farEnd, query, k, heapDistances, heapIndices, heapSize);
+}
+
+template <class Function>
+void KDTree::forEachInRadius(int begin, int end, const Point &query, float r2, Function &f) const
+{
+    if (end - begin <= LEAF_SIZE)
+    {
+        for (int i = begin; i < end; i++)
+            if (distance2(nodes[i], query) <= r2)
+                f(nodes[i].index);
+        return;
+    }
+    int middle = (begin + end) / 2;
+    int axis = axes[middle];
+    if (distance2(nodes[middle], query) <= r2)
+        f(nodes[middle].index);
+    float delta = coordinate(query, axis) - coordinate(nodes[middle], axis);
+    if (delta <= 0 || delta * delta <= r2)
+        forEachInRadius(begin, middle, query, r2, f);
+    if (delta >= 0 || delta * delta <= r2)
+        forEachInRadius(middle + 1, end, query, r2, f);
+}
+
+template <class Function>
+void KDTree::forEachInBox(int begin, int end, const Point &low, const Point &high, Function &f) const
+{
+    if (end - begin <= LEAF_SIZE)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            const Node &node = nodes[i];
+            if (node.x >= low.getX() && node.x <= high.getX() && node.y >= low.getY() && node.y <= high.getY() &&
+                node.z >= low.getZ() && node.z <= high.getZ())
+                f(node.index);
+        }
+        return;
+    }
+    int middle = (begin + end) / 2;
+    int axis = axes[middle];
+    const Node &node = nodes[middle];
+    if (node.x >= low.getX() && node.x <= high.getX() && node.y >= low.getY() && node.y <= high.getY() &&
+        node.z >= low.getZ() && node.z <= high.getZ())
+        f(node.index);
+    float split = coordinate(node, axis);
+    // left of middle: coordinates <= split; right: >= split
+    if (coordinate(low, axis) <= split)
+        forEachInBox(begin, middle, low, high, f);
+    if (coordinate(high, axis) >= split)
+        forEachInBox(middle + 1, end, low, high, f);
+}
+
+#endif /* KDTREE_H */
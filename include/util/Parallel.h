@@ -0,0 +1,59 @@
+/*
+ * File:   Parallel.h
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+using namespace std;
+
+/*
+ * parallelRanges(n, threads, minPerThread, work): splits [0, n) into contiguous ranges, one per
+ * thread, and calls work(begin, end) for each; returns once all are done.
+ *  >> threads == 0: one per core;
+ *  >> fewer threads are used when a range would hold less than minPerThread items (starting a
+ *     thread costs more than it saves); with a single range, work runs on the calling thread and
+ *     nothing is allocated.
+ * The ranges depend only on n and the number of threads used: work must not depend on the split
+ * to give results that are the same for any number of threads.
+ * If work throws on the calling thread (the first range), the other threads are joined before the
+ * exception propagates; work must not throw on the other threads (std::terminate).
+ */
+template <class Function>
+void parallelRanges(long n, int threads, long minPerThread, Function work)
+{
+    if (threads <= 0)
+        threads = (int)thread::hardware_concurrency();
+    if (minPerThread < 1)
+        minPerThread = 1;
+    if (threads > n / minPerThread)
+        threads = (int)(n / minPerThread);
+    if (threads <= 1)
+    {
+        if (n > 0)
+            work(0L, n);
+        return;
+    }
+
+    // joins the started threads on return, and when work or a thread constructor throws
+    struct Workers
+    {
+        thread *threads;
+        int started;
+        ~Workers()
+        {
+            for (int t = 0; t < started; t++)
+                threads[t].join();
+            delete[] threads;
+        }
+    } workers = {new thread[threads - 1], 0};
+    for (int t = 1; t < threads; t++)
+    {
+        workers.threads[t - 1] = thread(work, n * t / threads, n * (t + 1) / threads);
+        workers.started++;
+    }
+    work(0L, n / threads);
+}
+
+#endif /* PARALLEL_H */
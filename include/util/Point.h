@@ -19,6 +19,9 @@
 #include <math.h>
 #include <random>
 #include <sstream>
+#include <stdint.h>
+#include "util/Random.h"
+#include "util/Parallel.h"
 using namespace std;
 
 #define EPSILON (1E-8)
@@ -118,6 +121,33 @@ public:
         delete engine;
         return head;
     }
+    /* Counter-based generation: point "index" of the stream of "seed" takes its x, y, z from
+     * outputs 3*index, 3*index+1, 3*index+2 of SplitMix64(seed) (see SplitMix64::at), so it
+     * depends only on (seed, index): ranges can be generated independently, on any thread, and
+     * the output is the same for any number of threads. Coordinates are in [minValue, maxValue].
+     *  >> genPoint(index, ...): one point of the stream
+     *  >> genPoints(out, begin, end, ...): points begin..end-1 into out[0..end-begin), no allocation
+     *  >> genPointsParallel(out, size, ...): points 0..size-1, the range split between "threads"
+     *     threads (0: one per core)
+     */
+    static Point genPoint(long index, float minValue, float maxValue, uint64_t seed){
+        float scale = maxValue - minValue;
+        uint64_t counter = 3 * (uint64_t)index;
+        return Point(minValue + scale * SplitMix64::toFloat(SplitMix64::at(seed, counter)),
+                     minValue + scale * SplitMix64::toFloat(SplitMix64::at(seed, counter + 1)),
+                     minValue + scale * SplitMix64::toFloat(SplitMix64::at(seed, counter + 2)));
+    }
+    static void genPoints(Point* out, long begin, long end, float minValue, float maxValue, uint64_t seed){
+        for(long idx=begin; idx < end; idx++)
+            out[idx - begin] = genPoint(idx, minValue, maxValue, seed);
+    }
+    static void genPointsParallel(Point* out, long size, float minValue, float maxValue,
+                                  uint64_t seed, int threads=0){
+        parallelRanges(size, threads, 1L << 16, [=](long begin, long end){
+            genPoints(out + begin, begin, end, minValue, maxValue, seed);
+        });
+    }
+
     static void println(Point* head, int size){
         stringstream os;
         os << "[";
@@ -130,6 +160,13 @@ public:
     }
    
 };
+// Point::pointEQ(Point*&, Point*&) as an Equal policy of XArrayList / DLinkedList (list/ListPolicies.h)
+struct PointPtrEqual{
+    bool operator()(Point*& lhs, Point*& rhs) const{
+        return *lhs == *rhs;
+    }
+};
+
 ostream &operator<<( ostream &os, const Point& point){
     os << "P(" << fixed 
             << setw(6) << setprecision(2) << point.x << "," 
@@ -0,0 +1,360 @@
+/*
+ * File:   PointCloud.h
+ */
+
+#ifndef POINTCLOUD_H
+#define POINTCLOUD_H
+
+#include "list/XArrayList.h"
+#include "util/Parallel.h"
+#include "util/Point.h"
+#include "util/Random.h"
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/*
+ * PointCloud: points stored as a structure of arrays: all x, then all y, then all z, each array
+ * 64-byte aligned and padded to a multiple of 16 floats, for batch kernels over many points.
+ *
+ *  >> radii(out): out[i] = radius of point i (Point::radius for all points)
+ *  >> distances(query, out): out[i] = distance from point i to "query"
+ *  >> indexOf(point): first point equal to "point" under Point::operator== (every coordinate within
+ *     EPSILON), or -1: the scan of XArrayList<Point>::indexOf with Point::pointEQ
+ *
+ * The kernels process 8 points per step with AVX (when compiled with -mavx or -march=native),
+ * 4 with SSE2 (any x86-64), one at a time elsewhere; they read each coordinate once, so large
+ * clouds run at memory bandwidth.
+ *
+ * genPoints(size, minValue, maxValue, seed, threads) fills the cloud with the points of
+ * Point::genPoint(index, minValue, maxValue, seed), written straight into the arrays, from several
+ * threads: the same points for any number of threads.
+ *
+ * Example:
+ *  PointCloud cloud(list);  // from an XArrayList<Point>
+ *  cloud.genPoints(n, 0, 100, seed); // or generated in place
+ *  float *radii = new float[cloud.size()];
+ *  cloud.radii(radii);
+ */
+class PointCloud
+{
+public:
+    static const int ALIGNMENT = 64; // bytes
+
+private:
+    float *xs, *ys, *zs;
+    int count;
+    int capacity; // a multiple of 16: the padding of every array is allocated
+
+public:
+    PointCloud(int capacity = 0);
+    PointCloud(const Point *points, int size);
+    PointCloud(const XArrayList<Point> &list);
+    PointCloud(const PointCloud &other);
+    PointCloud &operator=(const PointCloud &other);
+    ~PointCloud();
+
+    int size() const { return count; }
+    void add(const Point &point);
+    void clear() { count = 0; }
+    void resize(int size);
+    Point get(int index) const;
+    void set(int index, const Point &point);
+
+    // the coordinate arrays (64-byte aligned, size() valid entries)
+    float *x() { return xs; }
+    float *y() { return ys; }
+    float *z() { return zs; }
+    const float *x() const { return xs; }
+    const float *y() const { return ys; }
+    const float *z() const { return zs; }
+
+    XArrayList<Point> toList() const;
+    void genPoints(int size, float minValue, float maxValue, uint64_t seed, int threads = 0);
+
+    // batch kernels: "out" holds size() floats
+    void radii(float *out) const;
+    void distances(const Point &query, float *out) const;
+    int indexOf(const Point &point) const;
+
+private:
+    static float *allocate(int capacity);
+    static void release(float *array);
+    static float strictBound(double epsilon); // the float e with (|d| < epsilon) == (|d| < e) for floats d
+    void genRange(long begin, long end, float minValue, float maxValue, uint64_t seed);
+    void reserve(int capacity);
+    void checkIndex(int index) const;
+};
+
+// -------------------- PointCloud Method Definitions --------------------
+PointCloud::PointCloud(int capacity) : xs(nullptr), ys(nullptr), zs(nullptr), count(0), capacity(0)
+{
+    if (capacity < 0)
+        throw invalid_argument("PointCloud capacity must not be negative");
+    reserve(capacity);
+}
+
+PointCloud::PointCloud(const Point *points, int size) : xs(nullptr), ys(nullptr), zs(nullptr), count(0), capacity(0)
+{
+    if (size < 0)
+        throw invalid_argument("PointCloud size must not be negative");
+    reserve(size);
+    for (int i = 0; i < size; i++)
+    {
+        xs[i] = points[i].getX();
+        ys[i] = points[i].getY();
+        zs[i] = points[i].getZ();
+    }
+    count = size;
+}
+
+PointCloud::PointCloud(const XArrayList<Point> &list) : xs(nullptr), ys(nullptr), zs(nullptr), count(0), capacity(0)
+{
+    reserve((int)(list.cend() - list.cbegin()));
+    for (XArrayList<Point>::ConstIterator it = list.cbegin(); it != list.cend(); ++it)
+    {
+        xs[count] = it->getX();
+        ys[count] = it->getY();
+        zs[count] = it->getZ();
+        count++;
+    }
+}
+
+PointCloud::PointCloud(const PointCloud &other) : xs(nullptr), ys(nullptr), zs(nullptr), count(0), capacity(0)
+{
+    reserve(other.count);
+    memcpy(xs, other.xs, other.count * sizeof(float));
+    memcpy(ys, other.ys, other.count * sizeof(float));
+    memcpy(zs, other.zs, other.count * sizeof(float));
+    count = other.count;
+}
+
+PointCloud &PointCloud::operator=(const PointCloud &other)
+{
+    if (this != &other)
+    {
+        count = 0;
+        reserve(other.count);
+        memcpy(xs, other.xs, other.count * sizeof(float));
+        memcpy(ys, other.ys, other.count * sizeof(float));
+        memcpy(zs, other.zs, other.count * sizeof(float));
+        count = other.count;
+    }
+    return *this;
+}
+
+PointCloud::~PointCloud()
+{
+    release(xs);
+    release(ys);
+    release(zs);
+}
+
+void PointCloud::add(const Point &point)
+{
+    if (count == capacity)
+        reserve(capacity * 2 > 16 ? capacity * 2 : 16);
+    xs[count] = point.getX();
+    ys[count] = point.getY();
+    zs[count] = point.getZ();
+    count++;
+}
+
+void PointCloud::resize(int size)
+{
+    if (size < 0)
+        throw invalid_argument("PointCloud size must not be negative");
+    reserve(size);
+    for (int i = count; i < size; i++)
+        xs[i] = ys[i] = zs[i] = 0;
+    count = size;
+}
+
+Point PointCloud::get(int index) const
+{
+    checkIndex(index);
+    return Point(xs[index], ys[index], zs[index]);
+}
+
+void PointCloud::set(int index, const Point &point)
+{
+    checkIndex(index);
+    xs[index] = point.getX();
+    ys[index] = point.getY();
+    zs[index] = point.getZ();
+}
+
+XArrayList<Point> PointCloud::toList() const
+{
+    XArrayList<Point> list(0, 0, count > 0 ? count : 1);
+    for (int i = 0; i < count; i++)
+        list.add(Point(xs[i], ys[i], zs[i]));
+    return list;
+}
+
+void PointCloud::genPoints(int size, float minValue, float maxValue, uint64_t seed, int threads)
+{
+    if (size < 0)
+        throw invalid_argument("PointCloud size must not be negative");
+    reserve(size);
+    count = size;
+    parallelRanges(size, threads, 1L << 16, [this, minValue, maxValue, seed](long begin, long end)
+                   { genRange(begin, end, minValue, maxValue, seed); });
+}
+
+void PointCloud::radii(float *out) const
+{
+    int i = 0;
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_load_ps(xs + i), y = _mm256_load_ps(ys + i), z = _mm256_load_ps(zs + i);
+        __m256 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(r2));
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_load_ps(xs + i), y = _mm_load_ps(ys + i), z = _mm_load_ps(zs + i);
+        __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(r2));
+    }
+#endif
+    for (; i < count; i++)
+        out[i] = sqrtf(xs[i] * xs[i] + ys[i] * ys[i] + zs[i] * zs[i]);
+}
+
+void PointCloud::distances(const Point &query, float *out) const
+{
+    float qx = query.getX(), qy = query.getY(), qz = query.getZ();
+    int i = 0;
+#if defined(__AVX__)
+    __m256 px = _mm256_set1_ps(qx), py = _mm256_set1_ps(qy), pz = _mm256_set1_ps(qz);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_load_ps(xs + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_load_ps(ys + i), py);
+        __m256 dz = _mm256_sub_ps(_mm256_load_ps(zs + i), pz);
+        __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(d2));
+    }
+#elif defined(__SSE2__)
+    __m128 px = _mm_set1_ps(qx), py = _mm_set1_ps(qy), pz = _mm_set1_ps(qz);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_load_ps(xs + i), px);
+        __m128 dy = _mm_sub_ps(_mm_load_ps(ys + i), py);
+        __m128 dz = _mm_sub_ps(_mm_load_ps(zs + i), pz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(d2));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float dx = xs[i] - qx, dy = ys[i] - qy, dz = zs[i] - qz;
+        out[i] = sqrtf(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+int PointCloud::indexOf(const Point &point) const
+{
+    // |coordinate - point's| < EPSILON on all three axes, as Point::operator==
+    float px = point.getX(), py = point.getY(), pz = point.getZ();
+    float epsilon = strictBound(EPSILON);
+    int i = 0;
+#if defined(__AVX__)
+    __m256 vx = _mm256_set1_ps(px), vy = _mm256_set1_ps(py), vz = _mm256_set1_ps(pz);
+    __m256 ve = _mm256_set1_ps(epsilon), absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 ex = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(_mm256_load_ps(xs + i), vx), absMask), ve, _CMP_LT_OQ);
+        __m256 ey = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(_mm256_load_ps(ys + i), vy), absMask), ve, _CMP_LT_OQ);
+        __m256 ez = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(_mm256_load_ps(zs + i), vz), absMask), ve, _CMP_LT_OQ);
+        int mask = _mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(ex, ey), ez));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    __m128 vx = _mm_set1_ps(px), vy = _mm_set1_ps(py), vz = _mm_set1_ps(pz);
+    __m128 ve = _mm_set1_ps(epsilon), absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 ex = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(_mm_load_ps(xs + i), vx), absMask), ve);
+        __m128 ey = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(_mm_load_ps(ys + i), vy), absMask), ve);
+        __m128 ez = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(_mm_load_ps(zs + i), vz), absMask), ve);
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(ex, ey), ez));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; i < count; i++)
+        if (fabsf(xs[i] - px) < epsilon && fabsf(ys[i] - py) < epsilon && fabsf(zs[i] - pz) < epsilon)
+            return i;
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+float *PointCloud::allocate(int capacity)
+{
+    return static_cast<float *>(::operator new[](capacity * sizeof(float), align_val_t(ALIGNMENT)));
+}
+
+void PointCloud::release(float *array)
+{
+    if (array != nullptr)
+        ::operator delete[](array, align_val_t(ALIGNMENT));
+}
+
+float PointCloud::strictBound(double epsilon)
+{
+    float bound = (float)epsilon;
+    return (double)bound < epsilon ? nextafterf(bound, INFINITY) : bound;
+}
+
+void PointCloud::genRange(long begin, long end, float minValue, float maxValue, uint64_t seed)
+{
+    for (long i = begin; i < end; i++)
+    {
+        Point point = Point::genPoint(i, minValue, maxValue, seed);
+        xs[i] = point.getX();
+        ys[i] = point.getY();
+        zs[i] = point.getZ();
+    }
+}
+
+void PointCloud::reserve(int newCapacity)
+{
+    newCapacity = (newCapacity + 15) / 16 * 16;
+    if (newCapacity <= capacity && xs != nullptr)
+        return;
+    if (newCapacity == 0)
+        newCapacity = 16;
+    float *arrays[3] = {xs, ys, zs};
+    float *grown[3];
+    for (int a = 0; a < 3; a++)
+    {
+        grown[a] = allocate(newCapacity);
+        if (arrays[a] != nullptr)
+            memcpy(grown[a], arrays[a], count * sizeof(float));
+        release(arrays[a]);
+    }
+    xs = grown[0];
+    ys = grown[1];
+    zs = grown[2];
+    capacity = newCapacity;
+}
+
+void PointCloud::checkIndex(int index) const
+{
+    if (index < 0 || index >= count)
+        throw out_of_range("Index is out of range!");
+}
+
+#endif /* POINTCLOUD_H */
@@ -0,0 +1,147 @@
+/*
+ * File:   Random.h
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <math.h>
+#include <stdint.h>
+using namespace std;
+
+/*
+ * SplitMix64: a small, fast, seeded pseudo-random generator.
+ *  >> the same seed gives the same sequence on every platform and compiler
+ *     (unlike the std:: distributions, whose output is implementation-defined);
+ *  >> mix(x) is the stateless SplitMix64 finalizer: at(seed, i) = mix(seed + (i + 1) * GOLDEN_GAMMA)
+ *     is the i-th output of the generator seeded with "seed", so any element of a stream can be
+ *     computed independently.
+ */
+class SplitMix64
+{
+private:
+    uint64_t state;
+
+public:
+    static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    SplitMix64(uint64_t seed = 0) : state(seed) {}
+
+    static uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /* at(seed, index): the index-th output (from 0) of the generator seeded with "seed", without
+     * running it: a counter-based generator, any range of a stream can be drawn independently
+     */
+    static uint64_t at(uint64_t seed, uint64_t index)
+    {
+        return mix(seed + (index + 1) * GOLDEN_GAMMA);
+    }
+    // the top 24 bits of "bits", uniform in [0, 1): every float of that range is exact
+    static float toFloat(uint64_t bits)
+    {
+        return (float)(bits >> 40) * (1.0f / 16777216.0f);
+    }
+
+    uint64_t next()
+    {
+        state += GOLDEN_GAMMA;
+        return mix(state);
+    }
+    // uniform in [0, 1)
+    double nextDouble()
+    {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+    // uniform in [minValue, maxValue)
+    double nextDouble(double minValue, double maxValue)
+    {
+        return minValue + (maxValue - minValue) * nextDouble();
+    }
+    // uniform in [0, bound)
+    uint64_t nextInt(uint64_t bound)
+    {
+        return (uint64_t)(((unsigned __int128)next() * bound) >> 64);
+    }
+    bool nextBool(double probability)
+    {
+        return nextDouble() < probability;
+    }
+};
+
+/*
+ * ZipfDistribution: ranks 1..n, rank k drawn with probability proportional to 1 / k^s (s > 0).
+ * Uses rejection-inversion sampling (W. Hormann, G. Derflinger, 1996): O(1) per sample and
+ * no table, so n can be large.
+ */
+class ZipfDistribution
+{
+private:
+    long n;
+    double s;
+    double hIntegralX1, hIntegralN, threshold;
+
+public:
+    ZipfDistribution(long n = 1, double s = 1.0)
+    {
+        this->n = n < 1 ? 1 : n;
+        this->s = s;
+        hIntegralX1 = hIntegral(1.5) - 1.0;
+        hIntegralN = hIntegral(this->n + 0.5);
+        threshold = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+    }
+
+    long size() const { return n; }
+    double exponent() const { return s; }
+
+    // a rank in [1, n]; rank 1 is the most frequent
+    long sample(SplitMix64 &random) const
+    {
+        while (true)
+        {
+            double u = hIntegralN + random.nextDouble() * (hIntegralX1 - hIntegralN);
+            double x = hIntegralInverse(u);
+            long k = (long)(x + 0.5);
+            if (k < 1)
+                k = 1;
+            else if (k > n)
+                k = n;
+            if (k - x <= threshold || u >= hIntegral(k + 0.5) - h((double)k))
+                return k;
+        }
+    }
+
+private:
+    // h(x) = 1/x^s, hIntegral its antiderivative (log-based form is exact at s = 1)
+    double h(double x) const
+    {
+        return exp(-s * log(x));
+    }
+    double hIntegral(double x) const
+    {
+        double logX = log(x);
+        return helper2((1.0 - s) * logX) * logX;
+    }
+    double hIntegralInverse(double x) const
+    {
+        double t = x * (1.0 - s);
+        if (t < -1.0)
+            t = -1.0;
+        return exp(helper1(t) * x);
+    }
+    // log1p(x)/x and expm1(x)/x, accurate near 0
+    static double helper1(double x)
+    {
+        return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double helper2(double x)
+    {
+        return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+};
+
+#endif /* RANDOM_H */
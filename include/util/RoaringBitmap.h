@@ -0,0 +1,726 @@
+/*
+ * File:   RoaringBitmap.h
+ */
+
+#ifndef ROARINGBITMAP_H
+#define ROARINGBITMAP_H
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/*
+ * RoaringBitmap: a compressed set of 32-bit unsigned integers.
+ *
+ * Values are grouped by their high 16 bits into containers, kept sorted by that key; a container
+ * stores the low 16 bits of its values
+ *  >> as a sorted array of uint16_t while it holds at most 4096 values (2 bytes per value),
+ *  >> as a bitmap of 65536 bits (8 KB) above that.
+ * So a sparse set costs about 2 bytes per value and a dense one 1 bit per value, and
+ * &=, |= and andNot work container by container:
+ *  >> bitmap with bitmap: AVX2 (4 words) or SSE2 (2 words) and / or / andnot per instruction,
+ *     counting the result as it is written;
+ *  >> array with array: &= and andNot compare blocks of 8 values against 8 values with SSE2
+ *     (galloping binary search when the sizes differ a lot); |= is a scalar merge;
+ *  >> array with bitmap: one bit test per value.
+ * Without SSE2 (non-x86 targets) the same loops run on plain words and values.
+ *
+ *  >> add appends in O(1) when values come in increasing order (as rows of a scan do);
+ *  >> count is O(number of containers); select(rank) and forEachRange skip whole containers.
+ */
+class RoaringBitmap
+{
+private:
+    static const int ARRAY_MAX = 4096;    // more values: bitmap container
+    static const int BITMAP_WORDS = 1024; // 65536 bits
+
+    struct Container
+    {
+        uint16_t key;     // high 16 bits of the values
+        int cardinality;  // number of values
+        uint16_t *values; // array container: sorted low 16 bits (bits == nullptr)
+        int capacity;     // of values
+        uint64_t *bits;   // bitmap container (values == nullptr)
+    };
+
+    Container *containers;
+    int numContainers;
+    int capacity;
+
+public:
+    RoaringBitmap();
+    RoaringBitmap(const RoaringBitmap &other);
+    RoaringBitmap &operator=(const RoaringBitmap &other);
+    ~RoaringBitmap();
+
+    void add(uint32_t value);
+    bool contains(uint32_t value) const;
+    long count() const;
+    bool empty() const { return numContainers == 0; }
+    void clear();
+
+    RoaringBitmap &operator&=(const RoaringBitmap &other);
+    RoaringBitmap &operator|=(const RoaringBitmap &other);
+    RoaringBitmap &andNot(const RoaringBitmap &other); // remove the values of other
+    bool operator==(const RoaringBitmap &other) const;
+    bool operator!=(const RoaringBitmap &other) const { return !(*this == other); }
+
+    /* select(rank): the value with "rank" smaller values in the set (throws std::out_of_range if rank
+     *   is not in [0, count()))
+     */
+    uint32_t select(long rank) const;
+
+    /* forEach(f): f(value) for every value, in increasing order
+     * forEachRange(offset, limit, f): the same for the values of rank [offset, offset + limit) only
+     */
+    template <class Function>
+    void forEach(Function f) const;
+    template <class Function>
+    void forEachRange(long offset, long limit, Function f) const;
+
+    // memoryUsage(): bytes allocated by the set
+    long memoryUsage() const;
+
+private:
+    static Container makeArray(uint16_t key, int capacity);
+    static Container makeBitmap(uint16_t key);
+    static Container copyOf(const Container &container);
+    static void release(Container &container);
+    static void toBitmap(Container &container);
+    static void shrink(Container &container); // back to an array if small enough
+    static int popcount(const uint64_t *bits);
+    static void addLow(Container &container, uint16_t low);
+    static bool containsLow(const Container &container, uint16_t low);
+
+    enum WordOp
+    {
+        AND,
+        OR,
+        AND_NOT
+    };
+    // combineBits<OP>(result, a, b): result = a OP b, word by word; returns the number of bits set
+    template <int OP>
+    static int combineBits(uint64_t *result, const uint64_t *a, const uint64_t *b);
+    // filterArray(a, na, b, nb, keep, out): the values of a found (keep) or not found (!keep) in b
+    static int filterArray(const uint16_t *a, int na, const uint16_t *b, int nb, bool keep, uint16_t *out);
+
+    static Container intersect(const Container &a, const Container &b);
+    static Container unite(const Container &a, const Container &b);
+    static Container subtract(const Container &a, const Container &b);
+
+    int findContainer(uint16_t key) const; // position, or -(insertion point) - 1
+    Container &insertContainer(int position, const Container &container);
+    void append(const Container &container); // takes ownership; drops it if empty
+    void swap(RoaringBitmap &other);
+};
+
+// -------------------- RoaringBitmap Method Definitions --------------------
+RoaringBitmap::RoaringBitmap() : containers(nullptr), numContainers(0), capacity(0) {}
+
+RoaringBitmap::RoaringBitmap(const RoaringBitmap &other) : containers(nullptr), numContainers(0), capacity(0)
+{
+    if (other.numContainers == 0)
+        return;
+    containers = new Container[other.numContainers];
+    capacity = other.numContainers;
+    for (int i = 0; i < other.numContainers; i++)
+        containers[numContainers++] = copyOf(other.containers[i]);
+}
+
+RoaringBitmap &RoaringBitmap::operator=(const RoaringBitmap &other)
+{
+    if (this != &other)
+    {
+        RoaringBitmap copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+RoaringBitmap::~RoaringBitmap()
+{
+    clear();
+    delete[] containers;
+}
+
+void RoaringBitmap::add(uint32_t value)
+{
+    uint16_t key = (uint16_t)(value >> 16);
+    uint16_t low = (uint16_t)(value & 0xFFFF);
+    if (numContainers > 0 && containers[numContainers - 1].key == key)
+    {
+        addLow(containers[numContainers - 1], low);
+        return;
+    }
+    int position = numContainers > 0 && containers[numContainers - 1].key < key ? -numContainers - 1
+                                                                                 : findContainer(key);
+    if (position < 0)
+        addLow(insertContainer(-position - 1, makeArray(key, 4)), low);
+    else
+        addLow(containers[position], low);
+}
+
+bool RoaringBitmap::contains(uint32_t value) const
+{
+    int position = findContainer((uint16_t)(value >> 16));
+    return position >= 0 && containsLow(containers[position], (uint16_t)(value & 0xFFFF));
+}
+
+long RoaringBitmap::count() const
+{
+    long n = 0;
+    for (int i = 0; i < numContainers; i++)
+        n += containers[i].cardinality;
+    return n;
+}
+
+void RoaringBitmap::clear()
+{
+    for (int i = 0; i < numContainers; i++)
+        release(containers[i]);
+    numContainers = 0;
+}
+
+RoaringBitmap &RoaringBitmap::operator&=(const RoaringBitmap &other)
+{
+    RoaringBitmap result;
+    int i = 0, j = 0;
+    while (i < numContainers && j < other.numContainers)
+    {
+        if (containers[i].key < other.containers[j].key)
+            i++;
+        else if (containers[i].key > other.containers[j].key)
+            j++;
+        else
+            result.append(intersect(containers[i++], other.containers[j++]));
+    }
+    swap(result);
+    return *this;
+}
+
+RoaringBitmap &RoaringBitmap::operator|=(const RoaringBitmap &other)
+{
+    RoaringBitmap result;
+    int i = 0, j = 0;
+    while (i < numContainers || j < other.numContainers)
+    {
+        if (j == other.numContainers || (i < numContainers && containers[i].key < other.containers[j].key))
+            result.append(copyOf(containers[i++]));
+        else if (i == numContainers || containers[i].key > other.containers[j].key)
+            result.append(copyOf(other.containers[j++]));
+        else
+            result.append(unite(containers[i++], other.containers[j++]));
+    }
+    swap(result);
+    return *this;
+}
+
+RoaringBitmap &RoaringBitmap::andNot(const RoaringBitmap &other)
+{
+    RoaringBitmap result;
+    int j = 0;
+    for (int i = 0; i < numContainers; i++)
+    {
+        while (j < other.numContainers && other.containers[j].key < containers[i].key)
+            j++;
+        if (j < other.numContainers && other.containers[j].key == containers[i].key)
+            result.append(subtract(containers[i], other.containers[j]));
+        else
+            result.append(copyOf(containers[i]));
+    }
+    swap(result);
+    return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap &other) const
+{
+    // a container is an array exactly when it holds at most ARRAY_MAX values
+    if (numContainers != other.numContainers)
+        return false;
+    for (int i = 0; i < numContainers; i++)
+    {
+        const Container &a = containers[i], &b = other.containers[i];
+        if (a.key != b.key || a.cardinality != b.cardinality)
+            return false;
+        if (a.bits != nullptr ? memcmp(a.bits, b.bits, BITMAP_WORDS * sizeof(uint64_t)) != 0
+                              : memcmp(a.values, b.values, a.cardinality * sizeof(uint16_t)) != 0)
+            return false;
+    }
+    return true;
+}
+
+uint32_t RoaringBitmap::select(long rank) const
+{
+    if (rank >= 0)
+    {
+        uint32_t value = 0;
+        bool found = false;
+        forEachRange(rank, 1, [&](uint32_t v)
+                     { value = v;
+                       found = true; });
+        if (found)
+            return value;
+    }
+    throw out_of_range("Rank is out of range!");
+}
+
+template <class Function>
+void RoaringBitmap::forEach(Function f) const
+{
+    for (int i = 0; i < numContainers; i++)
+    {
+        const Container &container = containers[i];
+        uint32_t high = (uint32_t)container.key << 16;
+        if (container.bits == nullptr)
+        {
+            for (int k = 0; k < container.cardinality; k++)
+                f(high | container.values[k]);
+            continue;
+        }
+        for (int w = 0; w < BITMAP_WORDS; w++)
+        {
+            uint64_t word = container.bits[w];
+            while (word != 0)
+            {
+                f(high | (uint32_t)(w * 64 + __builtin_ctzll(word)));
+                word &= word - 1; // clear the lowest set bit
+            }
+        }
+    }
+}
+
+template <class Function>
+void RoaringBitmap::forEachRange(long offset, long limit, Function f) const
+{
+    if (offset < 0)
+        offset = 0;
+    for (int i = 0; i < numContainers && limit > 0; i++)
+    {
+        const Container &container = containers[i];
+        if (offset >= container.cardinality)
+        {
+            offset -= container.cardinality; // the whole container is before the range
+            continue;
+        }
+        uint32_t high = (uint32_t)container.key << 16;
+        if (container.bits == nullptr)
+        {
+            for (int k = (int)offset; k < container.cardinality && limit > 0; k++, limit--)
+                f(high | container.values[k]);
+            offset = 0;
+            continue;
+        }
+        for (int w = 0; w < BITMAP_WORDS && limit > 0; w++)
+        {
+            uint64_t word = container.bits[w];
+            int bitsInWord = __builtin_popcountll(word);
+            if (offset >= bitsInWord)
+            {
+                offset -= bitsInWord;
+                continue;
+            }
+            for (; offset > 0; offset--)
+                word &= word - 1;
+            for (; word != 0 && limit > 0; limit--)
+            {
+                f(high | (uint32_t)(w * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+long RoaringBitmap::memoryUsage() const
+{
+    long bytes = (long)capacity * sizeof(Container);
+    for (int i = 0; i < numContainers; i++)
+        bytes += containers[i].bits != nullptr ? BITMAP_WORDS * (long)sizeof(uint64_t)
+                                               : containers[i].capacity * (long)sizeof(uint16_t);
+    return bytes;
+}
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////// (private) METHOD DEFNITION //////////////////
+//////////////////////////////////////////////////////////////////////
+RoaringBitmap::Container RoaringBitmap::makeArray(uint16_t key, int capacity)
+{
+    Container container;
+    container.key = key;
+    container.cardinality = 0;
+    container.capacity = capacity > 0 ? capacity : 1;
+    container.values = new uint16_t[container.capacity];
+    container.bits = nullptr;
+    return container;
+}
+
+RoaringBitmap::Container RoaringBitmap::makeBitmap(uint16_t key)
+{
+    Container container;
+    container.key = key;
+    container.cardinality = 0;
+    container.capacity = 0;
+    container.values = nullptr;
+    container.bits = new uint64_t[BITMAP_WORDS]();
+    return container;
+}
+
+RoaringBitmap::Container RoaringBitmap::copyOf(const Container &container)
+{
+    Container copy;
+    if (container.bits != nullptr)
+    {
+        copy = makeBitmap(container.key);
+        memcpy(copy.bits, container.bits, BITMAP_WORDS * sizeof(uint64_t));
+    }
+    else
+    {
+        copy = makeArray(container.key, container.cardinality);
+        memcpy(copy.values, container.values, container.cardinality * sizeof(uint16_t));
+    }
+    copy.cardinality = container.cardinality;
+    return copy;
+}
+
+void RoaringBitmap::release(Container &container)
+{
+    delete[] container.values;
+    delete[] container.bits;
+    container.values = nullptr;
+    container.bits = nullptr;
+}
+
+void RoaringBitmap::toBitmap(Container &container)
+{
+    uint64_t *bits = new uint64_t[BITMAP_WORDS]();
+    for (int k = 0; k < container.cardinality; k++)
+        bits[container.values[k] >> 6] |= (uint64_t)1 << (container.values[k] & 63);
+    delete[] container.values;
+    container.values = nullptr;
+    container.capacity = 0;
+    container.bits = bits;
+}
+
+void RoaringBitmap::shrink(Container &container)
+{
+    if (container.bits == nullptr || container.cardinality > ARRAY_MAX)
+        return;
+    Container array = makeArray(container.key, container.cardinality);
+    for (int w = 0; w < BITMAP_WORDS; w++)
+    {
+        uint64_t word = container.bits[w];
+        while (word != 0)
+        {
+            array.values[array.cardinality++] = (uint16_t)(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    release(container);
+    container = array;
+}
+
+int RoaringBitmap::popcount(const uint64_t *bits)
+{
+    int n = 0;
+    for (int w = 0; w < BITMAP_WORDS; w++)
+        n += __builtin_popcountll(bits[w]);
+    return n;
+}
+
+void RoaringBitmap::addLow(Container &container, uint16_t low)
+{
+    if (container.bits == nullptr)
+    {
+        uint16_t *end = container.values + container.cardinality;
+        uint16_t *position = container.cardinality > 0 && container.values[container.cardinality - 1] < low
+                                 ? end
+                                 : lower_bound(container.values, end, low);
+        if (position != end && *position == low)
+            return;
+        if (container.cardinality < ARRAY_MAX)
+        {
+            int offset = (int)(position - container.values);
+            if (container.cardinality == container.capacity)
+            {
+                int grown = container.capacity * 2 < ARRAY_MAX ? container.capacity * 2 : ARRAY_MAX;
+                uint16_t *values = new uint16_t[grown];
+                memcpy(values, container.values, container.cardinality * sizeof(uint16_t));
+                delete[] container.values;
+                container.values = values;
+                container.capacity = grown;
+            }
+            memmove(container.values + offset + 1, container.values + offset,
+                    (container.cardinality - offset) * sizeof(uint16_t));
+            container.values[offset] = low;
+            container.cardinality++;
+            return;
+        }
+        toBitmap(container);
+    }
+    uint64_t &word = container.bits[low >> 6];
+    uint64_t mask = (uint64_t)1 << (low & 63);
+    container.cardinality += (word & mask) == 0;
+    word |= mask;
+}
+
+bool RoaringBitmap::containsLow(const Container &container, uint16_t low)
+{
+    if (container.bits != nullptr)
+        return (container.bits[low >> 6] >> (low & 63)) & 1;
+    return binary_search(container.values, container.values + container.cardinality, low);
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container &a, const Container &b)
+{
+    if (a.bits != nullptr && b.bits != nullptr)
+    {
+        Container result = makeBitmap(a.key);
+        result.cardinality = combineBits<AND>(result.bits, a.bits, b.bits);
+        shrink(result);
+        return result;
+    }
+    if (a.bits != nullptr)
+        return intersect(b, a);
+
+    // a is an array: keep its values found in b
+    Container result = makeArray(a.key, a.cardinality < b.cardinality || b.bits != nullptr ? a.cardinality : b.cardinality);
+    if (b.bits != nullptr)
+    {
+        for (int k = 0; k < a.cardinality; k++)
+            if ((b.bits[a.values[k] >> 6] >> (a.values[k] & 63)) & 1)
+                result.values[result.cardinality++] = a.values[k];
+        return result;
+    }
+    const Container &small = a.cardinality <= b.cardinality ? a : b;
+    const Container &large = a.cardinality <= b.cardinality ? b : a;
+    if (small.cardinality * 32 < large.cardinality)
+    {
+        // very different sizes: binary search of each small value in the rest of large
+        const uint16_t *from = large.values, *end = large.values + large.cardinality;
+        for (int k = 0; k < small.cardinality && from != end; k++)
+        {
+            from = lower_bound(from, end, small.values[k]);
+            if (from != end && *from == small.values[k])
+                result.values[result.cardinality++] = small.values[k];
+        }
+        return result;
+    }
+    result.cardinality = filterArray(a.values, a.cardinality, b.values, b.cardinality, true, result.values);
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container &a, const Container &b)
+{
+    if (a.bits == nullptr && b.bits == nullptr && a.cardinality + b.cardinality <= ARRAY_MAX)
+    {
+        Container result = makeArray(a.key, a.cardinality + b.cardinality);
+        int i = 0, j = 0;
+        while (i < a.cardinality || j < b.cardinality)
+        {
+            if (j == b.cardinality || (i < a.cardinality && a.values[i] < b.values[j]))
+                result.values[result.cardinality++] = a.values[i++];
+            else if (i == a.cardinality || a.values[i] > b.values[j])
+                result.values[result.cardinality++] = b.values[j++];
+            else
+            {
+                result.values[result.cardinality++] = a.values[i];
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    Container result = makeBitmap(a.key);
+    if (a.bits != nullptr && b.bits != nullptr)
+    {
+        result.cardinality = combineBits<OR>(result.bits, a.bits, b.bits);
+        return result; // more than either side: stays a bitmap
+    }
+    const Container *sides[2] = {&a, &b};
+    for (int s = 0; s < 2; s++)
+    {
+        const Container &side = *sides[s];
+        if (side.bits != nullptr)
+            for (int w = 0; w < BITMAP_WORDS; w++)
+                result.bits[w] |= side.bits[w];
+        else
+            for (int k = 0; k < side.cardinality; k++)
+                result.bits[side.values[k] >> 6] |= (uint64_t)1 << (side.values[k] & 63);
+    }
+    result.cardinality = popcount(result.bits);
+    shrink(result);
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container &a, const Container &b)
+{
+    if (a.bits == nullptr)
+    {
+        Container result = makeArray(a.key, a.cardinality);
+        if (b.bits == nullptr)
+        {
+            result.cardinality = filterArray(a.values, a.cardinality, b.values, b.cardinality, false, result.values);
+            return result;
+        }
+        for (int k = 0; k < a.cardinality; k++)
+            if (!containsLow(b, a.values[k]))
+                result.values[result.cardinality++] = a.values[k];
+        return result;
+    }
+    Container result;
+    if (b.bits != nullptr)
+    {
+        result = makeBitmap(a.key);
+        result.cardinality = combineBits<AND_NOT>(result.bits, a.bits, b.bits);
+    }
+    else
+    {
+        result = copyOf(a);
+        for (int k = 0; k < b.cardinality; k++)
+            result.bits[b.values[k] >> 6] &= ~((uint64_t)1 << (b.values[k] & 63));
+        result.cardinality = popcount(result.bits);
+    }
+    shrink(result);
+    return result;
+}
+
+template <int OP>
+int RoaringBitmap::combineBits(uint64_t *result, const uint64_t *a, const uint64_t *b)
+{
+    int n = 0;
+#if defined(__AVX2__)
+    for (int w = 0; w < BITMAP_WORDS; w += 4)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + w));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + w));
+        __m256i z = OP == AND ? _mm256_and_si256(x, y) : OP == OR ? _mm256_or_si256(x, y) : _mm256_andnot_si256(y, x);
+        _mm256_storeu_si256((__m256i *)(result + w), z);
+        n += __builtin_popcountll(result[w]) + __builtin_popcountll(result[w + 1]) +
+             __builtin_popcountll(result[w + 2]) + __builtin_popcountll(result[w + 3]);
+    }
+#elif defined(__SSE2__)
+    for (int w = 0; w < BITMAP_WORDS; w += 2)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + w));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + w));
+        __m128i z = OP == AND ? _mm_and_si128(x, y) : OP == OR ? _mm_or_si128(x, y) : _mm_andnot_si128(y, x);
+        _mm_storeu_si128((__m128i *)(result + w), z);
+        n += __builtin_popcountll(result[w]) + __builtin_popcountll(result[w + 1]);
+    }
+#else
+    for (int w = 0; w < BITMAP_WORDS; w++)
+    {
+        result[w] = OP == AND ? a[w] & b[w] : OP == OR ? a[w] | b[w] : a[w] & ~b[w];
+        n += __builtin_popcountll(result[w]);
+    }
+#endif
+    return n;
+}
+
+int RoaringBitmap::filterArray(const uint16_t *a, int na, const uint16_t *b, int nb, bool keep, uint16_t *out)
+{
+    /*
+     * Both arrays are sorted, without repeats. With SSE2, a block of 8 values of a is compared with a
+     * block of 8 values of b (8 broadcasts, 8 compares); the block with the smaller last value is done
+     * and the next one is loaded. A block of a is written out when it is done: its values can only
+     * match the blocks of b seen while it was loaded ("found" collects those matches).
+     */
+    int i = 0, j = 0, n = 0;
+    int found = 0; // matches of the current block of a (2 mask bits per value)
+#if defined(__SSE2__)
+    while (i + 8 <= na && j + 8 <= nb)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i equal = _mm_setzero_si128();
+        for (int k = 0; k < 8; k++)
+            equal = _mm_or_si128(equal, _mm_cmpeq_epi16(block, _mm_set1_epi16((short)b[j + k])));
+        found |= _mm_movemask_epi8(equal);
+        uint16_t lastA = a[i + 7], lastB = b[j + 7];
+        if (lastA <= lastB)
+        {
+            for (int l = 0; l < 8; l++)
+                if (((found >> (2 * l)) & 1) == (int)keep)
+                    out[n++] = a[i + l];
+            i += 8;
+            found = 0;
+        }
+        if (lastB <= lastA)
+            j += 8;
+    }
+#endif
+    // the rest: a plain merge; the values of the block of a in progress keep their earlier matches
+    for (int block = i; i < na; i++)
+    {
+        while (j < nb && b[j] < a[i])
+            j++;
+        bool matched = (j < nb && b[j] == a[i]) || (i - block < 8 && ((found >> (2 * (i - block))) & 1));
+        if (matched == keep)
+            out[n++] = a[i];
+    }
+    return n;
+}
+
+int RoaringBitmap::findContainer(uint16_t key) const
+{
+    int low = 0, high = numContainers - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (containers[middle].key < key)
+            low = middle + 1;
+        else if (containers[middle].key > key)
+            high = middle - 1;
+        else
+            return middle;
+    }
+    return -low - 1;
+}
+
+RoaringBitmap::Container &RoaringBitmap::insertContainer(int position, const Container &container)
+{
+    if (numContainers == capacity)
+    {
+        int grown = capacity > 0 ? capacity * 2 : 4;
+        Container *moved = new Container[grown];
+        if (numContainers > 0)
+            memcpy((void *)moved, (void *)containers, numContainers * sizeof(Container));
+        delete[] containers;
+        containers = moved;
+        capacity = grown;
+    }
+    memmove((void *)(containers + position + 1), (void *)(containers + position),
+            (numContainers - position) * sizeof(Container));
+    containers[position] = container;
+    numContainers++;
+    return containers[position];
+}
+
+void RoaringBitmap::append(const Container &container)
+{
+    if (container.cardinality == 0)
+    {
+        Container empty = container;
+        release(empty);
+        return;
+    }
+    insertContainer(numContainers, container);
+}
+
+void RoaringBitmap::swap(RoaringBitmap &other)
+{
+    Container *containers = this->containers;
+    int numContainers = this->numContainers, capacity = this->capacity;
+    this->containers = other.containers;
+    this->numContainers = other.numContainers;
+    this->capacity = other.capacity;
+    other.containers = containers;
+    other.numContainers = numContainers;
+    other.capacity = capacity;
+}
+
+#endif /* ROARINGBITMAP_H */
@@ -0,0 +1,216 @@
+/*
+ * File:   Simd.h
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <type_traits>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+/*
+ * Equality search over plain arrays of int, unsigned int, float or double, with SIMD
+ * compare-and-movemask:
+ *  >> simdIndexOf(data, n, value): the first index i < n with data[i] == value, or -1
+ *  >> simdCount(data, n, value): the number of such indices
+ *  >> simdForEachMatch(data, n, value, f): f(i) for each of them, in increasing order
+ * "==" is the operator of T: for float and double, NaN matches nothing and -0.0 matches 0.0.
+ *
+ * SimdSearch<T>::LANES items are compared per instruction: 8 ints / floats or 4 doubles with AVX2
+ * (-mavx2 or -march=native), 4 / 2 with SSE2 (any x86-64), and the loops run 4 vectors per step
+ * (16 to 32 items); other types, or other targets, get LANES == 1 and a plain loop.
+ * SimdSearch<T>::ENABLED tells callers (e.g. XArrayList::indexOf) whether the vector path exists.
+ */
+template <class T>
+struct SimdSearch
+{
+    static const int LANES = 1;
+    static const bool ENABLED = false;
+};
+
+#if defined(__AVX2__)
+template <>
+struct SimdSearch<int>
+{
+    static const int LANES = 8;
+    static const bool ENABLED = true;
+    typedef __m256i Vector;
+    static Vector splat(int value) { return _mm256_set1_epi32(value); }
+    static int match(const int *p, Vector v)
+    {
+        __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)p), v);
+        return _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+    }
+};
+
+template <>
+struct SimdSearch<float>
+{
+    static const int LANES = 8;
+    static const bool ENABLED = true;
+    typedef __m256 Vector;
+    static Vector splat(float value) { return _mm256_set1_ps(value); }
+    static int match(const float *p, Vector v)
+    {
+        return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), v, _CMP_EQ_OQ));
+    }
+};
+
+template <>
+struct SimdSearch<double>
+{
+    static const int LANES = 4;
+    static const bool ENABLED = true;
+    typedef __m256d Vector;
+    static Vector splat(double value) { return _mm256_set1_pd(value); }
+    static int match(const double *p, Vector v)
+    {
+        return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), v, _CMP_EQ_OQ));
+    }
+};
+#elif defined(__SSE2__)
+template <>
+struct SimdSearch<int>
+{
+    static const int LANES = 4;
+    static const bool ENABLED = true;
+    typedef __m128i Vector;
+    static Vector splat(int value) { return _mm_set1_epi32(value); }
+    static int match(const int *p, Vector v)
+    {
+        __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)p), v);
+        return _mm_movemask_ps(_mm_castsi128_ps(equal));
+    }
+};
+
+template <>
+struct SimdSearch<float>
+{
+    static const int LANES = 4;
+    static const bool ENABLED = true;
+    typedef __m128 Vector;
+    static Vector splat(float value) { return _mm_set1_ps(value); }
+    static int match(const float *p, Vector v)
+    {
+        return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p), v));
+    }
+};
+
+template <>
+struct SimdSearch<double>
+{
+    static const int LANES = 2;
+    static const bool ENABLED = true;
+    typedef __m128d Vector;
+    static Vector splat(double value) { return _mm_set1_pd(value); }
+    static int match(const double *p, Vector v)
+    {
+        return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p), v));
+    }
+};
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+// unsigned int: the same bits as int
+template <>
+struct SimdSearch<unsigned int>
+{
+    static const int LANES = SimdSearch<int>::LANES;
+    static const bool ENABLED = true;
+    typedef SimdSearch<int>::Vector Vector;
+    static Vector splat(unsigned int value) { return SimdSearch<int>::splat((int)value); }
+    static int match(const unsigned int *p, Vector v) { return SimdSearch<int>::match((const int *)p, v); }
+};
+#endif
+
+// bit count without the popcnt instruction (not in SSE2): __builtin_popcount would be a library call
+inline int simdPopcount(unsigned int x)
+{
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (int)((x * 0x01010101u) >> 24);
+}
+
+template <class T, class Function>
+void simdForEachMatch(const T *data, int n, T value, Function f)
+{
+    int i = 0;
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        const int lanes = SimdSearch<T>::LANES;
+        typename SimdSearch<T>::Vector v = SimdSearch<T>::splat(value);
+        for (; i + lanes <= n; i += lanes)
+        {
+            for (int mask = SimdSearch<T>::match(data + i, v); mask != 0; mask &= mask - 1)
+                f(i + __builtin_ctz(mask));
+        }
+    }
+    for (; i < n; i++)
+        if (data[i] == value)
+            f(i);
+}
+
+template <class T>
+int simdIndexOf(const T *data, int n, T value)
+{
+    int i = 0;
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        const int lanes = SimdSearch<T>::LANES;
+        typename SimdSearch<T>::Vector v = SimdSearch<T>::splat(value);
+        // 4 vectors per step, one branch for all of them
+        for (; i + 4 * lanes <= n; i += 4 * lanes)
+        {
+            int m0 = SimdSearch<T>::match(data + i, v);
+            int m1 = SimdSearch<T>::match(data + i + lanes, v);
+            int m2 = SimdSearch<T>::match(data + i + 2 * lanes, v);
+            int m3 = SimdSearch<T>::match(data + i + 3 * lanes, v);
+            if ((m0 | m1 | m2 | m3) != 0)
+            {
+                unsigned long mask = (unsigned long)m0 | ((unsigned long)m1 << lanes) |
+                                     ((unsigned long)m2 << (2 * lanes)) | ((unsigned long)m3 << (3 * lanes));
+                return i + __builtin_ctzl(mask);
+            }
+        }
+        for (; i + lanes <= n; i += lanes)
+        {
+            int mask = SimdSearch<T>::match(data + i, v);
+            if (mask != 0)
+                return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < n; i++)
+        if (data[i] == value)
+            return i;
+    return -1;
+}
+
+template <class T>
+int simdCount(const T *data, int n, T value)
+{
+    int i = 0, matches = 0;
+    if constexpr (SimdSearch<T>::ENABLED)
+    {
+        const int lanes = SimdSearch<T>::LANES;
+        typename SimdSearch<T>::Vector v = SimdSearch<T>::splat(value);
+        for (; i + 4 * lanes <= n; i += 4 * lanes)
+        {
+            unsigned int mask = (unsigned int)SimdSearch<T>::match(data + i, v) |
+                                ((unsigned int)SimdSearch<T>::match(data + i + lanes, v) << lanes) |
+                                ((unsigned int)SimdSearch<T>::match(data + i + 2 * lanes, v) << (2 * lanes)) |
+                                ((unsigned int)SimdSearch<T>::match(data + i + 3 * lanes, v) << (3 * lanes));
+            matches += simdPopcount(mask);
+        }
+        for (; i + lanes <= n; i += lanes)
+            matches += simdPopcount((unsigned int)SimdSearch<T>::match(data + i, v));
+    }
+    for (; i < n; i++)
+        matches += data[i] == value;
+    return matches;
+}
+
+#endif /* SIMD_H */
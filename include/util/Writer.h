@@ -0,0 +1,264 @@
+/*
+ * File:   Writer.h
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <errno.h>
+#include <unistd.h>
+using namespace std;
+
+/*
+ * Writer: an output buffer used by the toString/writeTo methods of the lists and the inventory.
+ *  >> StringWriter: the buffer grows; str() returns everything written so far.
+ *  >> FdWriter:     the buffer has a fixed size and is flushed to a file descriptor when full.
+ *
+ * Numbers are formatted with std::to_chars, and produce exactly the text an ostream with default
+ * flags would (writeDouble: like "os << value"; writeFixed: like "os << fixed << setprecision(p) << value").
+ */
+class Writer
+{
+protected:
+    char *buffer;
+    size_t length;   // number of bytes in buffer
+    size_t capacity; // size of buffer
+
+public:
+    Writer(size_t capacity)
+    {
+        if (capacity < 512) // room for any number written by writeFixed
+            capacity = 512;
+        this->buffer = new char[capacity];
+        this->length = 0;
+        this->capacity = capacity;
+    }
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+    virtual ~Writer()
+    {
+        delete[] buffer;
+    }
+
+    void put(char c)
+    {
+        if (length == capacity)
+            overflow(1);
+        buffer[length++] = c;
+    }
+    void write(const char *text, size_t size)
+    {
+        if (size > capacity - length)
+        {
+            overflow(size);
+            if (size > capacity - length) // larger than a non-growing buffer
+            {
+                writeThrough(text, size);
+                return;
+            }
+        }
+        memcpy(buffer + length, text, size);
+        length += size;
+    }
+    void write(const char *text)
+    {
+        write(text, strlen(text));
+    }
+    void write(const string &text)
+    {
+        write(text.data(), text.size());
+    }
+
+    void writeInt(long long value)
+    {
+        reserve(24);
+        length = std::to_chars(buffer + length, buffer + capacity, value).ptr - buffer;
+    }
+    void writeUnsigned(unsigned long long value)
+    {
+        reserve(24);
+        length = std::to_chars(buffer + length, buffer + capacity, value).ptr - buffer;
+    }
+    // writeDouble: same text as "os << value" (%g, 6 significant digits)
+    void writeDouble(double value, int precision = 6)
+    {
+        reserve(32);
+        length = std::to_chars(buffer + length, buffer + capacity, value, std::chars_format::general, precision)
+                     .ptr -
+                 buffer;
+    }
+    // writeFixed: same text as "os << fixed << setprecision(precision) << value"
+    void writeFixed(double value, int precision = 6)
+    {
+        // %f of a double has at most 309 integer digits
+        reserve(320 + precision);
+        length = std::to_chars(buffer + length, buffer + capacity, value, std::chars_format::fixed, precision)
+                     .ptr -
+                 buffer;
+    }
+
+    /* flush: hand buffered bytes to the destination (no-op for StringWriter)
+     */
+    virtual void flush() {}
+
+protected:
+    void reserve(size_t size)
+    {
+        if (size > capacity - length)
+            overflow(size);
+    }
+    /* overflow(size): make room for at least "size" more bytes, or as much as the writer can
+     */
+    virtual void overflow(size_t size) = 0;
+    virtual void writeThrough(const char *text, size_t size) = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+class StringWriter : public Writer
+{
+public:
+    StringWriter(size_t capacity = 256) : Writer(capacity) {}
+
+    string str() const
+    {
+        return string(buffer, length);
+    }
+    size_t size() const
+    {
+        return length;
+    }
+    void clear()
+    {
+        length = 0;
+    }
+
+protected:
+    void overflow(size_t size)
+    {
+        if (size > SIZE_MAX / 2 - length)
+            throw length_error("StringWriter: buffer too large!");
+        size_t newCapacity = capacity * 2;
+        while (newCapacity - length < size)
+            newCapacity *= 2;
+        char *newBuffer = new char[newCapacity];
+        memcpy(newBuffer, buffer, length);
+        delete[] buffer;
+        buffer = newBuffer;
+        capacity = newCapacity;
+    }
+    void writeThrough(const char *text, size_t size)
+    {
+        // unreachable: overflow always makes room
+        write(text, size);
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+class FdWriter : public Writer
+{
+private:
+    int fd;
+
+public:
+    FdWriter(int fd, size_t bufferSize = 1 << 16) : Writer(bufferSize), fd(fd) {}
+    ~FdWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void flush()
+    {
+        writeAll(buffer, length);
+        length = 0;
+    }
+
+protected:
+    void overflow(size_t)
+    {
+        flush();
+    }
+    void writeThrough(const char *text, size_t size)
+    {
+        writeAll(text, size);
+    }
+    void writeAll(const char *text, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t n = ::write(fd, text, size);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw runtime_error(string("write failed: ") + strerror(errno));
+            }
+            text += n;
+            size -= (size_t)n;
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+/* writeItem(writer, item): append "item" to writer, as "os << item" would.
+ *    >> arithmetic types and strings are formatted directly,
+ *    >> other types fall back to their operator<< (through a temporary stream),
+ *    >> classes can provide a cheaper overload of writeItem next to their operator<<
+ *       (see InventoryAttribute in app/inventory.h).
+ */
+inline void writeItem(Writer &writer, const string &item)
+{
+    writer.write(item);
+}
+inline void writeItem(Writer &writer, const char *item)
+{
+    writer.write(item);
+}
+inline void writeItem(Writer &writer, char item)
+{
+    writer.put(item);
+}
+inline void writeItem(Writer &writer, bool item)
+{
+    writer.put(item ? '1' : '0');
+}
+inline void writeItem(Writer &writer, double item)
+{
+    writer.writeDouble(item);
+}
+inline void writeItem(Writer &writer, float item)
+{
+    writer.writeDouble(item);
+}
+template <class T>
+void writeItem(Writer &writer, const T &item)
+{
+    if constexpr (std::is_integral<T>::value && !std::is_same<T, signed char>::value &&
+                  !std::is_same<T, unsigned char>::value)
+    {
+        if constexpr (std::is_signed<T>::value)
+            writer.writeInt(item);
+        else
+            writer.writeUnsigned(item);
+    }
+    else
+    {
+        ostringstream os;
+        os << item;
+        writer.write(os.str());
+    }
+}
+
+#endif /* WRITER_H */
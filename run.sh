@@ -1 +1 @@
-g++ -g -I include -I src -std=c++17 src/main.cpp -o main && ./main
\ No newline at end of file
+g++ -g $CXXFLAGS -I include -I src -std=c++17 -pthread src/main.cpp src/alloc_counter.cpp -o main && ./main
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+ * File:   alloc_counter.cpp
+ *
+ * Replaces the global allocation functions with the counting ones of AllocCounter
+ * (see util/AllocCounter.h). Link it into a program to count its allocations.
+ */
+
+#include "util/AllocCounter.h"
+
+void *operator new(size_t size)
+{
+    void *p = AllocCounter::allocate(size);
+    if (p == nullptr)
+        throw bad_alloc();
+    return p;
+}
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    return AllocCounter::allocate(size);
+}
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+    return AllocCounter::allocate(size);
+}
+void *operator new(size_t size, align_val_t alignment)
+{
+    void *p = AllocCounter::allocateAligned(size, (size_t)alignment);
+    if (p == nullptr)
+        throw bad_alloc();
+    return p;
+}
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    return AllocCounter::allocateAligned(size, (size_t)alignment);
+}
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+    return AllocCounter::allocateAligned(size, (size_t)alignment);
+}
+
+void operator delete(void *p) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p) noexcept { AllocCounter::release(p); }
+void operator delete(void *p, size_t) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p, size_t) noexcept { AllocCounter::release(p); }
+void operator delete(void *p, const nothrow_t &) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p, const nothrow_t &) noexcept { AllocCounter::release(p); }
+void operator delete(void *p, align_val_t) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p, align_val_t) noexcept { AllocCounter::release(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { AllocCounter::release(p); }
+void operator delete(void *p, align_val_t, const nothrow_t &) noexcept { AllocCounter::release(p); }
+void operator delete[](void *p, align_val_t, const nothrow_t &) noexcept { AllocCounter::release(p); }
@@ -0,0 +1,38 @@
+#include "bench/bench.h"
+#include "bench/bench_list.h"
+#include "bench/bench_inventory.h"
+#include "bench/bench_app.h"
+#include "bench/bench_point.h"
+
+using namespace std;
+
+void (*suites[])(BenchRunner &) = {
+    benchXArrayList,
+    benchDLinkedList,
+    benchSortedArrayList,
+    benchListPolicies,
+    benchBulkOperations,
+    benchIntrusiveDList,
+    benchList1D2D,
+    benchInventory,
+    benchImporter,
+    benchLog,
+    benchConcurrent,
+    benchWorkload,
+    benchKDTree,
+    benchPointCloud,
+    benchGenPoints
+};
+
+int main(int argc, char **argv)
+{
+    BenchRunner runner(argc, argv);
+    for (unsigned i = 0; i < sizeof(suites) / sizeof(suites[0]); i++)
+    {
+        suites[i](runner);
+    }
+#ifdef INVENTORY_STATS
+    cerr << InventoryManager::stats();
+#endif
+    return 0;
+}
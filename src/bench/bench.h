@@ -0,0 +1,137 @@
+/*
+ * File:   bench.h
+ *
+ * Minimal benchmark harness: every benchmark prints one JSON object, and the whole run is a
+ * JSON document on stdout (progress goes to stderr), so results can be stored and compared.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+using namespace std;
+
+static volatile long benchSink; // results are added here so that the compiler keeps the work
+
+template <class T>
+inline void keep(const T &value)
+{
+    benchSink = benchSink + (long)value;
+}
+
+class BenchRunner
+{
+private:
+    long maxN;       // largest problem size to run
+    double minTime;  // seconds: repeat a benchmark at least this long
+    string filter;   // run only benchmarks whose name contains filter
+    int results;
+    long bytes;      // bytes processed by the next benchmark (0: not reported)
+
+public:
+    BenchRunner(int argc, char **argv)
+    {
+        maxN = 100000;
+        minTime = 0.1;
+        results = 0;
+        bytes = 0;
+        for (int i = 1; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--max-n") == 0 && i + 1 < argc)
+                maxN = atol(argv[++i]);
+            else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+                minTime = atof(argv[++i]);
+            else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+                filter = argv[++i];
+            else
+            {
+                fprintf(stderr, "usage: %s [--max-n N] [--min-time seconds] [--filter text]\n", argv[0]);
+                exit(1);
+            }
+        }
+        printf("{\n  \"suite\": \"inventorymanager\",\n  \"max_n\": %ld,\n  \"results\": [", maxN);
+    }
+    ~BenchRunner()
+    {
+        printf("\n  ]\n}\n");
+    }
+
+    /* sizeCount(limit): how many of the problem sizes 1e3, 1e4, ... are <= min(maxN, limit);
+     * size(i): the i-th of them
+     */
+    long sizeCount(long limit = 10000000) const
+    {
+        long count = 0;
+        for (long n = 1000; n <= maxN && n <= limit; n *= 10)
+            count++;
+        return count;
+    }
+    static long size(int i)
+    {
+        long n = 1000;
+        while (i-- > 0)
+            n *= 10;
+        return n;
+    }
+
+    /* setBytes(bytes): the next benchmark processes "bytes" bytes per repetition; adds "mb_per_sec"
+     */
+    void setBytes(long bytes)
+    {
+        this->bytes = bytes;
+    }
+
+    bool enabled(const string &name) const
+    {
+        return filter.empty() || name.find(filter) != string::npos;
+    }
+
+    /* run(name, n, ops, setup, body): time body() (ops operations on a problem of size n),
+     *   calling setup() untimed before every repetition
+     */
+    template <class Setup, class Body>
+    void run(const string &name, long n, long ops, Setup setup, Body body)
+    {
+        if (!enabled(name))
+        {
+            bytes = 0;
+            return;
+        }
+        fprintf(stderr, "%-40s n=%-9ld", name.c_str(), n);
+        double total = 0, best = 1e300;
+        long iterations = 0;
+        while (total < minTime || iterations == 0)
+        {
+            setup();
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            body();
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            total += elapsed;
+            if (elapsed < best)
+                best = elapsed;
+            iterations++;
+        }
+        double nsPerOp = best * 1e9 / ops;
+        fprintf(stderr, " %12.1f ns/op\n", nsPerOp);
+        printf("%s\n    {\"name\": \"%s\", \"n\": %ld, \"ops\": %ld, \"iterations\": %ld, "
+               "\"ns_per_op\": %.3f, \"mean_ns_per_op\": %.3f, \"ops_per_sec\": %.1f",
+               results++ == 0 ? "" : ",", name.c_str(), n, ops, iterations,
+               nsPerOp, total * 1e9 / ops / iterations, ops / best);
+        if (bytes > 0)
+            printf(", \"mb_per_sec\": %.1f", bytes / best / 1e6);
+        printf("}");
+        bytes = 0;
+        fflush(stdout);
+    }
+    template <class Body>
+    void run(const string &name, long n, long ops, Body body)
+    {
+        run(name, n, ops, []() {}, body);
+    }
+};
+
+#endif /* BENCH_H */
@@ -0,0 +1,133 @@
+#ifndef BENCH_APP_H
+#define BENCH_APP_H
+
+#include "bench/bench.h"
+#include "bench/bench_inventory.h" // buildInventory
+#include "app/importer.h"
+#include "app/wal.h"
+#include "app/concurrent.h"
+#include "app/workload.h"
+#include <thread>
+using namespace std;
+
+void benchImporter(BenchRunner &runner)
+{
+    const char *path = "bench_import.csv";
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        FILE *file = fopen(path, "w");
+        long size = fprintf(file, "name,weight,height,depth,color,quantity\n");
+        for (long i = 0; i < n; i++)
+            size += fprintf(file, "Product %ld,%.3f,%.2f,%ld,%ld,%ld\n", i, i % 10000 / 7.0, i % 3000 / 3.0,
+                            i % 100, i % 16, i % 1000);
+        fclose(file);
+
+        runner.setBytes(size);
+        runner.run("importer/csv_rows", n, n, [&]()
+                   {
+            InventoryManager inventory;
+            InventoryImporter importer;
+            keep(importer.importFile(path, inventory)); });
+    }
+    remove(path);
+}
+
+void benchLog(BenchRunner &runner)
+{
+    const long updates = 20000;
+    int groups[] = {1, 16, 64, 256};
+    for (int g = 0; g < 4; g++)
+    {
+        InventoryManager inventory;
+        buildInventory(inventory, 1000);
+        long ops = groups[g] == 1 ? updates / 20 : updates;
+        runner.run("wal/updateQuantity_group" + to_string(groups[g]), 1000, ops, [&]()
+                   {
+            remove("bench.snap");
+            remove("bench.wal"); },
+                   [&]()
+                   {
+            InventoryLog log("bench.snap", "bench.wal", groups[g], 1000, 0);
+            inventory.setJournal(&log);
+            for (long i = 0; i < ops; i++)
+                inventory.updateQuantity((int)(i % 1000), (int)i);
+            log.sync();
+            inventory.setJournal(nullptr); });
+    }
+    remove("bench.snap");
+    remove("bench.wal");
+}
+
+// total operations of all threads, each thread calling op(thread, i) "perThread" times
+template <class Op>
+void runThreads(int threads, long perThread, Op op)
+{
+    thread *workers = new thread[threads];
+    for (int t = 0; t < threads; t++)
+        workers[t] = thread([&op, t, perThread]()
+                            {
+            for (long i = 0; i < perThread; i++)
+                op(t, i); });
+    for (int t = 0; t < threads; t++)
+        workers[t].join();
+    delete[] workers;
+}
+
+void benchConcurrent(BenchRunner &runner)
+{
+    const long n = 10000, perThread = 200000;
+    InventoryManager inventory;
+    buildInventory(inventory, n);
+    ConcurrentInventory shared(inventory);
+    for (int threads = 1; threads <= 32; threads *= 2)
+    {
+        runner.run("concurrent/getProductQuantity_t" + to_string(threads), n, threads * perThread, [&]()
+                   { runThreads(threads, perThread, [&](int t, long i)
+                                { keep(shared.getProductQuantity((int)((t * 7919 + i) % n))); }); });
+    }
+    for (int threads = 1; threads <= 32; threads *= 2)
+    {
+        runner.run("concurrent/tryReserve_hot16_t" + to_string(threads), n, threads * perThread, [&]()
+                   {
+            for (int i = 0; i < 16; i++)
+                inventory.updateQuantity(i, 1 << 30); },
+                   [&]()
+                   { runThreads(threads, perThread, [&](int t, long i)
+                                { inventory.tryReserve(t % 16, 1); }); });
+    }
+}
+
+void benchWorkload(BenchRunner &runner)
+{
+    // the default mix (20% queries, skewed updates) replayed on the same trace by each backend;
+    // every ConcurrentInventory write copies the inventory, so it gets a shorter trace
+    const long ops = 10000, concurrentOps = 1000;
+    for (int s = 0; s < runner.sizeCount(10000); s++)
+    {
+        long n = BenchRunner::size(s);
+        WorkloadConfig config;
+        config.products = (int)n;
+        WorkloadGenerator generator(config);
+        InventoryManager inventory;
+        generator.generateInventory(inventory);
+        Workload trace = generator.generateTrace(ops);
+        Workload shortTrace = generator.generateTrace(concurrentOps);
+
+        InventoryManager direct;
+        runner.run("workload/replay_inventory", n, ops, [&]()
+                   { direct = InventoryManager(inventory); },
+                   [&]()
+                   { keep(trace.replay(direct).checksum); });
+        ConcurrentInventory *shared = nullptr;
+        runner.run("workload/replay_concurrent", n, concurrentOps, [&]()
+                   {
+            delete shared;
+            shared = new ConcurrentInventory(inventory); },
+                   [&]()
+                   { keep(shortTrace.replay(*shared).checksum); });
+        delete shared;
+    }
+}
+
+#endif /* BENCH_APP_H */
@@ -0,0 +1,173 @@
+#ifndef BENCH_INVENTORY_H
+#define BENCH_INVENTORY_H
+
+#include "bench/bench.h"
+#include "app/inventory.h"
+#include "app/query.h"
+#include "app/cache.h"
+#include "app/view.h"
+using namespace std;
+
+// n products with weight/height/depth attributes; about 1 name in 10 is a duplicate
+void buildInventory(InventoryManager &inventory, long n)
+{
+    for (long i = 0; i < n; i++)
+    {
+        InventoryAttribute attributes[] = {
+            InventoryAttribute("weight", (double)(i * 7919 % 1000)),
+            InventoryAttribute("height", (double)(i % 250)),
+            InventoryAttribute("depth", (double)(i % 31))};
+        long id = (i % 10 == 9) ? i / 2 : i;
+        inventory.addProduct(List1D<InventoryAttribute>(attributes, 3), "Product " + to_string(id), (int)(i % 100));
+    }
+}
+
+void benchInventory(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        InventoryManager inventory;
+        buildInventory(inventory, n);
+
+        runner.run("inventory/addProduct", n, n, [&]()
+                   {
+            InventoryManager built;
+            buildInventory(built, n);
+            keep(built.size()); });
+
+        // 1% of the products match; their names are copied and sorted
+        if (n <= 1000000)
+            runner.run("inventory/query_1pct", n, 1, [&]()
+                       {
+                List1D<string> result = inventory.query("weight", 100, 109, 10, true);
+                keep(result.size()); });
+        // repeated query through QueryCache; a quantity change crossing minQuantity is patched in
+        {
+            QueryCache cache(inventory);
+            runner.run("inventory/cache_hit_1pct", n, 1, [&]()
+                       { keep(cache.query("weight", 100, 109, 10, true).size()); });
+            int flip = 0;
+            runner.run("inventory/cache_updateQuantity_patched", n, 1, [&]()
+                       {
+                inventory.updateQuantity(11, (flip++ % 2) * 20); // weight 109: leaves / enters the result
+                keep(cache.query("weight", 100, 109, 10, true).size()); });
+            inventory.updateQuantity(11, 11);
+        }
+
+        // standing filter: maintained on each quantity change, read for free
+        {
+            MaterializedView lowStock(inventory, Predicate::range("weight", 100, 109) && Predicate::quantityAtMost(20));
+            int flip = 0;
+            runner.run("inventory/view_updateQuantity", n, 1, [&]()
+                       { inventory.updateQuantity(11, (flip++ % 2) * 40); });
+            runner.run("inventory/view_count", n, 1, [&]()
+                       { keep(lowStock.count()); });
+            inventory.updateQuantity(11, 11);
+        }
+
+        // the same products as a compressed bitmap: counted, intersected, one page of names
+        runner.run("inventory/queryRows_count_1pct", n, 1, [&]()
+                   { keep(inventory.queryRows("weight", 100, 109, 10).count()); });
+        {
+            RoaringBitmap heavy = inventory.queryRows("weight", 500, 999, 0);
+            RoaringBitmap tall = inventory.queryRows("height", 0, 124, 0);
+            runner.run("inventory/roaring_and_50pct", n, 1, [&]()
+                       {
+                RoaringBitmap both = heavy;
+                both &= tall;
+                keep(both.count()); });
+            runner.run("inventory/roaring_or_50pct", n, 1, [&]()
+                       {
+                RoaringBitmap either = heavy;
+                either |= tall;
+                keep(either.count()); });
+            runner.run("inventory/roaring_page_of_20", n, 1, [&]()
+                       { keep(inventory.getProductNames(heavy, heavy.count() / 2, 20).size()); });
+        }
+
+        // weight 10% AND height 10% AND quantity >= 10: two queries intersected by name (O(n^2)),
+        // then QueryEngine without and with indexes
+        Predicate both = Predicate::range("weight", 100, 199) && Predicate::range("height", 0, 24) &&
+                         Predicate::quantityAtLeast(10);
+        if (n <= 10000)
+            runner.run("inventory/multi_query_intersect", n, 1, [&]()
+                       {
+                List1D<string> byWeight = inventory.query("weight", 100, 199, 10, true);
+                List1D<string> byHeight = inventory.query("height", 0, 24, 10, true);
+                long matching = 0;
+                for (int i = 0; i < byWeight.size(); i++)
+                    for (int j = 0; j < byHeight.size(); j++)
+                        if (byWeight.get(i) == byHeight.get(j))
+                        {
+                            matching++;
+                            break;
+                        }
+                keep(matching); });
+        {
+            QueryEngine engine(inventory);
+            runner.run("inventory/engine_scan", n, 1, [&]()
+                       { keep(engine.names(both).size()); });
+            engine.createIndex("weight");
+            engine.createIndex("height");
+            runner.run("inventory/engine_indexed", n, 1, [&]()
+                       { keep(engine.names(both).size()); });
+            runner.run("inventory/engine_indexed_count", n, 1, [&]()
+                       { keep(engine.count(both)); });
+        }
+
+        // O(n^2)
+        if (n <= 10000)
+        {
+            InventoryManager copy;
+            runner.run("inventory/removeDuplicates", n, 1, [&]()
+                       { copy = inventory; },
+                       [&]()
+                       {
+                copy.removeDuplicates();
+                keep(copy.size()); });
+        }
+
+        runner.run("inventory/merge", n, 1, [&]()
+                   {
+            InventoryManager merged = InventoryManager::merge(inventory, inventory);
+            keep(merged.size()); });
+
+        runner.run("inventory/split", n, 1, [&]()
+                   {
+            InventoryManager section1, section2;
+            inventory.split(section1, section2, 0.5);
+            keep(section1.size() + section2.size()); });
+
+        // summing an attribute: row copies through getProductAttributes vs aggregate's single pass
+        runner.run("inventory/sum_by_getProductAttributes", n, n, [&]()
+                   {
+            double sum = 0;
+            for (int i = 0; i < inventory.size(); i++)
+            {
+                List1D<InventoryAttribute> attributes = inventory.getProductAttributes(i);
+                for (int j = 0; j < attributes.size(); j++)
+                    if (attributes.get(j).name == "height")
+                    {
+                        sum += attributes.get(j).value;
+                        break;
+                    }
+            }
+            keep(sum); });
+        runner.run("inventory/aggregate_sum", n, n, [&]()
+                   { keep(inventory.aggregate("height", AGGREGATE_SUM).sum); });
+        runner.run("inventory/aggregate_all_weighted", n, n, [&]()
+                   { keep(inventory.aggregate("height", AggregateOptions(AGGREGATE_ALL, true)).avg); });
+        AggregateOptions parallel(AGGREGATE_ALL, true);
+        parallel.threads = 4;
+        runner.run("inventory/aggregate_all_weighted_t4", n, n, [&]()
+                   { keep(inventory.aggregate("height", parallel).avg); });
+
+        runner.run("inventory/toString", n, 1, [&]()
+                   {
+            string text = inventory.toString();
+            keep(text.size()); });
+    }
+}
+
+#endif /* BENCH_INVENTORY_H */
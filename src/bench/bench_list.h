@@ -0,0 +1,358 @@
+#ifndef BENCH_LIST_H
+#define BENCH_LIST_H
+
+#include "bench/bench.h"
+#include "list/XArrayList.h"
+#include "list/DLinkedList.h"
+#include "list/SortedArrayList.h"
+#include "list/IntrusiveDList.h"
+#include "app/inventory.h"
+using namespace std;
+
+// Operations whose cost per call grows with n (insert/remove at the front, indexOf, DLinkedList::get)
+// are timed on a fixed number of calls instead of n calls.
+const long LIST_PROBES = 1000;
+
+template <class L>
+void fillList(L &list, long n)
+{
+    list.clear();
+    for (long i = 0; i < n; i++)
+        list.add((int)i);
+}
+
+template <class L>
+void benchList(BenchRunner &runner, const string &prefix, bool randomAccess)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        runner.run(prefix + "/add", n, n, [&]()
+                   {
+            L list;
+            for (long i = 0; i < n; i++)
+                list.add((int)i);
+            keep(list.size()); });
+
+        L list;
+        runner.run(prefix + "/insert_middle", n, LIST_PROBES, [&]()
+                   { fillList(list, n); },
+                   [&]()
+                   {
+            for (long i = 0; i < LIST_PROBES; i++)
+                list.add(list.size() / 2, (int)i);
+            keep(list.size()); });
+
+        runner.run(prefix + "/remove_front", n, LIST_PROBES, [&]()
+                   { fillList(list, n); },
+                   [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < LIST_PROBES; i++)
+                sum += list.removeAt(0);
+            keep(sum); });
+
+        fillList(list, n);
+        long getOps = randomAccess ? n : LIST_PROBES;
+        runner.run(prefix + "/get", n, getOps, [&]()
+                   {
+            long sum = 0;
+            unsigned long index = 1;
+            for (long i = 0; i < getOps; i++)
+            {
+                index = index * 6364136223846793005UL + 1442695040888963407UL;
+                sum += list.get((int)((index >> 33) % n));
+            }
+            keep(sum); });
+
+        runner.run(prefix + "/indexOf_last", n, 10, [&]()
+                   {
+            long sum = 0;
+            for (int i = 0; i < 10; i++)
+                sum += list.indexOf((int)n - 1);
+            keep(sum); });
+
+        runner.run(prefix + "/iterate", n, n, [&]()
+                   {
+            long sum = 0;
+            for (typename L::Iterator it = list.begin(); it != list.end(); it++)
+                sum += *it;
+            keep(sum); });
+    }
+}
+
+void benchXArrayList(BenchRunner &runner)
+{
+    benchList<XArrayList<int>>(runner, "xarraylist", true);
+}
+
+void benchDLinkedList(BenchRunner &runner)
+{
+    benchList<DLinkedList<int>>(runner, "dlinkedlist", false);
+}
+
+void benchListPolicies(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        // product names: the default Equal tests a function pointer and calls operator==, OperatorEqual inlines it
+        XArrayList<string> hooked(0, 0, (int)n);
+        XArrayList<string, OperatorEqual<string>, NoDelete> inlined(NoDelete(), OperatorEqual<string>(), (int)n);
+        for (long i = 0; i < n; i++)
+        {
+            hooked.add("Product " + to_string(i));
+            inlined.add("Product " + to_string(i));
+        }
+        string last = "Product " + to_string(n - 1);
+        runner.run("xarraylist/indexOf_string_hook", n, 10, [&]()
+                   {
+            long sum = 0;
+            for (int i = 0; i < 10; i++)
+                sum += hooked.indexOf(last);
+            keep(sum); });
+        runner.run("xarraylist/indexOf_string_policy", n, 10, [&]()
+                   {
+            long sum = 0;
+            for (int i = 0; i < 10; i++)
+                sum += inlined.indexOf(last);
+            keep(sum); });
+    }
+}
+
+template <class L>
+void benchBulk(BenchRunner &runner, const string &prefix)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        // LIST_PROBES items inserted in the middle: one shift / walk against one per item
+        int *batch = new int[LIST_PROBES];
+        for (long i = 0; i < LIST_PROBES; i++)
+            batch[i] = (int)i;
+        L list;
+        runner.run(prefix + "/insertRange_middle", n, LIST_PROBES, [&]()
+                   { fillList(list, n); },
+                   [&]()
+                   {
+            list.insertRange(list.size() / 2, batch, (int)LIST_PROBES);
+            keep(list.size()); });
+        runner.run(prefix + "/insert_middle_loop", n, LIST_PROBES, [&]()
+                   { fillList(list, n); },
+                   [&]()
+                   {
+            int index = list.size() / 2;
+            for (long i = 0; i < LIST_PROBES; i++)
+                list.add(index + (int)i, batch[i]);
+            keep(list.size()); });
+
+        // every third item removed: one pass against a removeAt per item
+        runner.run(prefix + "/removeIf", n, n, [&]()
+                   { fillList(list, n); },
+                   [&]()
+                   { keep(list.removeIf([](int &item)
+                                        { return item % 3 == 0; })); });
+        if (n <= 10000)
+            runner.run(prefix + "/removeAt_loop", n, n, [&]()
+                       { fillList(list, n); },
+                       [&]()
+                       {
+                long removed = 0;
+                for (int i = 0; i < list.size();)
+                {
+                    if (list.get(i) % 3 == 0)
+                    {
+                        list.removeAt(i);
+                        removed++;
+                    }
+                    else
+                        i++;
+                }
+                keep(removed); });
+        delete[] batch;
+    }
+}
+
+void benchBulkOperations(BenchRunner &runner)
+{
+    benchBulk<XArrayList<int>>(runner, "xarraylist");
+    benchBulk<DLinkedList<int>>(runner, "dlinkedlist");
+
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        // two lists of n / 2 items joined, then cut in half again (one op per item moved)
+        DLinkedList<int> front, back;
+        runner.run("dlinkedlist/concat_splitAt", n, n, [&]()
+                   { fillList(front, n / 2); fillList(back, n / 2); },
+                   [&]()
+                   {
+            front.concat(back);
+            back = front.splitAt((int)(n / 2));
+            keep(front.size() + back.size()); });
+        runner.run("dlinkedlist/concat_add_loop", n, n, [&]()
+                   { fillList(front, n / 2); fillList(back, n / 2); },
+                   [&]()
+                   {
+            for (DLinkedList<int>::Iterator it = back.begin(); it != back.end(); it++)
+                front.add(*it);
+            back.clear();
+            DLinkedList<int>::Iterator middle = front.begin();
+            for (long i = 0; i < n / 2; i++)
+                middle++;
+            for (; middle != front.end(); middle++)
+                back.add(*middle);
+            while (front.size() > n / 2)
+                front.removeAt(front.size() - 1);
+            keep(front.size() + back.size()); });
+    }
+}
+
+struct BenchRecord
+{
+    int value;
+    DListHook hook;
+};
+
+void benchIntrusiveDList(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        // n records linked, then unlinked one by one in a scattered order
+        BenchRecord *records = new BenchRecord[n];
+        for (long i = 0; i < n; i++)
+            records[i].value = (int)i;
+        long stride = 7919 % n == 0 ? 1 : 7919;
+        runner.run("intrusivedlist/link_unlink", n, n, [&]()
+                   {
+            IntrusiveDList<BenchRecord, &BenchRecord::hook> list;
+            for (long i = 0; i < n; i++)
+                list.add(records[i]);
+            for (long i = 0; i < n; i++)
+                list.remove(records[(i * stride) % n]);
+            keep(list.size()); });
+        // the same records in a DLinkedList of pointers: one node allocated per add
+        runner.run("dlinkedlist/link_clear_pointers", n, n, [&]()
+                   {
+            DLinkedList<BenchRecord *> list;
+            for (long i = 0; i < n; i++)
+                list.add(&records[i]);
+            keep(list.size());
+            list.clear(); });
+        delete[] records;
+    }
+}
+
+void benchSortedArrayList(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        // even keys 0, 2, ..., 2n - 2: half the probes miss
+        SortedArrayList<int> sorted(less<int>(), (int)n);
+        XArrayList<int> unsorted(0, 0, (int)n);
+        int *keys = new int[n];
+        for (long i = 0; i < n; i++)
+            keys[i] = (int)(2 * i);
+        sorted.addAll(keys, keys + n);
+        for (long i = 0; i < n; i++)
+            unsorted.add(keys[i]);
+
+        runner.run("sortedarraylist/indexOf", n, n, [&]()
+                   {
+            long sum = 0;
+            unsigned long index = 1;
+            for (long i = 0; i < n; i++)
+            {
+                index = index * 6364136223846793005UL + 1442695040888963407UL;
+                sum += sorted.indexOf((int)((index >> 33) % (2 * n)));
+            }
+            keep(sum); });
+        runner.run("sortedarraylist/indexOf_linear", n, LIST_PROBES, [&]()
+                   {
+            long sum = 0;
+            unsigned long index = 1;
+            for (long i = 0; i < LIST_PROBES; i++)
+            {
+                index = index * 6364136223846793005UL + 1442695040888963407UL;
+                sum += unsorted.indexOf((int)((index >> 33) % (2 * n)));
+            }
+            keep(sum); });
+
+        // a sorted batch of n / 10 odd keys, merged into the n items
+        long k = n / 10;
+        int *batch = new int[k];
+        for (long i = 0; i < k; i++)
+            batch[i] = (int)(20 * i + 1);
+        runner.run("sortedarraylist/addAll_merge", n, n + k, [&]()
+                   {
+            SortedArrayList<int> merged(sorted);
+            merged.addAll(batch, batch + k);
+            keep(merged.size()); });
+        runner.run("sortedarraylist/add_one_by_one", n, n + k, [&]()
+                   {
+            SortedArrayList<int> merged(sorted);
+            for (long i = 0; i < k; i++)
+                merged.add(batch[i]);
+            keep(merged.size()); });
+
+        delete[] batch;
+        delete[] keys;
+    }
+}
+
+void benchList1D2D(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        int *values = new int[n];
+        for (long i = 0; i < n; i++)
+            values[i] = (int)i;
+
+        runner.run("list1d/construct", n, n, [&]()
+                   {
+            List1D<int> list(values, (int)n);
+            keep(list.size()); });
+
+        List1D<int> list(values, (int)n);
+        runner.run("list1d/copy", n, n, [&]()
+                   {
+            List1D<int> copy(list);
+            keep(copy.size()); });
+
+        // quantity scans: a value that is not there reads the whole list
+        runner.setBytes(n * sizeof(int));
+        runner.run("list1d/indexOf_absent", n, n, [&]()
+                   { keep(list.indexOf(-1)); });
+        runner.setBytes(n * sizeof(int));
+        runner.run("list1d/countOf", n, n, [&]()
+                   { keep(list.countOf((int)n / 2)); });
+
+        // n rows of 3 attributes
+        long rows = n / 3;
+        List1D<InventoryAttribute> *rowArray = new List1D<InventoryAttribute>[rows];
+        for (long i = 0; i < rows; i++)
+        {
+            rowArray[i].add(InventoryAttribute("weight", i));
+            rowArray[i].add(InventoryAttribute("height", i * 0.5));
+            rowArray[i].add(InventoryAttribute("depth", i % 7));
+        }
+        runner.run("list2d/construct", n, n, [&]()
+                   {
+            List2D<InventoryAttribute> matrix(rowArray, (int)rows);
+            keep(matrix.rows()); });
+
+        List2D<InventoryAttribute> matrix(rowArray, (int)rows);
+        runner.run("list2d/copy", n, n, [&]()
+                   {
+            List2D<InventoryAttribute> copy(matrix);
+            keep(copy.rows()); });
+
+        delete[] rowArray;
+        delete[] values;
+    }
+}
+
+#endif /* BENCH_LIST_H */
@@ -0,0 +1,207 @@
+#ifndef BENCH_POINT_H
+#define BENCH_POINT_H
+
+#include "bench/bench.h"
+#include "list/XArrayList.h"
+#include "util/Point.h"
+#include "util/KDTree.h"
+#include "util/PointCloud.h"
+using namespace std;
+
+// Point queries are timed on a fixed number of query points, spread over the unit cube.
+const long POINT_QUERIES = 1000;
+
+Point queryPoint(long i)
+{
+    return Point((float)((i * 7919) % 1000) / 1000, (float)((i * 104729) % 1000) / 1000,
+                 (float)((i * 1299709) % 1000) / 1000);
+}
+
+void benchKDTree(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        Point *points = Point::genPoints((int)n, 0, 1, true, 1);
+
+        runner.run("kdtree/build", n, n, [&]()
+                   {
+            KDTree tree(points, (int)n);
+            keep(tree.size()); });
+
+        KDTree tree(points, (int)n);
+        runner.run("kdtree/nearest", n, POINT_QUERIES, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < POINT_QUERIES; i++)
+                sum += tree.nearest(queryPoint(i));
+            keep(sum); });
+        runner.run("kdtree/kNearest_10", n, POINT_QUERIES, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < POINT_QUERIES; i++)
+                sum += tree.kNearest(queryPoint(i), 10).size();
+            keep(sum); });
+        // about 100 points per query
+        float r = (float)cbrt(100.0 / n * 3 / (4 * 3.14159265));
+        runner.run("kdtree/radius_100", n, POINT_QUERIES, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < POINT_QUERIES; i++)
+                tree.forEachInRadius(queryPoint(i), r, [&](int index) { sum += index; });
+            keep(sum); });
+        float half = (float)cbrt(100.0 / n) / 2;
+        runner.run("kdtree/box_100", n, POINT_QUERIES, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < POINT_QUERIES; i++)
+            {
+                Point q = queryPoint(i);
+                tree.forEachInBox(Point(q.getX() - half, q.getY() - half, q.getZ() - half),
+                                  Point(q.getX() + half, q.getY() + half, q.getZ() + half),
+                                  [&](int index) { sum += index; });
+            }
+            keep(sum); });
+
+        // what the index replaces: a scan of an XArrayList<Point*> per query
+        XArrayList<Point *> list(0, &Point::pointEQ, (int)n);
+        for (long i = 0; i < n; i++)
+            list.add(&points[i]);
+        long scans = n <= 100000 ? 100 : 10;
+        runner.run("kdtree/nearest_linear_scan", n, scans, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < scans; i++)
+            {
+                Point q = queryPoint(i);
+                float best = 1e30f;
+                int bestIndex = -1;
+                for (XArrayList<Point *>::Iterator it = list.begin(); it != list.end(); it++)
+                {
+                    float dx = (*it)->getX() - q.getX(), dy = (*it)->getY() - q.getY(), dz = (*it)->getZ() - q.getZ();
+                    float d = dx * dx + dy * dy + dz * dz;
+                    if (d < best)
+                    {
+                        best = d;
+                        bestIndex = (int)(it - list.begin());
+                    }
+                }
+                sum += bestIndex;
+            }
+            keep(sum); });
+        runner.run("kdtree/indexOf_pointEQ", n, scans, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < scans; i++)
+            {
+                Point *p = &points[(i * 7919) % n];
+                sum += list.indexOf(p);
+            }
+            keep(sum); });
+        // the same scan with an Equal policy: pointEQ inlined instead of called through a pointer
+        XArrayList<Point *, PointPtrEqual> policyList(0, PointPtrEqual(), (int)n);
+        for (long i = 0; i < n; i++)
+            policyList.add(&points[i]);
+        runner.run("kdtree/indexOf_PointPtrEqual", n, scans, [&]()
+                   {
+            long sum = 0;
+            for (long i = 0; i < scans; i++)
+            {
+                Point *p = &points[(i * 7919) % n];
+                sum += policyList.indexOf(p);
+            }
+            keep(sum); });
+
+        delete[] points;
+    }
+}
+
+void benchPointCloud(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        Point *points = Point::genPoints((int)n, 0, 1, true, 1);
+        XArrayList<Point> list(0, 0, (int)n);
+        for (long i = 0; i < n; i++)
+            list.add(points[i]);
+        PointCloud cloud(list);
+        float *out = new float[n];
+
+        runner.run("pointcloud/fromList", n, n, [&]()
+                   {
+            PointCloud copy(list);
+            keep(copy.size()); });
+
+        // Point at a time, as the callers do with an XArrayList<Point> today
+        runner.setBytes(n * (sizeof(Point) + sizeof(float)));
+        runner.run("pointcloud/radii_aos", n, n, [&]()
+                   {
+            for (XArrayList<Point>::Iterator it = list.begin(); it != list.end(); it++)
+                out[it - list.begin()] = it->radius();
+            keep(out[n - 1]); });
+        runner.setBytes(n * 4 * sizeof(float));
+        runner.run("pointcloud/radii", n, n, [&]()
+                   {
+            cloud.radii(out);
+            keep(out[n - 1]); });
+        runner.setBytes(n * 4 * sizeof(float));
+        runner.run("pointcloud/distances", n, n, [&]()
+                   {
+            cloud.distances(Point(0.5f, 0.5f, 0.5f), out);
+            keep(out[n - 1]); });
+
+        // a search for the last point reads the whole list
+        Point last = points[n - 1];
+        runner.setBytes(n * sizeof(Point));
+        runner.run("pointcloud/indexOf_aos", n, n, [&]()
+                   { keep(list.indexOf(last)); });
+        runner.setBytes(n * 3 * sizeof(float));
+        runner.run("pointcloud/indexOf", n, n, [&]()
+                   { keep(cloud.indexOf(last)); });
+
+        delete[] out;
+        delete[] points;
+    }
+}
+
+void benchGenPoints(BenchRunner &runner)
+{
+    for (int s = 0; s < runner.sizeCount(); s++)
+    {
+        long n = BenchRunner::size(s);
+        Point *out = new Point[n];
+
+        runner.run("genPoints/default_random_engine", n, n, [&]()
+                   {
+            Point *points = Point::genPoints((int)n, 0, 1, true, 1);
+            keep(points[n - 1].getX());
+            delete[] points; });
+        runner.setBytes(n * sizeof(Point));
+        runner.run("genPoints/counter_1_thread", n, n, [&]()
+                   {
+            Point::genPointsParallel(out, n, 0, 1, 1, 1);
+            keep(out[n - 1].getX()); });
+        runner.setBytes(n * sizeof(Point));
+        runner.run("genPoints/counter_all_cores", n, n, [&]()
+                   {
+            Point::genPointsParallel(out, n, 0, 1, 1);
+            keep(out[n - 1].getX()); });
+
+        PointCloud cloud((int)n);
+        runner.setBytes(n * 3 * sizeof(float));
+        runner.run("genPoints/cloud_1_thread", n, n, [&]()
+                   {
+            cloud.genPoints((int)n, 0, 1, 1, 1);
+            keep(cloud.x()[n - 1]); });
+        runner.setBytes(n * 3 * sizeof(float));
+        runner.run("genPoints/cloud_all_cores", n, n, [&]()
+                   {
+            cloud.genPoints((int)n, 0, 1, 1);
+            keep(cloud.x()[n - 1]); });
+
+        delete[] out;
+    }
+}
+
+#endif /* BENCH_POINT_H */
@@ -5,25 +5,67 @@
 #include "test/tc_dlinkedlist.h"
 #include "test/tc_xarraylist.h"
 #include "test/tc_inventory.h"
+#include "test/tc_point.h"
 
 using namespace std;
 
-void (*func_ptr[15])() = {
+void (*func_ptr[56])() = {
     dlistDemo1,
     dlistDemo2,
     dlistDemo3,
     dlistDemo4,
     dlistDemo5,
     dlistDemo6,
+    dlistDemo7,
+    dlistDemo8,
+    dlistDemo9,
+    dlistDemo10,
+    dlistDemo11,
+    dlistDemo12,
     xlistDemo1,
     xlistDemo2,
     xlistDemo3,
     xlistDemo4,
+    xlistDemo5,
+    xlistDemo6,
+    xlistDemo7,
+    xlistDemo8,
+    xlistDemo9,
+    xlistDemo10,
+    xlistDemo11,
+    pointDemo1,
+    pointDemo2,
+    pointDemo3,
+    pointDemo4,
     tc_inventory1001,
     tc_inventory1002,
     tc_inventory1003,
     tc_inventory1004,
-    tc_inventory1005
+    tc_inventory1005,
+    tc_inventory1007,
+    tc_inventory1008,
+    tc_inventory1009,
+    tc_inventory1010,
+    tc_inventory1011,
+    tc_inventory1012,
+    tc_inventory1013,
+    tc_inventory1014,
+    tc_inventory1015,
+    tc_inventory1016,
+    tc_inventory1017,
+    tc_inventory1018,
+    tc_inventory1019,
+    tc_inventory1020,
+    tc_inventory1021,
+    tc_inventory1022,
+    tc_inventory1023,
+    tc_inventory1024,
+    tc_inventory1025,
+    tc_inventory1026,
+    tc_inventory1027,
+    tc_inventory1028,
+    tc_inventory1029,
+    tc_inventory1030
 };
 
 void run(int func_idx)
@@ -0,0 +1,36 @@
+#ifndef ALLOC_BUDGET_H
+#define ALLOC_BUDGET_H
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "util/AllocCounter.h"
+using namespace std;
+
+/*
+ * Allocation budgets for the test cases: hidden allocations are the usual cause of slow list and
+ * inventory code, so the tests pin how many an operation may make.
+ *
+ * checkAllocations(label, budget, operation): run operation() and count the calls to the global
+ * operator new it makes (on this thread, see util/AllocCounter.h).
+ *  >> prints "<label>: within budget (<budget> allocations)"
+ *  >> throws std::runtime_error, with the actual count, when the budget is exceeded, so a
+ *     regression stops the test run
+ *
+ * Example:
+ *  checkAllocations("XArrayList::get", 0, [&]() { list.get(5); });
+ */
+template <class Operation>
+long checkAllocations(const string &label, long budget, Operation operation)
+{
+    AllocCounter::Scope scope;
+    operation();
+    long allocations = scope.allocations();
+    if (allocations > budget)
+        throw runtime_error(label + ": " + to_string(allocations) + " allocations, budget is " +
+                            to_string(budget));
+    cout << label << ": within budget (" << budget << " allocations)" << endl;
+    return allocations;
+}
+
+#endif /* ALLOC_BUDGET_H */
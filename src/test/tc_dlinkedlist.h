@@ -2,7 +2,12 @@
 #include <iostream>
 #include <iomanip>
 #include "list/DLinkedList.h"
+#include "list/IntrusiveDList.h"
+#include <vector>
+#include <algorithm>
+#include <numeric>
 #include "util/Point.h"
+#include "test/alloc_budget.h"
 using namespace std;
 
 void dlistDemo1(){
@@ -104,3 +109,306 @@ void dlistDemo6(){
     cout << setw(25) << left << "After changing an item: ";
     list.println();
 }
+
+void dlistDemo7(){
+    DLinkedList<int> list;
+    checkAllocations("add 100", 100, [&]() {
+        for(int i = 0; i < 100; i++)
+            list.add(i);
+    });
+    checkAllocations("get / indexOf", 0, [&]() {
+        list.get(50);
+        list.indexOf(99);
+    });
+    checkAllocations("iterate", 0, [&]() {
+        long sum = 0;
+        for(DLinkedList<int>::Iterator it = list.begin(); it != list.end(); it++)
+            sum += *it;
+    });
+    checkAllocations("removeAt", 0, [&]() { list.removeAt(10); });
+}
+
+void dlistDemo8(){
+    static_assert(is_same<iterator_traits<DLinkedList<int>::Iterator>::iterator_category,
+                          bidirectional_iterator_tag>::value, "bidirectional");
+    DLinkedList<int> list;
+    for(int i = 1; i <= 6; i++)
+        list.add(i * 10);
+
+    reverse(list.begin(), list.end());
+    list.println();
+    DLinkedList<int>::Iterator it = find_if(list.begin(), list.end(), [](int x) { return x < 35; });
+    cout << "first below 35: " << *it << ", last: " << *prev(list.end()) << endl;
+
+    const DLinkedList<int> &view = list;
+    cout << "distance: " << distance(view.begin(), view.end())
+         << ", sum: " << accumulate(view.cbegin(), view.cend(), 0) << endl;
+    for(DLinkedList<int>::ConstIterator cit = view.end(); cit != view.begin(); )
+        cout << *--cit << " ";
+    cout << endl;
+}
+
+void dlistDemo9(){
+    // Equal and Deleter policies instead of function pointers
+    DLinkedList<string, OperatorEqual<string>> names;
+    names.add("bolt");
+    names.add("nut");
+    names.add("washer");
+    cout << "OperatorEqual: indexOf(nut) " << names.indexOf("nut") << ", contains(screw) " << names.contains("screw") << endl;
+
+    DLinkedList<Point*, PointPtrEqual, DeleteItems> owned;
+    for(int i = 0; i < 4; i++)
+        owned.add(new Point(i, i, i));
+    Point probe(2, 2, 2);
+    Point *pProbe = &probe;
+    Point absent(5, 5, 5);
+    cout << "PointPtrEqual: indexOf(P(2,2,2)) " << owned.indexOf(pProbe) << ", contains(P(5,5,5)) "
+         << owned.contains(&absent) << endl;
+}
+
+bool dlistIsShort(string &item){
+    return item.size() <= 3;
+}
+
+int dlistDeleted = 0;
+void dlistDeleteItem(int *item){
+    delete item;
+    dlistDeleted++;
+}
+
+void dlistDemo10(){
+    // bulk operations: the nodes are linked / cut in one walk
+    DLinkedList<string> names;
+    string items[] = {"bolt", "nut", "washer", "gear"};
+    names.addAll(items, 4);
+    vector<string> batch = {"pin", "spring"};
+    names.insertRange(1, batch.begin(), batch.end());
+    names.insertRange(names.size(), items, 1);
+    cout << "addAll + insertRange: " << names.toString() << endl;
+    names.removeRange(2, 4);
+    cout << "removeRange(2, 4): " << names.toString() << ", size " << names.size() << endl;
+    int removed = names.removeIf(dlistIsShort);
+    cout << "removeIf(size <= 3) removed " << removed << ": " << names.toString() << endl;
+    removed = names.removeIf([](string &item){ return item[0] == 'b'; });
+    cout << "removeIf(starts with b) removed " << removed << ": " << names.toString() << ", size " << names.size() << endl;
+    try{
+        names.removeRange(1, 0);
+    }
+    catch(out_of_range &e){
+        cout << "removeRange(1, 0): " << e.what() << endl;
+    }
+
+    // random operations against std::vector, forwards and backwards
+    DLinkedList<int> list;
+    vector<int> expected;
+    unsigned long state = 5;
+    int wrong = 0;
+    for(int step = 0; step < 300; step++){
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        int r = (int)(state >> 33);
+        int n = (int)expected.size();
+        int at = n == 0 ? 0 : (r >> 12) % (n + 1);
+        if(r % 3 == 0){
+            int values[5];
+            for(int i = 0; i < 5; i++)
+                values[i] = (r >> 4) % 50 + i;
+            list.insertRange(at, values, 1 + r % 5);
+            expected.insert(expected.begin() + at, values, values + 1 + r % 5);
+        }
+        else if(r % 3 == 1){
+            int to = at + (r >> 20) % (n - at + 1);
+            list.removeRange(at, to);
+            expected.erase(expected.begin() + at, expected.begin() + to);
+        }
+        else{
+            int divisor = 3 + r % 4;
+            auto predicate = [divisor](int &item){ return item % divisor == 0; };
+            int before = (int)expected.size();
+            expected.erase(remove_if(expected.begin(), expected.end(), predicate), expected.end());
+            wrong += list.removeIf(predicate) != before - (int)expected.size();
+        }
+        wrong += list.size() != (int)expected.size();
+        wrong += !equal(list.begin(), list.end(), expected.begin(), expected.end());
+        DLinkedList<int>::BWDIterator it = list.bbegin();
+        for(int i = (int)expected.size() - 1; i >= 0; i--, it--)
+            wrong += *it != expected[i];
+    }
+    cout << "300 random bulk operations: " << wrong << " wrong, " << expected.size() << " items left" << endl;
+
+    // an owning list: the removed items go to removeItemData
+    DLinkedList<int*> owned;
+    for(int i = 0; i < 6; i++)
+        owned.add(new int(i));
+    owned.removeRange(1, 3, dlistDeleteItem);
+    owned.removeIf([](int *&item){ return *item % 2 == 1; }, dlistDeleteItem);
+    cout << "owning list: deleted " << dlistDeleted << ", left " << owned.size() << ": " << *owned.get(0)
+         << ", " << *owned.get(1) << endl;
+    owned.removeRange(0, owned.size(), dlistDeleteItem);
+}
+
+void dlistDemo11(){
+    // splice, splitAt, concat: nodes are relinked, never copied
+    DLinkedList<int> queue, other;
+    for(int i = 0; i < 6; i++){
+        queue.add(i);
+        other.add(100 + i);
+    }
+    DLinkedList<int>::Iterator third = queue.begin();
+    ++++third;
+    int *address = &*third;
+
+    DLinkedList<int> rest;
+    checkAllocations("splitAt(2), moved into a list", 2, [&](){ rest = queue.splitAt(2); }); // the new list's head and tail
+    cout << "splitAt(2): " << queue.toString() << " / " << rest.toString() << endl;
+    cout << "iterator still at " << *third << ", same node: " << (address == &*third ? "yes" : "no") << endl;
+
+    DLinkedList<int>::Iterator first = other.begin(), last = other.begin();
+    ++first;
+    ++++++last;
+    checkAllocations("splice(pos, other, first, last)", 0, [&](){ rest.splice(third, other, first, last); });
+    cout << "splice 2 items of other before 2: " << rest.toString() << ", size " << rest.size()
+         << " / " << other.toString() << ", size " << other.size() << endl;
+
+    checkAllocations("concat", 0, [&](){ rest.concat(other); });
+    cout << "concat: " << rest.toString() << ", size " << rest.size() << " / other size " << other.size() << endl;
+
+    checkAllocations("splice(begin, other)", 0, [&](){ rest.splice(rest.begin(), queue); });
+    cout << "splice(begin, queue): " << rest.toString() << ", size " << rest.size() << " / queue size " << queue.size() << endl;
+
+    // within one list: move the first two items to the end
+    DLinkedList<int>::Iterator two = rest.begin();
+    ++++two;
+    rest.splice(rest.end(), rest, rest.begin(), two);
+    cout << "rotate by 2: " << rest.toString() << ", size " << rest.size() << endl;
+    try{
+        rest.splice(rest.end(), rest);
+    }
+    catch(invalid_argument &e){
+        cout << "splice(end, itself): " << e.what() << endl;
+    }
+
+    // an iterator taken before a split is erased through the list that holds its item now
+    DLinkedList<int> tail = rest.splitAt(2); // 2 and what follows
+    DLinkedList<int>::Iterator next = tail.erase(third);
+    cout << "erase 2 from the split-off tail: " << tail.toString() << ", size " << tail.size()
+         << ", next " << *next << " / rest size " << rest.size() << endl;
+    try{
+        tail.erase(tail.end());
+    }
+    catch(out_of_range &e){
+        cout << "erase(end): " << e.what() << endl;
+    }
+
+    // iterators into another list are rejected, whatever they point at
+    try{
+        rest.erase(tail.end());
+    }
+    catch(invalid_argument &e){
+        cout << "erase(end of another list): " << e.what() << endl;
+    }
+    try{
+        rest.erase(tail.begin());
+    }
+    catch(invalid_argument &e){
+        cout << "erase(item of another list): " << e.what() << endl;
+    }
+    DLinkedList<int>::Iterator stale = rest.begin(); // its item moves to tail below
+    tail.splice(tail.end(), rest);
+    try{
+        stale.remove();
+    }
+    catch(invalid_argument &e){
+        cout << "remove() through the old list: " << e.what() << endl;
+    }
+    cout << "unchanged: " << tail.toString() << ", size " << tail.size()
+         << " / rest size " << rest.size() << endl;
+}
+
+struct StockRecord{
+    string name;
+    int quantity;
+    DListHook lowStock;
+    DListHook recent;
+
+    StockRecord(string name = "", int quantity = 0) : name(name), quantity(quantity) {}
+};
+
+ostream &operator<<(ostream &os, const StockRecord &record){
+    return os << record.name << ":" << record.quantity;
+}
+
+void dlistDemo12(){
+    // intrusive lists: the records carry their links, one object in two lists at once
+    StockRecord records[] = {StockRecord("bolt", 3), StockRecord("nut", 40), StockRecord("washer", 1),
+                             StockRecord("gear", 7), StockRecord("pin", 55)};
+    StockRecord spring("spring", 9);
+    IntrusiveDList<StockRecord, &StockRecord::lowStock> lowStock;
+    IntrusiveDList<StockRecord, &StockRecord::recent> recent;
+    checkAllocations("IntrusiveDList add / addFirst", 0, [&](){
+        for(int i = 0; i < 5; i++){
+            if(records[i].quantity < 10)
+                lowStock.add(records[i]);
+            recent.addFirst(records[i]);
+        }
+    });
+    cout << "lowStock: " << lowStock.toString() << ", size " << lowStock.size() << endl;
+    cout << "recent: " << recent.toString() << endl;
+
+    // restocking the gear: out of lowStock in O(1), moved to the front of recent
+    records[3].quantity = 70;
+    checkAllocations("IntrusiveDList remove / addFirst", 0, [&](){
+        lowStock.remove(records[3]);
+        recent.remove(records[3]);
+        recent.addFirst(records[3]);
+    });
+    cout << "after restocking gear: " << lowStock.toString() << " / " << recent.toString() << endl;
+    cout << "gear in lowStock: " << lowStock.contains(records[3]) << ", indexOf(washer) " << lowStock.indexOf(records[2])
+         << ", recent.get(4) " << recent.get(4).name << endl;
+
+    // iterators as DLinkedList's, and the standard algorithms
+    IntrusiveDList<StockRecord, &StockRecord::recent>::Iterator it = find_if(recent.begin(), recent.end(),
+        [](StockRecord &record){ return record.name == "nut"; });
+    recent.insertBefore(it, spring);
+    long total = 0;
+    for(IntrusiveDList<StockRecord, &StockRecord::recent>::ConstIterator c = recent.cbegin(); c != recent.cend(); c++)
+        total += c->quantity;
+    cout << "recent: " << recent.toString() << ", total quantity " << total << endl;
+    for(it = recent.begin(); it != recent.end(); it++)
+        if(it->quantity > 30)
+            it.remove();
+    cout << "recent without quantity > 30: " << recent.toString() << ", size " << recent.size() << endl;
+    try{
+        lowStock.add(records[0]);
+    }
+    catch(invalid_argument &e){
+        cout << "add(bolt) twice: " << e.what() << endl;
+    }
+
+    // two lists on the same hook: each one only removes its own items
+    IntrusiveDList<StockRecord, &StockRecord::lowStock> reorder;
+    reorder.add(records[1]);
+    cout << "lowStock.remove(nut): " << lowStock.remove(records[1]) << ", contains: " << lowStock.contains(records[1])
+         << ", sizes " << lowStock.size() << " / " << reorder.size() << ", reorder.contains(nut): "
+         << reorder.contains(records[1]) << endl;
+    IntrusiveDList<StockRecord, &StockRecord::recent>::Iterator last = recent.end();
+    try{
+        last.remove();
+    }
+    catch(out_of_range &e){
+        cout << "end().remove(): " << e.what() << ", size " << recent.size() << endl;
+    }
+    IntrusiveDList<StockRecord, &StockRecord::lowStock>::Iterator moved = reorder.begin(); // nut
+    reorder.remove(records[1]);
+    lowStock.add(records[1]);
+    try{
+        moved.remove();
+    }
+    catch(invalid_argument &e){
+        cout << "remove() after the item left the list: " << e.what() << ", lowStock.contains(nut): "
+             << lowStock.contains(records[1]) << endl;
+    }
+    reorder.clear();
+    lowStock.clear();
+    recent.clear();
+    cout << "after clear: bolt linked " << IntrusiveDList<StockRecord, &StockRecord::lowStock>::isLinked(records[0]) << endl;
+}
@@ -1,5 +1,24 @@
 #include <iostream>
 #include "app/inventory.h" 
+#include "app/importer.h"
+#include "app/wal.h"
+#include "app/concurrent.h"
+#include "app/workload.h"
+#include "app/query.h"
+#include "app/cache.h"
+#include "app/view.h"
+#include "test/alloc_budget.h"
+#include <thread>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <signal.h>
 
 using namespace std;
 
@@ -166,4 +185,1038 @@ void tc_inventory1006(){
     inventory.removeDuplicates();
     cout << "\nAfter removing duplicates:" << endl;
     cout << inventory.toString() << endl;
-}
\ No newline at end of file
+}
+
+void tc_inventory1007(){
+    const char *path = "tc_inventory1007.csv";
+    FILE *file = fopen(path, "wb");
+    fputs("name,w_kg,height,quantity,note\r\n"
+          "Product A,10,156,50,x\r\n"
+          "\"Product B, large\",20,,30,\"multi\nline \"\"note\"\"\"\r\n"
+          "\n"
+          "Product C,2.5e1,100, 20 ,\n"
+          "Product D,,,0,", file);
+    fclose(file);
+
+    InventoryManager inventory;
+    InventoryImporter importer(',', 2, 64); // tiny batch and buffer: records cross chunk boundaries
+    importer.mapColumn("w_kg", "weight");
+    importer.ignoreColumn("note");
+    long rows = importer.importFile(path, inventory);
+    remove(path);
+
+    cout << "Imported " << rows << " rows (" << importer.bytesRead() << " bytes)" << endl;
+    cout << inventory.toString() << endl;
+}
+
+void tc_inventory1008(){
+    InventoryManager inventory;
+    for (int i = 0; i < 1000; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i * 0.25), InventoryAttribute("height", 1e6 / (i + 1)) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 2), "Product " + to_string(i), i % 17);
+    }
+
+    const char *path = "tc_inventory1008.txt";
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    inventory.dump(fd);
+    close(fd);
+
+    ifstream in(path);
+    stringstream dumped;
+    dumped << in.rdbuf();
+    remove(path);
+
+    string text = inventory.toString();
+    cout << "toString: " << text.size() << " bytes, dump: " << dumped.str().size() << " bytes, "
+         << (text == dumped.str() ? "identical" : "DIFFERENT") << endl;
+    cout << text.substr(0, 120) << "..." << endl;
+}
+
+void tc_inventory1009(){
+    const string snap = "tc_inventory1009.snap", wal = "tc_inventory1009.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arrA[] = { InventoryAttribute("weight", 10), InventoryAttribute("height", 156) };
+    InventoryAttribute arrB[] = { InventoryAttribute("weight", 20) };
+
+    // 1. crash with a partially filled group: only the synced records survive
+    pid_t pid = fork();
+    if (pid == 0) {
+        InventoryManager inventory;
+        InventoryLog log(snap, wal, 4, 60000, 0);
+        inventory.setJournal(&log);
+        inventory.addProduct(List1D<InventoryAttribute>(arrA, 2), "Product A", 50);
+        inventory.addProduct(List1D<InventoryAttribute>(arrB, 1), "Product B", 30);
+        inventory.addProduct(List1D<InventoryAttribute>(arrB, 1), "Product C", 20);
+        inventory.updateQuantity(0, 45);                  // 4th record: group commit
+        inventory.removeProduct(1);
+        log.sync();                                       // explicit commit
+        inventory.updateQuantity(0, 1);                   // pending only ...
+        inventory.addProduct(List1D<InventoryAttribute>(arrA, 2), "Product D", 5);
+        _exit(0);                                         // ... crash: no destructor, no sync
+    }
+    waitpid(pid, 0, 0);
+
+    InventoryManager recovered;
+    long replayed = InventoryLog::recover(snap, wal, recovered);
+    cout << "After crash, replayed " << replayed << " records:" << endl;
+    cout << recovered.toString() << endl;
+
+    // 2. torn record at the end of the log is dropped
+    FILE *file = fopen(wal.c_str(), "ab");
+    fwrite("\x40\x00\x00\x00\x12\x34", 1, 6, file);
+    fclose(file);
+    InventoryManager torn;
+    replayed = InventoryLog::recover(snap, wal, torn);
+    cout << "After torn write, replayed " << replayed << " records, same state: "
+         << (torn.toString() == recovered.toString() ? "yes" : "no") << endl;
+
+    // 3. checkpoint, more mutations, clean shutdown
+    {
+        InventoryLog log(snap, wal, 1, 0, 0);
+        recovered.setJournal(&log);
+        recovered.updateQuantity(1, 25);
+        log.checkpoint(recovered);
+        cout << "Log size after checkpoint: " << log.size() << endl;
+        recovered.addProduct(List1D<InventoryAttribute>(arrB, 1), "Product E", 7);
+        recovered.removeDuplicates();
+        recovered.setJournal(nullptr);
+    }
+    InventoryManager restarted;
+    replayed = InventoryLog::recover(snap, wal, restarted);
+    cout << "After restart, replayed " << replayed << " records:" << endl;
+    cout << restarted.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+void tc_inventory1010(){
+    InventoryManager inventory;
+    for (int i = 0; i < 100; i++) {
+        InventoryAttribute arr[] = { InventoryAttribute("weight", i) };
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + to_string(i), 100);
+    }
+    ConcurrentInventory shared(inventory);
+
+    // writers move stock between products: every published version holds 100 * 100 items
+    atomic<bool> done(false);
+    atomic<long> reads(0), inconsistent(0);
+    thread writers[2];
+    for (int w = 0; w < 2; w++) {
+        writers[w] = thread([&shared, w]() {
+            for (int k = 0; k < 300; k++) {
+                int from = (k * 7 + w) % 100, to = (k * 13 + 5 * w + 1) % 100;
+                shared.update([from, to](InventoryManager &inv) {
+                    if (from == to) return;
+                    inv.updateQuantity(from, inv.getProductQuantity(from) - 1);
+                    inv.updateQuantity(to, inv.getProductQuantity(to) + 1);
+                });
+            }
+        });
+    }
+    thread readers[4];
+    for (int r = 0; r < 4; r++) {
+        readers[r] = thread([&]() {
+            while (!done.load()) {
+                shared_ptr<const InventoryManager> snap = shared.snapshot();
+                long total = 0;
+                for (int i = 0; i < snap->size(); i++)
+                    total += snap->getProductQuantity(i);
+                if (total != 100 * 100 || snap->query("weight", 10, 19, 0, true).size() != 10)
+                    inconsistent++;
+                shared.getProductName(reads % 100);
+                reads++;
+            }
+        });
+    }
+    for (int w = 0; w < 2; w++)
+        writers[w].join();
+    done = true;
+    for (int r = 0; r < 4; r++)
+        readers[r].join();
+
+    long total = 0;
+    for (int i = 0; i < shared.size(); i++)
+        total += shared.getProductQuantity(i);
+    cout << "Versions published: " << shared.version() << ", final total: " << total
+         << ", reads: " << (reads > 0 ? "yes" : "no") << ", inconsistent snapshots: " << inconsistent << endl;
+}
+
+void tc_inventory1011(){
+    InventoryManager inventory;
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 1) };
+    for (int i = 0; i < 4; i++)
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Hot SKU " + to_string(i), 10000);
+    inventory.setPaddedQuantities(true);
+
+    // 8 threads race to reserve from the same products; stock never goes negative
+    atomic<long> reserved(0);
+    thread workers[8];
+    for (int t = 0; t < 8; t++) {
+        workers[t] = thread([&inventory, &reserved, t]() {
+            long mine = 0;
+            for (int k = 0; k < 20000; k++) {
+                if (inventory.tryReserve((t + k) % 4, 1 + k % 3))
+                    mine += 1 + k % 3;
+                if (k % 10 == 0) {
+                    inventory.adjustQuantity(3, 1); // restock one, then try to take one back
+                    mine -= 1;
+                    if (inventory.tryReserve(3, 1))
+                        mine += 1;
+                }
+            }
+            reserved += mine;
+        });
+    }
+    for (int t = 0; t < 8; t++)
+        workers[t].join();
+
+    long left = 0;
+    bool negative = false;
+    for (int i = 0; i < inventory.size(); i++) {
+        left += inventory.getProductQuantity(i);
+        negative = negative || inventory.getProductQuantity(i) < 0;
+    }
+    cout << "Reserved + left = " << reserved + left << " (expected 40000), negative stock: "
+         << (negative ? "yes" : "no") << endl;
+    cout << inventory.getQuantities() << endl;
+
+    ConcurrentInventory shared(inventory);
+    shared.adjustQuantity(0, 5);
+    cout << "Concurrent adjust: " << shared.getProductQuantity(0) << ", reserve 6: "
+         << (shared.tryReserve(0, 6) ? "ok" : "out of stock") << endl;
+}
+
+void tc_inventory1012(){
+    WorkloadConfig config;
+    config.seed = 42;
+    config.products = 200;
+    config.duplicateRatio = 0.1;
+    WorkloadGenerator generator(config);
+
+    // same seed, same inventory and trace; the trace does not depend on generation order
+    Workload trace = generator.generateTrace(2000);
+    InventoryManager inventory, again;
+    generator.generateInventory(inventory);
+    generator.generateInventory(again);
+    cout << "Products: " << inventory.size() << ", identical: "
+         << (inventory.toString() == again.toString() ? "yes" : "no") << endl;
+    cout << "First products: " << inventory.getProductName(0) << " " << inventory.getProductAttributes(0)
+         << ", " << inventory.getProductName(1) << " " << inventory.getProductAttributes(1) << endl;
+    cout << "Trace starts: " << trace.get(0) << " " << trace.get(1) << " " << trace.get(2) << endl;
+    cout << "Operations: " << trace.size() << " (Q " << trace.count(WorkloadOperation::QUERY)
+         << ", U " << trace.count(WorkloadOperation::UPDATE) << ", A " << trace.count(WorkloadOperation::ADD)
+         << ", R " << trace.count(WorkloadOperation::REMOVE) << ")" << endl;
+
+    // replay on two backends, and from a saved copy of the trace
+    trace.save("tc_workload.trace");
+    Workload loaded = Workload::load("tc_workload.trace");
+    remove("tc_workload.trace");
+
+    InventoryManager direct(inventory);
+    ConcurrentInventory shared(inventory);
+    WorkloadResult r1 = trace.replay(direct);
+    WorkloadResult r2 = loaded.replay(shared);
+    cout << r1.toString() << endl;
+    cout << "Same result on ConcurrentInventory from the saved trace: "
+         << (r1.toString() == r2.toString() && direct.toString() == shared.snapshot()->toString() ? "yes" : "no")
+         << endl;
+
+    inventory.removeDuplicates();
+    cout << "After removeDuplicates: " << inventory.size() << " products" << endl;
+}
+
+void tc_inventory1013(){
+    WorkloadConfig config;
+    config.products = 300;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+
+    InventoryManager::resetStats();
+    generator.generateTrace(500).replay(inventory);
+    InventoryManager section1, section2;
+    inventory.split(section1, section2, 0.5);
+    InventoryManager merged = InventoryManager::merge(section1, section2);
+    merged.removeDuplicates();
+    cout << InventoryManager::stats();
+}
+
+void tc_inventory1014(){
+    WorkloadConfig config;
+    config.products = 1000;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+    List1D<InventoryAttribute> attributes = inventory.getProductAttributes(0);
+
+    // read-only query: rows are read in place, only the result is allocated
+    int matches = inventory.query("weight", 0, 100, 0, true).size();
+    checkAllocations("query on 1000 products (" + to_string(matches) + " matches)", matches + 16, [&]() {
+        inventory.query("weight", 0, 100, 0, true);
+    });
+    checkAllocations("getProductQuantity / getProductName / size", 0, [&]() {
+        inventory.getProductQuantity(3);
+        inventory.getProductName(3);
+        inventory.size();
+    });
+    checkAllocations("updateQuantity", 0, [&]() { inventory.updateQuantity(3, 5); });
+    checkAllocations("getProductAttributes", 2, [&]() { inventory.getProductAttributes(3); });
+    checkAllocations("addProduct", 4, [&]() { inventory.addProduct(attributes, "Product X", 3); });
+    checkAllocations("removeProduct", 0, [&]() { inventory.removeProduct(3); });
+    checkAllocations("toString of 1000 products", 16, [&]() { inventory.toString(); });
+}
+
+void tc_inventory1015(){
+    InventoryAttribute a0[] = { InventoryAttribute("price", 2.5), InventoryAttribute("weight", 10) };
+    InventoryAttribute a1[] = { InventoryAttribute("weight", 4) };
+    InventoryAttribute a2[] = { InventoryAttribute("price", 10), InventoryAttribute("weight", 7.5) };
+    InventoryAttribute a3[] = { InventoryAttribute("price", 1) };
+    InventoryManager inventory;
+    inventory.addProduct(List1D<InventoryAttribute>(a0, 2), "Bolt", 100);
+    inventory.addProduct(List1D<InventoryAttribute>(a1, 1), "Nut", 50);
+    inventory.addProduct(List1D<InventoryAttribute>(a2, 2), "Drill", 3);
+    inventory.addProduct(List1D<InventoryAttribute>(a3, 1), "Washer", 0);
+
+    AggregateResult weight = inventory.aggregate("weight");
+    cout << "weight: count " << weight.count << ", sum " << weight.sum << ", min " << weight.min
+         << ", max " << weight.max << ", avg " << weight.avg << endl;
+    AggregateResult stockValue = inventory.aggregate("price", AggregateOptions(AGGREGATE_SUM | AGGREGATE_AVG, true));
+    cout << "stock value: " << stockValue.sum << ", average unit price: " << stockValue.avg << endl;
+
+    AggregateOptions options(AGGREGATE_HISTOGRAM);
+    options.buckets = 3;
+    AggregateResult histogram = inventory.aggregate("weight", options);
+    cout << "weight histogram from " << histogram.histogramMin << " by " << histogram.bucketWidth << ": "
+         << histogram.histogram << endl;
+    cout << "missing attribute: count " << inventory.aggregate("color").count << endl;
+
+    // multi-threaded pass on a generated inventory gives the same answer
+    WorkloadConfig config;
+    config.products = 20000;
+    WorkloadGenerator generator(config);
+    InventoryManager big;
+    generator.generateInventory(big);
+    AggregateOptions single(AGGREGATE_ALL, true), parallel(AGGREGATE_ALL, true);
+    parallel.threads = 4;
+    AggregateResult r1 = big.aggregate("weight", single), r4 = big.aggregate("weight", parallel);
+    double relative = (r1.sum - r4.sum) / r1.sum;
+    cout << "1 vs 4 threads: same count " << (r1.count == r4.count) << ", same min/max "
+         << (r1.min == r4.min && r1.max == r4.max) << ", sums within 1e-12: " << (relative < 1e-12 && relative > -1e-12)
+         << ", same histogram: " << (r1.histogram.toString() == r4.histogram.toString()) << endl;
+}
+
+void tc_inventory1016(){
+    WorkloadConfig config;
+    config.products = 5000;
+    config.duplicateRatio = 0; // names are unique: name sets can be compared
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+
+    // weight in [100, 400] AND height > 200 AND quantity >= 100, the old way: three queries, intersected by hand
+    List1D<string> byWeight = inventory.query("weight", 100, 400, 100, true);
+    List1D<string> byHeight = inventory.query("height", 200.0000001, 1e300, 0, true);
+    List1D<string> expected;
+    for (int i = 0; i < byWeight.size(); i++)
+        for (int j = 0; j < byHeight.size(); j++)
+            if (byWeight.get(i) == byHeight.get(j)) {
+                expected.add(byWeight.get(i));
+                break;
+            }
+
+    QueryEngine engine(inventory);
+    Predicate p = Predicate::range("weight", 100, 400) && Predicate::above("height", 200) &&
+                  Predicate::quantityAtLeast(100);
+    cout << p.toString() << endl;
+    List1D<string> names = engine.names(p);
+    cout << "Without index: " << names.size() << " products, same as the queries: "
+         << (names.toString() == expected.toString() ? "yes" : "no") << endl;
+    engine.createIndex("weight");
+    engine.createIndex("height");
+    cout << "With indexes: " << (engine.names(p).toString() == expected.toString() ? "same" : "different")
+         << ", count " << engine.count(p) << endl;
+    cout << engine.explain(p);
+
+    // OR, nested in an AND; descending names; indices in increasing order
+    Predicate q = (Predicate::atMost("weight", 10) || Predicate::atLeast("price", 990)) && Predicate::quantityAtLeast(500);
+    long matching = 0;
+    for (int i = 0; i < inventory.size(); i++)
+        matching += q.matches(inventory, i);
+    cout << q.toString() << ": " << engine.count(q) << " products (expected " << matching << ")" << endl;
+    List1D<int> indices = engine.indices(q);
+    bool increasing = true;
+    for (int i = 1; i < indices.size(); i++)
+        increasing = increasing && indices.get(i - 1) < indices.get(i);
+    List1D<string> descending = engine.names(q, false);
+    cout << "indices increasing: " << (increasing ? "yes" : "no") << ", first name descending: "
+         << (descending.size() > 0 ? descending.get(0) : "-") << endl;
+
+    // indexes follow the inventory
+    InventoryAttribute heavy[] = { InventoryAttribute("weight", 250), InventoryAttribute("height", 999) };
+    int before = engine.count(p);
+    inventory.addProduct(List1D<InventoryAttribute>(heavy, 2), "Product new", 1000);
+    inventory.removeProduct(0);
+    long scanned = 0;
+    for (int i = 0; i < inventory.size(); i++)
+        scanned += p.matches(inventory, i);
+    cout << "After add/remove: " << engine.count(p) << " (scan " << scanned << ", before " << before << ")" << endl;
+}
+
+void tc_inventory1017(){
+    // RoaringBitmap against a dense Bitmap: sparse, medium and dense regions (array and bitmap containers)
+    const int universe = 300000;
+    SplitMix64 random(7);
+    RoaringBitmap r1, r2;
+    Bitmap b1(universe), b2(universe);
+    for (int v = 0; v < universe; v++) {
+        double p = v < 100000 ? 0.01 : (v < 200000 ? 0.2 : 0.9);
+        if (random.nextBool(p)) { r1.add(v); b1.set(v); }
+        if (random.nextBool(p / 2)) { r2.add(v); b2.set(v); }
+    }
+    r1.add(5); b1.set(5); // already there or not: added once
+    r1.add(5);
+    RoaringBitmap both = r1, either = r1, only = r1;
+    both &= r2;
+    either |= r2;
+    only.andNot(r2);
+    Bitmap bBoth = b1, bEither = b1, bOnly = b1;
+    bBoth &= b2;
+    bEither |= b2;
+    bOnly.andNot(b2);
+    auto same = [](const RoaringBitmap &r, const Bitmap &b) {
+        bool equal = r.count() == b.count();
+        r.forEach([&](uint32_t v) { equal = equal && b.test((int)v); });
+        return equal;
+    };
+    cout << "count " << (r1.count() == b1.count()) << ", and " << same(both, bBoth) << ", or " << same(either, bEither)
+         << ", andNot " << same(only, bOnly) << endl;
+    cout << "contains 5: " << r1.contains(5) << ", contains 299999 in r2: " << (r2.contains(299999) == b2.test(299999))
+         << ", or is commutative: " << (either == (RoaringBitmap(r2) |= r1)) << endl;
+
+    long rank = r1.count() / 2;
+    uint32_t middle = r1.select(rank);
+    long before = 0;
+    b1.forEach([&](int v) { before += v < (int)middle; });
+    cout << "select(count / 2) has " << (before == rank ? "count / 2" : "wrong number of") << " smaller values" << endl;
+    List1D<uint32_t> page;
+    r1.forEachRange(rank - 2, 5, [&](uint32_t v) { page.add(v); });
+    cout << "page of 5 around it: " << page.size() << " values, third is it: " << (page.get(2) == middle) << endl;
+    try {
+        r1.select(r1.count());
+    } catch (const out_of_range &e) {
+        cout << "select(count): " << e.what() << endl;
+    }
+    cout << "sparse region compressed: " << (r1.memoryUsage() < universe / 8 ? "yes" : "no") << endl;
+
+    // queryRows: same products as query, no names until a page is fetched
+    WorkloadConfig config;
+    config.products = 3000;
+    config.duplicateRatio = 0;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+    RoaringBitmap rows = inventory.queryRows("weight", 100, 400, 100);
+    List1D<string> names = inventory.query("weight", 100, 400, 100, true);
+    cout << "queryRows: " << rows.count() << " rows, query: " << names.size() << " names" << endl;
+    rows &= inventory.queryRows("height", 200, 1e300, 0);
+    QueryEngine engine(inventory);
+    cout << "weight AND height: " << rows.count() << " rows, same as QueryEngine: "
+         << (rows == engine.rows(Predicate::range("weight", 100, 400) && Predicate::atLeast("height", 200) &&
+                                 Predicate::quantityAtLeast(100)) ? "yes" : "no") << endl;
+    cout << "page 2 (size 3): " << inventory.getProductNames(rows, 3, 3) << endl;
+    checkAllocations("count of queryRows on 3000 products", 16, [&]() {
+        inventory.queryRows("weight", 100, 400, 100).count();
+    });
+}
+
+void tc_inventory1018(){
+    WorkloadConfig config;
+    config.products = 2000;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+
+    // cached results stay equal to query's through every kind of change, patched or invalidated
+    const char *attributes[] = {"weight", "height", "price", "weight"};
+    double lows[] = {100, 0, 500, 0}, highs[] = {300, 50, 1000, 1000};
+    int minQuantities[] = {100, 0, 500, 990};
+    for (int patching = 1; patching >= 0; patching--) {
+        InventoryManager copy(inventory);
+        QueryCache cache(copy, 1L << 20, patching == 1);
+        SplitMix64 random(11);
+        int mismatches = 0;
+        for (int step = 0; step < 400; step++) {
+            int index = random.nextInt(copy.size());
+            int kind = random.nextInt(10);
+            if (kind < 6)
+                copy.updateQuantity(index, random.nextInt(1000));
+            else if (kind == 6)
+                copy.adjustQuantity(index, random.nextInt(200) - 100);
+            else if (kind == 7)
+                copy.tryReserve(index, 1 + random.nextInt(49));
+            else if (kind == 8)
+                copy.addProduct(copy.getProductAttributes(index), "Product new " + to_string(step), random.nextInt(1000));
+            else
+                copy.removeProduct(index);
+            for (int q = 0; q < 4; q++) {
+                bool ascending = q % 2 == 0;
+                const List1D<string> &cached = cache.query(attributes[q], lows[q], highs[q], minQuantities[q], ascending);
+                List1D<string> direct = copy.query(attributes[q], lows[q], highs[q], minQuantities[q], ascending);
+                mismatches += cached.toString() != direct.toString();
+            }
+        }
+        cout << (patching ? "patching" : "invalidating") << ": " << mismatches << " mismatches, hits "
+             << (cache.hits() > 0 ? "yes" : "no") << ", patches " << (cache.patches() > 0 ? "yes" : "no")
+             << ", hits + misses = " << cache.hits() + cache.misses() << endl;
+    }
+
+    // LRU within the memory budget; a hit allocates nothing
+    QueryCache small(inventory, 16 * 1024);
+    for (int q = 0; q < 50; q++)
+        small.query("weight", q * 10, q * 10 + 100, 0, true);
+    cout << "small cache: " << small.size() << " entries kept, within budget: "
+         << (small.memoryUsage() <= small.memoryBudget() ? "yes" : "no") << ", evictions: "
+         << (small.evictions() > 0 ? "yes" : "no") << endl;
+    small.query("weight", 490, 590, 0, true);
+    checkAllocations("cache hit", 0, [&]() { small.query("weight", 490, 590, 0, true); });
+
+    // assignment clears the cache
+    QueryCache cache(inventory);
+    long before = cache.query("height", 0, 100, 0, true).size();
+    InventoryManager other;
+    inventory = other;
+    cout << "before assignment " << (before > 0 ? "some" : "no") << " products, after "
+         << cache.query("height", 0, 100, 0, true).size() << endl;
+}
+
+class CountingListener : public ViewListener {
+public:
+    long entered = 0, left = 0, updated = 0, resets = 0;
+    void productEntered(const MaterializedView &view, int index) { entered++; }
+    void productLeaving(const MaterializedView &view, int index) { left++; }
+    void memberUpdated(const MaterializedView &view, int index, int oldQuantity) { updated++; }
+    void viewReset(const MaterializedView &view) { resets++; }
+};
+
+void tc_inventory1019(){
+    // Bitmap follows a list: erase shifts the higher bits down
+    Bitmap bits(130);
+    bits.set(0); bits.set(63); bits.set(64); bits.set(129);
+    bits.erase(63);
+    bits.resize(200);
+    bits.set(199);
+    List1D<int> set;
+    bits.forEach([&](int i) { set.add(i); });
+    cout << "Bitmap after erase(63), resize(200), set(199): " << set << ", size " << bits.size() << endl;
+
+    WorkloadConfig config;
+    config.products = 1000;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+
+    // low stock items with a small weight, kept up to date through a random sequence of changes
+    Predicate lowStock = Predicate::below("weight", 300) && Predicate::quantityAtMost(100);
+    MaterializedView view(inventory, lowStock);
+    MaterializedView heavy(inventory, Predicate::atLeast("weight", 900)); // no quantity condition
+    CountingListener listener;
+    view.addListener(&listener);
+    cout << lowStock.toString() << ": " << view.count() << " products" << endl;
+
+    SplitMix64 random(5);
+    long start = view.count();
+    int mismatches = 0;
+    for (int step = 0; step < 2000; step++) {
+        int index = random.nextInt(inventory.size());
+        int kind = random.nextInt(10);
+        if (kind < 6)
+            inventory.updateQuantity(index, random.nextInt(1000));
+        else if (kind == 6)
+            inventory.adjustQuantity(index, random.nextInt(200) - 100);
+        else if (kind == 7)
+            inventory.addProduct(inventory.getProductAttributes(index), "Product new " + to_string(step), random.nextInt(200));
+        else
+            inventory.removeProduct(index);
+        if (step % 100 == 0) {
+            QueryEngine engine(inventory);
+            mismatches += view.indices().toString() != engine.indices(lowStock).toString();
+            mismatches += heavy.indices().toString() != engine.indices(Predicate::atLeast("weight", 900)).toString();
+        }
+    }
+    QueryEngine engine(inventory);
+    mismatches += view.names(false).toString() != engine.names(lowStock, false).toString();
+    cout << "After 2000 changes: " << mismatches << " mismatches, " << inventory.size() << " products" << endl;
+    cout << "entered - left = " << listener.entered - listener.left << ", count change = " << view.count() - start
+         << ", member updates: " << (listener.updated > 0 ? "yes" : "no") << endl;
+
+    inventory.removeDuplicates();
+    cout << "After removeDuplicates: " << (view.indices().toString() == engine.indices(lowStock).toString() ? "consistent" : "stale")
+         << endl;
+    inventory = InventoryManager();
+    cout << "After assignment: " << view.count() << " members, resets " << listener.resets << endl;
+    checkAllocations("view count", 0, [&]() { view.count(); heavy.count(); });
+}
+
+void tc_inventory1020(){
+    // attribute rows: up to List2D::ROW_INLINE attributes inside the row, one allocation per row
+    InventoryAttribute arrA[] = { InventoryAttribute("weight", 10), InventoryAttribute("height", 156) };
+    InventoryAttribute arrB[] = { InventoryAttribute("weight", 20), InventoryAttribute("depth", 24),
+                                  InventoryAttribute("height", 100), InventoryAttribute("width", 7),
+                                  InventoryAttribute("color", 3) };
+    List1D<InventoryAttribute> listA(arrA, 2), listB(arrB, 5);
+    List1D<InventoryAttribute> rows[2] = { listA, listB };
+    List2D<InventoryAttribute> matrix(rows, 2);
+
+    // the first addRow also grows the array of rows (capacity 2 to 4)
+    checkAllocations("List2D::addRow of 2 attributes", 1 + 1, [&]() { matrix.addRow(listA); });
+    checkAllocations("List2D::addRow of 5 attributes", 2, [&]() { matrix.addRow(listB); });
+    checkAllocations("List2D copy of 4 rows", 2 + 4 + 2, [&]() { List2D<InventoryAttribute> copy(matrix); });
+    matrix.setRow(0, listB);
+    matrix.setRow(1, listA);
+    matrix.removeRow(2);
+    cout << matrix.rows() << " rows: " << matrix.toString() << endl;
+
+    InventoryManager inventory;
+    inventory.addProduct(listA, "Product A", 5);
+    cout << inventory.toString() << endl;
+}
+
+void tc_inventory1021(){
+    // List1D<int> scans: indexOf / countOf (SIMD for int, see XArrayList::indexOf)
+    int quantitiesArray[] = {5, 0, 12, 0, 7, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0};
+    List1D<int> quantities(quantitiesArray, 21);
+    cout << "indexOf(0): " << quantities.indexOf(0) << ", countOf(0): " << quantities.countOf(0)
+         << ", countOf(3): " << quantities.countOf(3) << ", indexOf(8): " << quantities.indexOf(8) << endl;
+    checkAllocations("List1D<int>::indexOf / countOf", 0, [&]() {
+        quantities.indexOf(7);
+        quantities.countOf(3);
+    });
+
+    List1D<string> names;
+    names.add("Product A");
+    names.add("Product B");
+    names.add("Product A");
+    cout << "indexOf(Product B): " << names.indexOf("Product B") << ", countOf(Product A): " << names.countOf("Product A") << endl;
+
+    // the same scans on the live quantity column, packed (SIMD) and padded
+    InventoryManager inventory;
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 1) };
+    for (int i = 0; i < 21; i++)
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product " + to_string(i), quantitiesArray[i]);
+    for (int padded = 0; padded < 2; padded++) {
+        inventory.setPaddedQuantities(padded == 1);
+        cout << (padded ? "padded" : "packed") << ": indexOfQuantity(0): " << inventory.indexOfQuantity(0)
+             << ", countOfQuantity(0): " << inventory.countOfQuantity(0) << ", countOfQuantity(3): "
+             << inventory.countOfQuantity(3) << ", indexOfQuantity(8): " << inventory.indexOfQuantity(8) << endl;
+    }
+    checkAllocations("InventoryManager::indexOfQuantity / countOfQuantity", 0, [&]() {
+        inventory.indexOfQuantity(7);
+        inventory.countOfQuantity(3);
+    });
+}
+
+void tc_inventory1022(){
+    const string snap = "tc_inventory1022.snap", wal = "tc_inventory1022.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10) };
+
+    // 1. the last records of a burst are synced by the flusher, without another mutation
+    {
+        InventoryManager inventory;
+        InventoryLog log(snap, wal, 1000, 20, 0);
+        inventory.setJournal(&log);
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product A", 50);
+        inventory.updateQuantity(0, 40);
+        for (int wait = 0; wait < 100 && log.lastDurableLsn() != log.lastLsn(); wait++)
+            this_thread::sleep_for(chrono::milliseconds(10));
+        cout << "After the burst: lsn " << log.lastLsn() << ", durable " << log.lastDurableLsn() << endl;
+        inventory.setJournal(nullptr);
+    }
+
+    // 2. a failed sync drops the record being logged: the mutation is neither applied nor logged
+    pid_t pid = fork();
+    if (pid == 0) {
+        InventoryManager inventory;
+        InventoryLog::recover(snap, wal, inventory);
+        InventoryLog log(snap, wal, 1, 0, 0);
+        inventory.setJournal(&log);
+        struct stat st;
+        stat(wal.c_str(), &st);
+        struct rlimit limit, full;
+        getrlimit(RLIMIT_FSIZE, &full);
+        limit = full;
+        limit.rlim_cur = (rlim_t)st.st_size; // the log cannot grow: the next write fails
+        signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limit);
+        long long lsn = log.lastLsn();
+        bool failed = false;
+        try {
+            inventory.updateQuantity(0, 1);
+        }
+        catch (runtime_error &e) {
+            failed = true;
+        }
+        setrlimit(RLIMIT_FSIZE, &full); // stdout may be a file too
+        cout << "updateQuantity failed: " << (failed ? "yes" : "no") << ", quantity " << inventory.getProductQuantity(0)
+             << ", lsn restored: " << (log.lastLsn() == lsn ? "yes" : "no") << endl;
+        inventory.updateQuantity(0, 35); // synced: the failed record must not come back with it
+        inventory.setJournal(nullptr);
+        _exit(0);
+    }
+    waitpid(pid, 0, 0);
+    InventoryManager recovered;
+    long replayed = InventoryLog::recover(snap, wal, recovered);
+    cout << "Replayed " << replayed << " records: " << recovered.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+void tc_inventory1023(){
+    const string snap = "tc_inventory1023.snap", wal = "tc_inventory1023.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10) };
+    {
+        InventoryLog log(snap, wal, 1, 0, 0);
+        ConcurrentInventory shared;
+        shared.setJournal(&log);
+        shared.addProduct(List1D<InventoryAttribute>(arr, 1), "Product A", 50);
+        try {
+            shared.update([](InventoryManager &inventory) {
+                inventory.updateQuantity(0, 10);
+                inventory.removeProduct(5); // throws: the update above must not be logged either
+            });
+        }
+        catch (out_of_range &e) {
+            cout << "Mutation failed: " << e.what() << endl;
+        }
+        shared.update([&](InventoryManager &inventory) {
+            inventory.updateQuantity(0, 45);
+            inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Product B", 5);
+        });
+        cout << "Published: " << shared.snapshot()->toString() << endl;
+        cout << "Logged records: " << log.lastLsn() + 1 << endl;
+        shared.setJournal(nullptr);
+    }
+    InventoryManager recovered;
+    long replayed = InventoryLog::recover(snap, wal, recovered);
+    cout << "Replayed " << replayed << " records: " << recovered.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+// counts how often each quantity is reported as the result of a reservation
+class ReservationRecorder : public InventoryObserver
+{
+public:
+    atomic<int> *seen;
+    atomic<int> mismatched;
+    ReservationRecorder(int maxQuantity) : seen(new atomic<int>[maxQuantity + 1]), mismatched(0) {
+        for (int i = 0; i <= maxQuantity; i++)
+            seen[i] = 0;
+    }
+    ~ReservationRecorder() { delete[] seen; }
+    void productAdded(const InventoryManager &inventory, int index) {}
+    void productRemoving(const InventoryManager &inventory, int index) {}
+    void quantityChanged(const InventoryManager &inventory, int index, int oldQuantity, int newQuantity) {
+        if (oldQuantity - newQuantity != 1 || newQuantity < 0)
+            mismatched++;
+        else
+            seen[newQuantity]++;
+    }
+    void inventoryReplaced(const InventoryManager &inventory) {}
+};
+
+void tc_inventory1024(){
+    const int stock = 40000;
+    InventoryManager inventory;
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 1) };
+    inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Hot SKU", stock);
+    ReservationRecorder recorder(stock);
+    inventory.addObserver(&recorder);
+
+    // every reservation must report the quantity it stored itself: each value exactly once
+    thread workers[8];
+    for (int t = 0; t < 8; t++) {
+        workers[t] = thread([&inventory]() {
+            while (inventory.tryReserve(0, 1)) {
+            }
+        });
+    }
+    for (int t = 0; t < 8; t++)
+        workers[t].join();
+    inventory.removeObserver(&recorder);
+
+    int missing = 0, repeated = 0;
+    for (int q = 0; q < stock; q++) {
+        if (recorder.seen[q] == 0)
+            missing++;
+        else if (recorder.seen[q] > 1)
+            repeated++;
+    }
+    cout << "Left: " << inventory.getProductQuantity(0) << ", reported quantities missing: " << missing
+         << ", repeated: " << repeated << ", wrong deltas: " << recorder.mismatched << endl;
+
+    // a reservation of zero or fewer items is rejected, and nothing is reported
+    inventory.updateQuantity(0, 10);
+    inventory.addObserver(&recorder);
+    int invalid[] = { 0, -5, INT_MIN };
+    for (int n : invalid) {
+        try {
+            inventory.tryReserve(0, n);
+            cout << "tryReserve(0, " << n << ") accepted" << endl;
+        }
+        catch (invalid_argument &e) {
+            cout << "tryReserve(0, " << n << "): " << e.what() << endl;
+        }
+    }
+    inventory.removeObserver(&recorder);
+    cout << "Quantity: " << inventory.getProductQuantity(0) << ", wrong deltas: " << recorder.mismatched << endl;
+}
+
+void tc_inventory1025(){
+    // products with as many attributes as a WorkloadConfig allows survive save / load
+    WorkloadConfig config;
+    config.seed = 7;
+    config.products = 20;
+    config.attributeNames = 100;
+    config.maxAttributesPerProduct = 64;
+    config.queryRatio = 0.2;
+    config.addRatio = 0.8;
+    config.updateRatio = 0;
+    config.removeRatio = 0;
+    WorkloadGenerator generator(config);
+    Workload trace = generator.generateTrace(200);
+    List1D<InventoryAttribute> widest;
+    for (int rank = 1; rank <= generator.getConfig().maxAttributesPerProduct; rank++)
+        widest.add(InventoryAttribute(generator.attributeName(rank), rank / 3.0));
+    trace.addProduct(widest, "Widest product", 1);
+
+    trace.save("tc_inventory1025.trace");
+    Workload loaded = Workload::load("tc_inventory1025.trace");
+    remove("tc_inventory1025.trace");
+
+    int mostAttributes = 0;
+    bool same = loaded.size() == trace.size();
+    for (int i = 0; same && i < trace.size(); i++) {
+        same = trace.get(i) == loaded.get(i);
+        if (same && trace.get(i).type == WorkloadOperation::ADD) {
+            List1D<InventoryAttribute> attributes = loaded.getAttributes(i);
+            same = attributes.toString() == trace.getAttributes(i).toString();
+            mostAttributes = max(mostAttributes, attributes.size());
+        }
+    }
+    InventoryManager direct, fromFile;
+    generator.generateInventory(direct);
+    generator.generateInventory(fromFile);
+    WorkloadResult r1 = trace.replay(direct);
+    WorkloadResult r2 = loaded.replay(fromFile);
+    cout << "Operations: " << loaded.size() << ", most attributes on a loaded product: " << mostAttributes
+         << ", identical after load: " << (same ? "yes" : "no")
+         << ", same replay: " << (r1.toString() == r2.toString() ? "yes" : "no") << endl;
+}
+
+void tc_inventory1026(){
+    // array containers against each other: blocks of 8 values in step, out of step, and the tails
+    SplitMix64 random(11);
+    const double densities[] = { 0.001, 0.01, 0.03, 0.06 };
+    int trials = 0, mismatches = 0;
+    for (int da = 0; da < 4; da++) {
+        for (int db = 0; db < 4; db++) {
+            for (int t = 0; t < 5; t++, trials++) {
+                RoaringBitmap r1, r2;
+                Bitmap b1(65536), b2(65536);
+                int from = random.nextInt(30000), to = from + 30000 + random.nextInt(5000);
+                for (int v = from; v < to; v++) {
+                    if (random.nextBool(densities[da])) { r1.add(v); b1.set(v); }
+                    if (random.nextBool(densities[db])) { r2.add(v); b2.set(v); }
+                }
+                RoaringBitmap both = r1, only = r1;
+                both &= r2;
+                only.andNot(r2);
+                Bitmap bBoth = b1, bOnly = b1;
+                bBoth &= b2;
+                bOnly.andNot(b2);
+                bool equal = both.count() == bBoth.count() && only.count() == bOnly.count();
+                both.forEach([&](uint32_t v) { equal = equal && bBoth.test((int)v); });
+                only.forEach([&](uint32_t v) { equal = equal && bOnly.test((int)v); });
+                mismatches += !equal;
+            }
+        }
+    }
+    cout << "Array intersections and differences checked: " << trials << ", mismatches: " << mismatches << endl;
+}
+
+void tc_inventory1027(){
+    const string snap = "tc_inventory1027.snap", wal = "tc_inventory1027.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10) };
+    auto names = [](const InventoryManager &inventory) {
+        string text;
+        for (int i = 0; i < inventory.size(); i++)
+            text += (i > 0 ? ", " : "") + inventory.getProductName(i);
+        return "[" + text + "]";
+    };
+    {
+        InventoryLog log(snap, wal, 1, 0, 0);
+        InventoryManager a, b;
+        a.setJournal(&log);
+        a.addProduct(List1D<InventoryAttribute>(arr, 1), "A", 1);
+        b = a; // b keeps its own (no) journal: its changes are not logged for a
+        b.addProduct(List1D<InventoryAttribute>(arr, 1), "B", 2);
+        a = InventoryManager(); // a keeps its journal, which records the replacement
+        a.addProduct(List1D<InventoryAttribute>(arr, 1), "Z", 3);
+        cout << "b journal: " << (b.getJournal() == nullptr ? "none" : "a's log")
+             << ", a journal: " << (a.getJournal() == &log ? "kept" : "lost") << endl;
+        cout << "a: " << names(a) << endl;
+
+        // the same through ConcurrentInventory: records before and after the assignment are covered
+        ConcurrentInventory shared(a);
+        shared.setJournal(&log);
+        shared.update([&](InventoryManager &inventory) {
+            inventory.addProduct(List1D<InventoryAttribute>(arr, 1), "Lost", 4);
+            inventory = b;
+            inventory.updateQuantity(1, 20);
+        });
+        cout << "shared: " << names(*shared.snapshot()) << endl;
+        shared.setJournal(nullptr);
+    }
+    InventoryManager recovered;
+    InventoryLog::recover(snap, wal, recovered);
+    cout << "Recovered: " << recovered.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+void tc_inventory1028(){
+    const string snap = "tc_inventory1028.snap", wal = "tc_inventory1028.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    WorkloadConfig config;
+    config.products = 2000;
+    config.duplicateRatio = 0.3;
+    WorkloadGenerator generator(config);
+    InventoryManager inventory;
+    generator.generateInventory(inventory);
+
+    // reference: the first product of each name, with the quantities of the name added up
+    InventoryManager expected;
+    for (int i = 0; i < inventory.size(); i++) {
+        int first = -1;
+        for (int j = 0; j < expected.size() && first < 0; j++)
+            if (expected.getProductName(j) == inventory.getProductName(i))
+                first = j;
+        if (first < 0)
+            expected.addProduct(inventory.getProductAttributes(i), inventory.getProductName(i), inventory.getProductQuantity(i));
+        else
+            expected.updateQuantity(first, expected.getProductQuantity(first) + inventory.getProductQuantity(i));
+    }
+
+    long mismatches = 0;
+    {
+        InventoryLog log(snap, wal, 64, 0, 0);
+        log.checkpoint(inventory);
+        inventory.setJournal(&log);
+        QueryCache cache(inventory);
+        cache.query("weight", 0, 500, 300, true);
+        cache.query("height", 0, 1000, 0, false);
+        inventory.removeDuplicates();
+        mismatches += cache.query("weight", 0, 500, 300, true).toString() !=
+                      inventory.query("weight", 0, 500, 300, true).toString();
+        mismatches += cache.query("height", 0, 1000, 0, false).toString() !=
+                      inventory.query("height", 0, 1000, 0, false).toString();
+        inventory.setJournal(nullptr);
+    }
+    InventoryManager recovered;
+    InventoryLog::recover(snap, wal, recovered);
+    cout << config.products << " products, " << inventory.size() << " after removeDuplicates, as expected: "
+         << (inventory.toString() == expected.toString() ? "yes" : "no") << ", recovered from the log: "
+         << (recovered.toString() == inventory.toString() ? "yes" : "no") << ", cache mismatches: " << mismatches << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+// a write-ahead log whose logRemove fails, as a full disk would
+class FailingRemoveLog : public InventoryLog
+{
+public:
+    FailingRemoveLog(const string &snap, const string &wal) : InventoryLog(snap, wal, 1, 0, 0) {}
+    void logRemove(int index) { throw runtime_error("Cannot write: no space left on device"); }
+};
+
+void tc_inventory1029(){
+    const string snap = "tc_inventory1029.snap", wal = "tc_inventory1029.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10) };
+    {
+        FailingRemoveLog log(snap, wal);
+        ConcurrentInventory shared;
+        shared.setJournal(&log);
+        shared.addProduct(List1D<InventoryAttribute>(arr, 1), "Product A", 50);
+        shared.addProduct(List1D<InventoryAttribute>(arr, 1), "Product B", 60);
+        long logged = log.size();
+        try {
+            // every record is synced on its own (group size 1): the two updates must not be written
+            shared.update([](InventoryManager &inventory) {
+                inventory.updateQuantity(0, 10);
+                inventory.updateQuantity(1, 20);
+                inventory.removeProduct(0);
+            });
+        }
+        catch (runtime_error &e) {
+            cout << "Journal failed: " << e.what() << endl;
+        }
+        cout << "Published: " << shared.snapshot()->toString() << endl;
+        cout << "Log unchanged: " << (log.size() == logged ? "yes" : "no") << ", last LSN: " << log.lastLsn() << endl;
+        shared.update([](InventoryManager &inventory) {
+            inventory.updateQuantity(0, 45);
+            inventory.updateQuantity(1, 55);
+        });
+        cout << "Logged records: " << log.lastLsn() + 1 << endl;
+        shared.setJournal(nullptr);
+    }
+    InventoryManager recovered;
+    long replayed = InventoryLog::recover(snap, wal, recovered);
+    cout << "Replayed " << replayed << " records: " << recovered.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
+
+void tc_inventory1030(){
+    const string snap = "tc_inventory1030.snap", wal = "tc_inventory1030.wal";
+    remove(snap.c_str());
+    remove(wal.c_str());
+    InventoryAttribute arr[] = { InventoryAttribute("weight", 10) };
+    InventoryManager inventory;
+    const char *names[] = { "Product A", "Product B", "Product A", "Product C", "Product B" };
+    for (int i = 0; i < 5; i++)
+        inventory.addProduct(List1D<InventoryAttribute>(arr, 1), names[i], 10 * (i + 1));
+    string before = inventory.toString();
+    {
+        // the journal fails at the first removal, after the merged quantities were logged
+        FailingRemoveLog log(snap, wal);
+        log.checkpoint(inventory);
+        inventory.setJournal(&log);
+        try {
+            inventory.removeDuplicates();
+        }
+        catch (runtime_error &e) {
+            cout << "Journal failed: " << e.what() << endl;
+        }
+        inventory.setJournal(nullptr);
+        cout << "Inventory unchanged: " << (inventory.toString() == before ? "yes" : "no")
+             << ", logged records: " << log.lastLsn() + 1 << endl;
+    }
+    InventoryManager recovered;
+    long replayed = InventoryLog::recover(snap, wal, recovered);
+    cout << "Replayed " << replayed << " records, recovered unchanged: "
+         << (recovered.toString() == before ? "yes" : "no") << endl;
+    inventory.removeDuplicates();
+    cout << inventory.toString() << endl;
+    remove(snap.c_str());
+    remove(wal.c_str());
+}
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <algorithm>
+#include "util/Point.h"
+#include "util/KDTree.h"
+#include "util/PointCloud.h"
+#include <cstring>
+#include "util/Random.h"
+#include "util/Parallel.h"
+#include <atomic>
+#include <stdexcept>
+using namespace std;
+
+float pointDistance2(const Point &a, const Point &b){
+    float dx = a.getX() - b.getX(), dy = a.getY() - b.getY(), dz = a.getZ() - b.getZ();
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void pointDemo1(){
+    // KDTree against brute force on 20000 random bins
+    const int n = 20000;
+    Point *bins = Point::genPoints(n, 0, 100, true, 3);
+    KDTree tree(bins, n);
+    SplitMix64 random(9);
+    int wrongNearest = 0, wrongKNearest = 0, wrongRadius = 0, wrongBox = 0;
+    for (int q = 0; q < 200; q++) {
+        Point query((float)random.nextDouble(-10, 110), (float)random.nextDouble(-10, 110), (float)random.nextDouble(-10, 110));
+
+        int *order = new int[n];
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        sort(order, order + n, [&](int a, int b) {
+            float da = pointDistance2(bins[a], query), db = pointDistance2(bins[b], query);
+            return da < db || (da == db && a < b);
+        });
+        wrongNearest += tree.nearest(query) != order[0];
+        XArrayList<int> k = tree.kNearest(query, 10);
+        for (int i = 0; i < 10; i++)
+            wrongKNearest += k.get(i) != order[i];
+        delete[] order;
+
+        float r = (float)random.nextDouble(0, 15);
+        long inRadius = 0, inBox = 0;
+        Point low(query.getX() - r, query.getY() - r, query.getZ() - r);
+        Point high(query.getX() + r, query.getY() + r, query.getZ() + r);
+        for (int i = 0; i < n; i++) {
+            inRadius += pointDistance2(bins[i], query) <= r * r;
+            inBox += bins[i].getX() >= low.getX() && bins[i].getX() <= high.getX() &&
+                     bins[i].getY() >= low.getY() && bins[i].getY() <= high.getY() &&
+                     bins[i].getZ() >= low.getZ() && bins[i].getZ() <= high.getZ();
+        }
+        wrongRadius += tree.radius(query, r).size() != inRadius;
+        wrongBox += tree.box(low, high).size() != inBox;
+    }
+    cout << "KDTree of " << tree.size() << " points, 200 queries: wrong nearest " << wrongNearest
+         << ", wrong k-nearest " << wrongKNearest << ", wrong radius " << wrongRadius << ", wrong box " << wrongBox << endl;
+
+    Point few[] = { Point(0, 0, 0), Point(1, 0, 0), Point(0, 2, 0), Point(5, 5, 5), Point(1, 0, 0) };
+    KDTree small(few, 5);
+    cout << "nearest to (0.9, 0, 0): " << small.nearest(Point(0.9f, 0, 0)) << " (tie goes to the smaller index)" << endl;
+    cout << "3 nearest to the origin: " << small.kNearest(Point(), 3).toString() << endl;
+    cout << "within 1.5 of the origin: " << small.radius(Point(), 1.5f).size() << ", in box [0,1]^3: "
+         << small.box(Point(0, 0, 0), Point(1, 1, 1)).size() << endl;
+    try {
+        KDTree empty(few, 0);
+        empty.nearest(Point());
+    } catch (const out_of_range &e) {
+        cout << "nearest on an empty tree: " << e.what() << endl;
+    }
+    delete[] bins;
+}
+
+void pointDemo2(){
+    // PointCloud kernels against the Point methods on 10003 points (not a multiple of the SIMD width)
+    const int n = 10003;
+    Point *points = Point::genPoints(n, -50, 50, true, 5);
+    XArrayList<Point> list(0, 0, n);
+    for (int i = 0; i < n; i++)
+        list.add(points[i]);
+    PointCloud cloud(list);
+    cout << "cloud of " << cloud.size() << " points, arrays 64-byte aligned: " << boolalpha
+         << ((uintptr_t)cloud.x() % 64 == 0 && (uintptr_t)cloud.y() % 64 == 0 && (uintptr_t)cloud.z() % 64 == 0) << endl;
+
+    float *radii = new float[n], *distances = new float[n];
+    cloud.radii(radii);
+    Point query(3, -4, 12);
+    cloud.distances(query, distances);
+    int wrongRadius = 0, wrongDistance = 0;
+    for (int i = 0; i < n; i++) {
+        wrongRadius += fabsf(radii[i] - points[i].radius()) > 1e-4f * points[i].radius();
+        float d = sqrtf(pointDistance2(points[i], query));
+        wrongDistance += fabsf(distances[i] - d) > 1e-4f * d;
+    }
+    cout << "wrong radii " << wrongRadius << ", wrong distances " << wrongDistance << endl;
+
+    // indexOf against XArrayList<Point>::indexOf, also on points just off the stored ones
+    int wrongIndexOf = 0;
+    for (int i = 0; i < n; i += 97) {
+        Point p = points[i];
+        Point off(nextafterf(p.getX(), INFINITY), p.getY(), p.getZ());
+        wrongIndexOf += cloud.indexOf(p) != list.indexOf(p);
+        wrongIndexOf += cloud.indexOf(off) != list.indexOf(off);
+    }
+    cout << "wrong indexOf " << wrongIndexOf << ", indexOf(point 10002) = " << cloud.indexOf(points[n - 1])
+         << ", indexOf(absent) = " << cloud.indexOf(Point(1000, 1000, 1000)) << endl;
+
+    XArrayList<Point> back = cloud.toList();
+    bool same = back.size() == n;
+    for (int i = 0; same && i < n; i++)
+        same = back.get(i) == points[i];
+    cout << "toList round trip: " << same << noboolalpha << endl;
+
+    PointCloud small;
+    small.add(Point(3, 4, 0));
+    small.add(Point(1, 2, 2));
+    small.set(0, Point(0, 0, 5));
+    float r[2];
+    small.radii(r);
+    cout << "small cloud: " << small.get(0) << " " << small.get(1) << ", radii " << r[0] << " " << r[1]
+         << ", indexOf((1,2,2)) = " << small.indexOf(Point(1, 2, 2)) << endl;
+    try {
+        small.get(2);
+    } catch (const out_of_range &e) {
+        cout << "get(2) on 2 points: " << e.what() << endl;
+    }
+    delete[] radii;
+    delete[] distances;
+    delete[] points;
+}
+
+void pointDemo3(){
+    // counter-based genPoints: the same points for any range split and any number of threads
+    const long n = 300000;
+    Point *one = new Point[n], *four = new Point[n], *slice = new Point[1000];
+    Point::genPointsParallel(one, n, -5, 5, 42, 1);
+    Point::genPointsParallel(four, n, -5, 5, 42, 4);
+    Point::genPoints(slice, 123456, 124456, -5, 5, 42);
+    PointCloud cloud;
+    cloud.genPoints((int)n, -5, 5, 42, 3);
+    int differ = 0, outside = 0;
+    for (long i = 0; i < n; i++) {
+        Point p = Point::genPoint(i, -5, 5, 42);
+        differ += memcmp(&one[i], &p, sizeof(Point)) != 0 || memcmp(&four[i], &p, sizeof(Point)) != 0;
+        differ += cloud.x()[i] != p.getX() || cloud.y()[i] != p.getY() || cloud.z()[i] != p.getZ();
+        outside += p.getX() < -5 || p.getX() > 5 || p.getY() < -5 || p.getY() > 5 || p.getZ() < -5 || p.getZ() > 5;
+    }
+    for (long i = 0; i < 1000; i++)
+        differ += memcmp(&slice[i], &one[123456 + i], sizeof(Point)) != 0;
+    cout << n << " points, 1 / 3 / 4 threads and a range: " << differ << " differ, " << outside << " outside [-5, 5]" << endl;
+
+    SplitMix64 sequential(42);
+    bool sameStream = true;
+    for (int i = 0; i < 30; i++)
+        sameStream = sameStream && sequential.next() == SplitMix64::at(42, i);
+    cout << "SplitMix64::at follows next(): " << (sameStream ? "yes" : "no") << endl;
+    cout << "seed 42: " << Point::genPoint(0, -5, 5, 42) << " " << Point::genPoint(1, -5, 5, 42)
+         << ", seed 43: " << Point::genPoint(0, -5, 5, 43) << endl;
+    delete[] one;
+    delete[] four;
+    delete[] slice;
+}
+
+void pointDemo4(){
+    // parallelRanges: an exception of the calling thread's range reaches the caller once the others are done
+    atomic<long> done(0);
+    try {
+        parallelRanges(4000, 4, 1, [&done](long begin, long end) {
+            if (begin == 0)
+                throw runtime_error("first range failed");
+            for (long i = begin; i < end; i++)
+                done++;
+        });
+    }
+    catch (runtime_error &e) {
+        cout << "Caught: " << e.what() << ", items of the other ranges done: " << done << endl;
+    }
+}
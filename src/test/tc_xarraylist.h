@@ -1,7 +1,13 @@
 #include <iostream>
 #include <iomanip>
 #include "list/XArrayList.h"
+#include "list/SmallArrayList.h"
+#include "list/SortedArrayList.h"
+#include <vector>
+#include <algorithm>
+#include <numeric>
 #include "util/Point.h"
+#include "test/alloc_budget.h"
 using namespace std;
 
 void xlistDemo1(){
@@ -70,3 +76,351 @@ void xlistDemo4(){
     
     delete p1; delete p2;
 }
+
+void xlistDemo5(){
+    XArrayList<int> *pList = nullptr;
+    checkAllocations("new XArrayList (object and array)", 2, [&]() { pList = new XArrayList<int>(); });
+    XArrayList<int> &list = *pList;
+    checkAllocations("add within capacity", 0, [&]() {
+        for(int i = 0; i < 10; i++)
+            list.add(i);
+    });
+    checkAllocations("add 1000 (growing)", 8, [&]() {
+        for(int i = 0; i < 1000; i++)
+            list.add(i);
+    });
+    checkAllocations("get / indexOf / contains", 0, [&]() {
+        list.get(500);
+        list.indexOf(999);
+        list.contains(3);
+    });
+    checkAllocations("removeAt", 0, [&]() { list.removeAt(3); });
+    checkAllocations("copy constructor", 1, [&]() { XArrayList<int> copy(list); });
+    delete pList;
+}
+
+void xlistDemo6(){
+    static_assert(is_same<iterator_traits<XArrayList<int>::Iterator>::iterator_category,
+                          random_access_iterator_tag>::value, "random access");
+    XArrayList<int> list;
+    int values[] = {42, 7, 19, 3, 25, 11, 7};
+    for(int i = 0; i < 7; i++)
+        list.add(values[i]);
+
+    sort(list.begin(), list.end());
+    list.println();
+    XArrayList<int>::Iterator it = lower_bound(list.begin(), list.end(), 19);
+    cout << "lower_bound(19) at: " << (it - list.begin()) << ", value: " << *it << endl;
+    cout << "binary_search(20): " << binary_search(list.begin(), list.end(), 20) << endl;
+
+    const XArrayList<int> &view = list;
+    long sumOfSquares = transform_reduce(view.begin(), view.end(), 0L, plus<long>(),
+                                         [](int x) { return (long)x * x; });
+    cout << "sum of squares: " << sumOfSquares << ", max: " << *max_element(view.cbegin(), view.cend()) << endl;
+
+    reverse(list.begin(), list.end());
+    list.println();
+    cout << "last: " << list.end()[-1] << ", count of 7: " << count(list.begin(), list.end(), 7) << endl;
+}
+
+void xlistDemo7(){
+    // SmallArrayList: inline up to N items, then a heap array
+    SmallArrayList<string, 3> list;
+    checkAllocations("SmallArrayList: 3 adds inline", 0, [&]() {
+        list.add("b");
+        list.add("d");
+        list.add(0, "a");
+    });
+    cout << list.toString() << ", inline: " << list.isInline() << ", capacity: " << list.getCapacity() << endl;
+    list.add(2, "c");
+    list.add("e");
+    cout << list.toString() << ", inline: " << list.isInline() << ", capacity: " << list.getCapacity() << endl;
+
+    SmallArrayList<string, 3> copy(list);
+    cout << "removeAt(1): " << copy.removeAt(1) << ", removeItem(e): " << copy.removeItem("e")
+         << ", indexOf(d): " << copy.indexOf("d") << ", copy: " << copy.toString()
+         << ", original: " << list.toString() << endl;
+
+    SmallArrayList<string, 3> small;
+    small.add("x");
+    copy = small;
+    cout << "assigned a short list: " << copy.toString() << ", inline: " << copy.isInline() << endl;
+    list.clear();
+    cout << "after clear: " << list.toString() << ", inline: " << list.isInline() << ", empty: " << list.empty() << endl;
+    try {
+        small.get(1);
+    } catch (const out_of_range &e) {
+        cout << "get(1) on 1 item: " << e.what() << endl;
+    }
+
+    // emptied inline slots do not keep their items alive
+    string longName(100, 'z');
+    small.add(longName);
+    small.add(longName);
+    small.removeAt(0);
+    bool slotReset = small.begin()[small.size()].empty(); // the slot the last item moved out of
+    small.clear();
+    cout << "after removeAt / clear, the inline slots are reset: "
+         << (slotReset && small.begin()[0].empty() ? "yes" : "no") << endl;
+}
+
+void xlistDemo8(){
+    // SortedArrayList against a sorted std::vector, with duplicates
+    SortedArrayList<int> list;
+    vector<int> reference;
+    unsigned long state = 7;
+    for(int i = 0; i < 2000; i++){
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        int value = (int)((state >> 33) % 500);
+        list.add(value);
+        reference.insert(upper_bound(reference.begin(), reference.end(), value), value);
+    }
+    int batch[] = {900, -5, 250, 250, 3};
+    list.addAll(batch, batch + 5);
+    for(int i = 0; i < 5; i++)
+        reference.insert(upper_bound(reference.begin(), reference.end(), batch[i]), batch[i]);
+    int wrong = !equal(list.begin(), list.end(), reference.begin(), reference.end());
+    for(int value = -10; value < 910; value++){
+        int lower = (int)(lower_bound(reference.begin(), reference.end(), value) - reference.begin());
+        int upper = (int)(upper_bound(reference.begin(), reference.end(), value) - reference.begin());
+        wrong += list.lowerBound(value) != lower || list.upperBound(value) != upper;
+        wrong += list.indexOf(value) != (lower < upper ? lower : -1);
+        wrong += list.countRange(value, value + 20) != (int)(upper_bound(reference.begin(), reference.end(), value + 20) - reference.begin()) - lower;
+    }
+    cout << "sorted list of " << list.size() << " ints: " << wrong << " wrong against std::vector" << endl;
+
+    SortedArrayList<string> skus;
+    string codes[] = {"SKU-17", "SKU-03", "SKU-42", "SKU-08"};
+    for(int i = 0; i < 4; i++)
+        skus.add(codes[i]);
+    string more[] = {"SKU-11", "SKU-99", "SKU-01"};
+    skus.addAll(more, more + 3);
+    cout << skus.toString() << ", contains SKU-42: " << skus.contains("SKU-42") << ", indexOf SKU-05: "
+         << skus.indexOf("SKU-05") << ", range SKU-05..SKU-20: " << skus.range("SKU-05", "SKU-20").toString() << endl;
+    skus.removeItem("SKU-11");
+    skus.add(1, "SKU-02");
+    try {
+        skus.add(0, "SKU-50");
+    } catch (const invalid_argument &e) {
+        cout << "add(0, SKU-50): " << e.what() << endl;
+    }
+    cout << skus.toString() << endl;
+
+    SortedArrayList<int, greater<int>> descending;
+    for(int i = 0; i < 6; i++)
+        descending.add(i * 3 % 7);
+    cout << "descending: " << descending.toString() << ", indexOf(4): " << descending.indexOf(4) << endl;
+}
+
+template <class T>
+int xlistCheckSearch(XArrayList<T> &list, T value){
+    // indexOf / countOf / indexOfAll against a plain loop; returns the number of mismatches
+    int first = -1, matches = 0, wrong = 0;
+    XArrayList<int> all = list.indexOfAll(value);
+    for(int i = 0; i < list.size(); i++){
+        if(list.get(i) == value){
+            if(first == -1)
+                first = i;
+            wrong += matches >= all.size() || all.get(matches) != i;
+            matches++;
+        }
+    }
+    return wrong + (list.indexOf(value) != first) + (list.countOf(value) != matches) + (all.size() != matches);
+}
+
+bool xlistSameLastDigit(int &lhs, int &rhs){
+    return lhs % 10 == rhs % 10;
+}
+
+void xlistDemo9(){
+    // indexOf / countOf / indexOfAll of every length up to 100, then edge values
+    int wrong = 0;
+    unsigned long state = 11;
+    for(int n = 0; n <= 100; n++){
+        XArrayList<int> ints;
+        XArrayList<float> floats;
+        XArrayList<double> doubles;
+        for(int i = 0; i < n; i++){
+            state = state * 6364136223846793005UL + 1442695040888963407UL;
+            int value = (int)((state >> 33) % 40);
+            ints.add(value);
+            floats.add(value * 0.5f);
+            doubles.add(value * 0.25);
+        }
+        for(int value = 0; value < 40; value += 3){
+            wrong += xlistCheckSearch(ints, value);
+            wrong += xlistCheckSearch(floats, value * 0.5f);
+            wrong += xlistCheckSearch(doubles, value * 0.25);
+        }
+    }
+    cout << "lengths 0 to 100: " << wrong << " wrong" << endl;
+
+    XArrayList<float> special;
+    float values[] = {1.0f, NAN, -0.0f, 2.0f, 0.0f, NAN, 1.0f};
+    for(int i = 0; i < 7; i++)
+        special.add(values[i]);
+    cout << "indexOf(NaN): " << special.indexOf(NAN) << ", indexOf(0.0): " << special.indexOf(0.0f)
+         << ", countOf(0.0): " << special.countOf(0.0f) << ", indexOfAll(1.0): " << special.indexOfAll(1.0f).toString() << endl;
+
+    XArrayList<int> digits(0, &xlistSameLastDigit);
+    for(int i = 0; i < 40; i++)
+        digits.add(i * 7);
+    cout << "with itemEqual (same last digit as 3): indexOf " << digits.indexOf(3) << ", countOf " << digits.countOf(3)
+         << ", indexOfAll " << digits.indexOfAll(3).toString() << endl;
+}
+
+struct CountedItem{
+    static int destroyed;
+    int id;
+    CountedItem(int id = 0) : id(id) {}
+    ~CountedItem(){ destroyed++; }
+};
+int CountedItem::destroyed = 0;
+
+void xlistDeleteItem(CountedItem *item){
+    delete item;
+}
+
+void xlistDemo10(){
+    // Equal and Deleter policies instead of function pointers
+    XArrayList<int, OperatorEqual<int>, NoDelete> ids;
+    for(int i = 0; i < 20; i++)
+        ids.add(i * i);
+    cout << "OperatorEqual: indexOf(49) " << ids.indexOf(49) << ", contains(50) " << ids.contains(50)
+         << ", countOf(0) " << ids.countOf(0) << endl;
+
+    Point *points = Point::genPoints(5, 0, 10, true, 2);
+    {
+        XArrayList<Point*, PointPtrEqual, DeleteItems> owned;
+        for(int i = 0; i < 5; i++)
+            owned.add(new Point(points[i]));
+        Point *probe = &points[3];
+        cout << "PointPtrEqual: indexOf(points[3]) " << owned.indexOf(probe) << endl;
+        XArrayList<Point*> hooks(&XArrayList<Point*>::free, &Point::pointEQ);
+        for(int i = 0; i < 5; i++)
+            hooks.add(new Point(points[i]));
+        cout << "function pointers: indexOf(points[3]) " << hooks.indexOf(probe) << endl;
+    } // both delete their points
+    delete[] points;
+
+    CountedItem::destroyed = 0;
+    {
+        XArrayList<CountedItem*, OperatorEqual<CountedItem*>, DeleteItems> items;
+        for(int i = 0; i < 4; i++)
+            items.add(new CountedItem(i));
+    }
+    cout << "DeleteItems destroyed " << CountedItem::destroyed << " of 4 items" << endl;
+}
+
+bool xlistIsOdd(int &item){
+    return item % 2 != 0;
+}
+
+int xlistDivisor = 2;
+bool xlistIsMultiple(int &item){
+    return item % xlistDivisor == 0;
+}
+
+template<class L>
+int xlistCheckBulk(L &list, vector<int> &expected){
+    // list against std::vector after the same operations; returns the number of mismatches
+    int wrong = list.size() != (int)expected.size();
+    for(int i = 0; i < list.size() && i < (int)expected.size(); i++)
+        wrong += list.get(i) != expected[i];
+    return wrong;
+}
+
+void xlistDemo11(){
+    // bulk operations: addAll, insertRange, removeRange, removeIf
+    XArrayList<int> list(0, 0, 2);
+    int items[] = {10, 11, 12, 13, 14};
+    list.addAll(items, 5);
+    vector<int> batch = {100, 101, 102};
+    list.insertRange(2, batch.begin(), batch.end());
+    cout << "addAll + insertRange(2): " << list.toString() << endl;
+    list.removeRange(1, 4);
+    cout << "removeRange(1, 4): " << list.toString() << endl;
+    int removed = list.removeIf(xlistIsOdd);
+    cout << "removeIf(odd) removed " << removed << ": " << list.toString() << endl;
+    removed = list.removeIf([](int &item){ return item > 12; });
+    cout << "removeIf(> 12) removed " << removed << ": " << list.toString() << endl;
+    try{
+        list.removeRange(1, 5);
+    }
+    catch(out_of_range &e){
+        cout << "removeRange(1, 5): " << e.what() << endl;
+    }
+
+    // random operations against std::vector, through XArrayList and through the IList defaults
+    XArrayList<int> xlist(0, 0, 1);
+    SmallArrayList<int, 4> small;
+    IList<int> *pSmall = &small;
+    vector<int> expected;
+    unsigned long state = 7;
+    int wrong = 0;
+    for(int step = 0; step < 300; step++){
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        int r = (int)(state >> 33);
+        int n = (int)expected.size();
+        int k = r % 7; // 0 to 6 items
+        int values[6];
+        for(int i = 0; i < k; i++)
+            values[i] = (r >> 3) % 100 + i;
+        switch((r >> 10) % 4){
+        case 0: {
+            int index = n == 0 ? 0 : (r >> 12) % (n + 1);
+            xlist.insertRange(index, values, k);
+            pSmall->insertRange(index, values, k);
+            expected.insert(expected.begin() + index, values, values + k);
+            break;
+        }
+        case 1:
+            xlist.addAll(values, k);
+            pSmall->addAll(values, k);
+            expected.insert(expected.end(), values, values + k);
+            break;
+        case 2: {
+            int from = n == 0 ? 0 : (r >> 12) % (n + 1);
+            int to = from + (n - from == 0 ? 0 : (r >> 20) % (n - from + 1));
+            xlist.removeRange(from, to);
+            pSmall->removeRange(from, to);
+            expected.erase(expected.begin() + from, expected.begin() + to);
+            break;
+        }
+        default: {
+            xlistDivisor = 2 + r % 5;
+            int before = (int)expected.size();
+            expected.erase(remove_if(expected.begin(), expected.end(), xlistIsMultiple), expected.end());
+            wrong += xlist.removeIf([](int &item){ return item % xlistDivisor == 0; }) != before - (int)expected.size();
+            wrong += pSmall->removeIf(xlistIsMultiple) != before - (int)expected.size();
+        }
+        }
+        wrong += xlistCheckBulk(xlist, expected) + xlistCheckBulk(small, expected);
+    }
+    cout << "300 random bulk operations: " << wrong << " wrong, " << expected.size() << " items left" << endl;
+
+    // owning lists: the removed items go to removeItemData, and the emptied slots are reset
+    CountedItem::destroyed = 0;
+    {
+        XArrayList<CountedItem*, OperatorEqual<CountedItem*>, DeleteItems> items;
+        for(int i = 0; i < 6; i++)
+            items.add(new CountedItem(i));
+        items.removeRange(1, 3, xlistDeleteItem);
+        int byRange = CountedItem::destroyed;
+        bool reset = items.begin()[items.size()] == nullptr && items.begin()[items.size() + 1] == nullptr;
+        items.removeIf([](CountedItem *&item){ return item->id % 2 == 1; }, xlistDeleteItem);
+        reset = reset && items.begin()[items.size()] == nullptr && items.begin()[items.size() + 1] == nullptr;
+        cout << "owning list: removeRange deleted " << byRange << ", removeIf deleted "
+             << CountedItem::destroyed - byRange << ", " << items.size() << " left, emptied slots reset: "
+             << (reset ? "yes" : "no") << endl;
+
+        SmallArrayList<CountedItem*, 4> small; // through the IList defaults
+        for(int i = 0; i < 3; i++)
+            small.add(new CountedItem(i));
+        IList<CountedItem*> *pList = &small;
+        pList->removeRange(0, 1, xlistDeleteItem);
+        pList->removeIf([](CountedItem *&){ return true; }, xlistDeleteItem);
+        cout << "IList defaults: " << small.size() << " left" << endl;
+    }
+    cout << "destroyed " << CountedItem::destroyed << " of 9 items" << endl;
+}